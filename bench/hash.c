@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// Microbenchmarks for the hash table under the workloads the toolkit actually produces. Each
+// workload reports time per operation, how far elements ended up from their home groups, and how
+// much memory the table requested from the instance allocator.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <autk/autk.h>
+#include <utility/hash.h>
+
+#define KEY_COUNT 4096
+#define ROUNDS 256
+#define RESOURCE_ID_BASE 0x2A00000u // resembles the IDs an X server hands out
+#define CHURN_LIVE_COUNT 256
+#define CHURN_OP_COUNT (1 << 20)
+#define HIGH_LOAD_BUCKET_COUNT 16384
+#define SPARSE_PEAK_COUNT 65536
+#define SPARSE_LIVE_COUNT 64
+#define MAX_PROBE_LENGTH 8 // longer probes share the last histogram bucket
+
+typedef struct generic_entry {
+    uint32_t key;
+    void *value;
+} generic_entry_t;
+
+typedef struct alloc_stats {
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t total_bytes;
+    size_t alloc_count;
+} alloc_stats_t;
+
+AUTK_DEFINE_HASH_TABLE(typed_table, uint32_t, void *, autk_hash_uint32, autk_hash_uint32_eq)
+
+static alloc_stats_t alloc_stats;
+static volatile uintptr_t sink; // keeps results from being optimized out
+
+//==============================================================================
+//
+// Instrumentation
+//
+//==============================================================================
+
+// Counts the bytes that hash tables request from the instance. Other allocations are passed through
+// without being counted.
+static void *
+counting_alloc(void *ctx, void *block, size_t old_size, size_t new_size, autk_memory_tag_t tag)
+{
+    void *new_block = autk_default_alloc(ctx, block, old_size, new_size, tag);
+
+    if (tag == AUTK_MEMORY_TAG_HASH && (new_block || new_size == 0)) {
+        alloc_stats.current_bytes -= old_size;
+        alloc_stats.current_bytes += new_size;
+        if (alloc_stats.current_bytes > alloc_stats.peak_bytes) {
+            alloc_stats.peak_bytes = alloc_stats.current_bytes;
+        }
+        if (new_size > old_size) {
+            alloc_stats.total_bytes += new_size - old_size;
+            alloc_stats.alloc_count++;
+        }
+    }
+
+    return new_block;
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void
+check(autk_status_t status)
+{
+    if (status != AUTK_OK) {
+        fprintf(stderr, "error: %s\n", autk_status_to_string(status));
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void
+begin_workload(const char *name)
+{
+    printf("\n== %s\n", name);
+    alloc_stats = (alloc_stats_t){0};
+}
+
+static void
+report_time(const char *op, double start, size_t op_count)
+{
+    printf("  %-16s %8.2f ns/op\n", op, (now_ns() - start) / (double)op_count);
+}
+
+// Prints how many groups past its home group each element in the current buffer landed.
+static void
+report_probe_lengths(const autk_hash_table_t *ht)
+{
+    const autk_hash_buffer_t *buf = &ht->buf;
+    size_t histogram[MAX_PROBE_LENGTH + 1] = {0};
+    size_t live_count = 0;
+    size_t group, target_group, miss;
+    const void *element;
+
+    for (size_t i = 0; i < buf->bucket_count; i++) {
+        if (buf->ctrl[i] & AUTK_HASH_CTRL_FREE_BIT) {
+            continue;
+        }
+
+        element = buf->elements + i * ht->element_stride;
+        group = autk_hash_home_group(buf, autk_hash_mix(ht->hash_func(element)));
+        target_group = i / AUTK_HASH_GROUP_SIZE;
+        for (miss = 0; group != target_group; miss++) {
+            group = autk_hash_next_group(buf, group, miss);
+        }
+        histogram[miss < MAX_PROBE_LENGTH ? miss : MAX_PROBE_LENGTH]++;
+        live_count++;
+    }
+
+    printf("  buckets %zu, live %zu, tombstones %zu, worst miss %zu\n", buf->bucket_count,
+           live_count, buf->tombstone_count, buf->worst_miss);
+    printf("  probe groups:");
+    for (size_t i = 0; i <= MAX_PROBE_LENGTH; i++) {
+        if (histogram[i]) {
+            printf(" %zu%s=%zu", i, i == MAX_PROBE_LENGTH ? "+" : "", histogram[i]);
+        }
+    }
+    printf("\n");
+}
+
+static void
+report_memory(void)
+{
+    printf("  memory: %zu bytes now, %zu peak, %zu allocated over %zu allocations\n",
+           alloc_stats.current_bytes, alloc_stats.peak_bytes, alloc_stats.total_bytes,
+           alloc_stats.alloc_count);
+}
+
+//==============================================================================
+//
+// Workloads
+//
+//==============================================================================
+
+static void
+insert_key(autk_hash_table_t *ht, uint32_t key)
+{
+    generic_entry_t entry = {key, (void *)(uintptr_t)key};
+
+    check(autk_hash_table_insert(ht, &entry, NULL, NULL));
+}
+
+// Dense resource IDs through the generic table, as the X11 window map used to see them.
+static void
+bench_dense_generic(autk_instance_t *instance)
+{
+    autk_hash_table_t ht;
+    autk_hash_iter_t iter;
+    uint32_t key;
+    double start;
+    uintptr_t sum = 0;
+
+    begin_workload("dense IDs, generic table");
+    autk_hash_table_init(instance, &ht, sizeof(generic_entry_t), autk_hash_uint32,
+                         autk_hash_uint32_eq);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < KEY_COUNT; i++) {
+        insert_key(&ht, RESOURCE_ID_BASE + i);
+    }
+    report_time("insert", start, KEY_COUNT);
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        for (uint32_t i = 0; i < KEY_COUNT; i++) {
+            key = RESOURCE_ID_BASE + i;
+            if (autk_hash_table_find(&ht, &key, &iter)) {
+                sum += (uintptr_t)((generic_entry_t *)autk_hash_table_get(&ht, iter))->value;
+            }
+        }
+    }
+    report_time("find (hit)", start, (size_t)KEY_COUNT * ROUNDS);
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        for (uint32_t i = 0; i < KEY_COUNT; i++) {
+            key = RESOURCE_ID_BASE + KEY_COUNT + i;
+            sum += autk_hash_table_find(&ht, &key, &iter);
+        }
+    }
+    report_time("find (miss)", start, (size_t)KEY_COUNT * ROUNDS);
+    report_probe_lengths(&ht);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < KEY_COUNT; i++) {
+        key = RESOURCE_ID_BASE + i;
+        sum += autk_hash_table_remove(&ht, &key) != NULL;
+    }
+    report_time("remove", start, KEY_COUNT);
+
+    autk_hash_table_fini(&ht);
+    report_memory();
+    sink = sum;
+}
+
+// The same workload through a table generated by `AUTK_DEFINE_HASH_TABLE`.
+static void
+bench_dense_typed(autk_instance_t *instance)
+{
+    typed_table_t map;
+    void **value;
+    void *removed;
+    double start;
+    uintptr_t sum = 0;
+
+    begin_workload("dense IDs, typed table");
+    typed_table_init(instance, &map);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < KEY_COUNT; i++) {
+        check(typed_table_insert(&map, RESOURCE_ID_BASE + i, (void *)(uintptr_t)(i + 1), NULL,
+                                 NULL));
+    }
+    report_time("insert", start, KEY_COUNT);
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        for (uint32_t i = 0; i < KEY_COUNT; i++) {
+            value = typed_table_find(&map, RESOURCE_ID_BASE + i);
+            if (value) {
+                sum += (uintptr_t)*value;
+            }
+        }
+    }
+    report_time("find (hit)", start, (size_t)KEY_COUNT * ROUNDS);
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        for (uint32_t i = 0; i < KEY_COUNT; i++) {
+            sum += typed_table_find(&map, RESOURCE_ID_BASE + KEY_COUNT + i) != NULL;
+        }
+    }
+    report_time("find (miss)", start, (size_t)KEY_COUNT * ROUNDS);
+    report_probe_lengths(&map.ht);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < KEY_COUNT; i++) {
+        sum += typed_table_remove(&map, RESOURCE_ID_BASE + i, &removed);
+    }
+    report_time("remove", start, KEY_COUNT);
+
+    typed_table_fini(&map);
+    report_memory();
+    sink = sum;
+}
+
+// A sliding window of live IDs, like windows being opened and closed for a long time. Each step
+// removes the oldest ID and inserts a fresh one.
+static void
+bench_churn(autk_instance_t *instance)
+{
+    autk_hash_table_t ht;
+    uint32_t key;
+    double start;
+    uintptr_t sum = 0;
+
+    begin_workload("insert/remove churn");
+    autk_hash_table_init(instance, &ht, sizeof(generic_entry_t), autk_hash_uint32,
+                         autk_hash_uint32_eq);
+
+    for (uint32_t i = 0; i < CHURN_LIVE_COUNT; i++) {
+        insert_key(&ht, RESOURCE_ID_BASE + i);
+    }
+
+    start = now_ns();
+    for (uint32_t i = 0; i < CHURN_OP_COUNT; i++) {
+        key = RESOURCE_ID_BASE + i;
+        sum += autk_hash_table_remove(&ht, &key) != NULL;
+        insert_key(&ht, RESOURCE_ID_BASE + CHURN_LIVE_COUNT + i);
+    }
+    report_time("remove+insert", start, CHURN_OP_COUNT);
+    report_probe_lengths(&ht);
+
+    autk_hash_table_fini(&ht);
+    report_memory();
+    sink = sum;
+}
+
+// Fills the table right up to its maximum load factor and measures lookups there.
+static void
+bench_high_load(autk_instance_t *instance)
+{
+    autk_hash_table_t ht;
+    autk_hash_iter_t iter;
+    uint32_t count = HIGH_LOAD_BUCKET_COUNT / 4 * 3;
+    uint32_t key;
+    double start;
+    uintptr_t sum = 0;
+
+    begin_workload("high load factor");
+    autk_hash_table_init(instance, &ht, sizeof(generic_entry_t), autk_hash_uint32,
+                         autk_hash_uint32_eq);
+    check(autk_hash_table_reserve(&ht, count));
+
+    start = now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+        insert_key(&ht, RESOURCE_ID_BASE + i * 7);
+    }
+    report_time("insert", start, count);
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS / 16; round++) {
+        for (uint32_t i = 0; i < count; i++) {
+            key = RESOURCE_ID_BASE + i * 7;
+            sum += autk_hash_table_find(&ht, &key, &iter);
+        }
+    }
+    report_time("find (hit)", start, (size_t)count * (ROUNDS / 16));
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS / 16; round++) {
+        for (uint32_t i = 0; i < count; i++) {
+            key = RESOURCE_ID_BASE + i * 7 + 1;
+            sum += autk_hash_table_find(&ht, &key, &iter);
+        }
+    }
+    report_time("find (miss)", start, (size_t)count * (ROUNDS / 16));
+    report_probe_lengths(&ht);
+
+    autk_hash_table_fini(&ht);
+    report_memory();
+    sink = sum;
+}
+
+// Iterates over a table that once held many elements but now holds only a few, which is what the
+// X11 client does every time it looks for dirty windows after a burst of windows has closed.
+static void
+bench_sparse_iteration(autk_instance_t *instance)
+{
+    autk_hash_table_t ht;
+    autk_hash_iter_t iter;
+    uint32_t key;
+    double start;
+    size_t visited = 0;
+
+    begin_workload("sparse iteration");
+    autk_hash_table_init(instance, &ht, sizeof(generic_entry_t), autk_hash_uint32,
+                         autk_hash_uint32_eq);
+
+    for (uint32_t i = 0; i < SPARSE_PEAK_COUNT; i++) {
+        insert_key(&ht, RESOURCE_ID_BASE + i);
+    }
+    for (uint32_t i = SPARSE_LIVE_COUNT; i < SPARSE_PEAK_COUNT; i++) {
+        key = RESOURCE_ID_BASE + i;
+        autk_hash_table_remove(&ht, &key);
+    }
+
+    start = now_ns();
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        if (autk_hash_table_begin(&ht, &iter)) {
+            do {
+                visited++;
+            } while (autk_hash_table_next(&ht, &iter));
+        }
+    }
+    report_time("iterate", start, ROUNDS);
+    report_time("per element", start, visited);
+    report_probe_lengths(&ht);
+
+    autk_hash_table_fini(&ht);
+    report_memory();
+    sink = visited;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const autk_instance_create_params_t instance_params = {
+        .struct_size = sizeof(autk_instance_create_params_t),
+        .alloc_func = &counting_alloc,
+        .message_func = &autk_stderr_message,
+    };
+    static const struct {
+        const char *name;
+        void (*func)(autk_instance_t *instance);
+    } workloads[] = {
+        {"dense-generic", bench_dense_generic},
+        {"dense-typed", bench_dense_typed},
+        {"churn", bench_churn},
+        {"high-load", bench_high_load},
+        {"sparse-iteration", bench_sparse_iteration},
+    };
+    autk_instance_t *instance;
+    bool found = argc < 2;
+
+    check(autk_instance_create(&instance_params, &instance));
+
+    // Run all workloads, or only the ones named on the command line.
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        for (int j = 1; j < argc; j++) {
+            if (strcmp(argv[j], workloads[i].name) == 0) {
+                found = true;
+                workloads[i].func(instance);
+            }
+        }
+        if (argc < 2) {
+            workloads[i].func(instance);
+        }
+    }
+
+    autk_instance_destroy(instance);
+
+    if (!found) {
+        fprintf(stderr, "usage: %s [workload...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
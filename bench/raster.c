@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// Microbenchmarks for the software rasterizer's span kernels. Each workload runs every kernel set
+// the CPU supports over the same pixels, and reports throughput in millions of pixels per second.
+// The tiled workload instead draws whole 4K frames through the tiler with the runtime-selected
+// kernels, once per drawing thread count, to show how drawing scales across cores.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <autk/autk.h>
+#include <core/tiler.h>
+#include <device/raster/kernels.h>
+#include <os/thread.h>
+#include <utility/thread_pool.h>
+
+#define FRAME_WIDTH 1920
+#define FRAME_HEIGHT 1080
+#define FRAME_COUNT 64
+#define SMALL_RECT_WIDTH 48 // about the size of a button
+#define SMALL_RECT_HEIGHT 16
+#define SMALL_RECT_COUNT (1 << 16)
+#define TILED_FRAME_WIDTH 3840
+#define TILED_FRAME_HEIGHT 2160
+#define TILED_FRAME_COUNT 32
+#define TILED_RECTS_PER_FRAME 2048
+#define BUFFER_PIXEL_COUNT ((size_t)TILED_FRAME_WIDTH * TILED_FRAME_HEIGHT) // enough for any frame
+
+typedef void (*workload_func_t)(const autk_raster_kernels_t *kernels);
+
+static const uint32_t thread_counts[] = {1, 2, 4, 8}; // the calling thread plus pool workers
+
+static const autk_raster_kernels_t *const kernel_sets[] = {
+    &autk_raster_kernels_scalar,
+#if AUTK_RASTER_SSE2
+    &autk_raster_kernels_sse2,
+#endif
+#if AUTK_RASTER_AVX2
+    &autk_raster_kernels_avx2,
+#endif
+};
+
+static uint32_t *dst_pixels; // BUFFER_PIXEL_COUNT
+static uint32_t *src_pixels; // BUFFER_PIXEL_COUNT
+static uint64_t rng_state;
+static volatile uint32_t sink; // keeps results from being optimized out
+
+//==============================================================================
+//
+// Instrumentation
+//
+//==============================================================================
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t
+next_random(void)
+{
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1Du) >> 32);
+}
+
+// Returns a random premultiplied pixel with the given alpha.
+static uint32_t
+random_pixel(uint32_t alpha)
+{
+    uint32_t pixel = alpha << 24;
+
+    for (unsigned shift = 0; shift < 24; shift += 8) {
+        pixel |= (next_random() % (alpha + 1)) << shift;
+    }
+    return pixel;
+}
+
+// Runs a workload with every supported kernel set, starting each from the same pixels.
+static void
+run_workload(const char *name, workload_func_t func, uint64_t pixel_count)
+{
+    double start;
+    double elapsed;
+
+    printf("\n== %s\n", name);
+
+    for (size_t i = 0; i < AUTK_LENGTHOF(kernel_sets); i++) {
+        if (kernel_sets[i]->is_supported && !kernel_sets[i]->is_supported()) {
+            printf("  %-8s unsupported by this CPU\n", kernel_sets[i]->name);
+            continue;
+        }
+
+        rng_state = 0x9E3779B97F4A7C15u; // same inputs on every run
+        for (size_t j = 0; j < (size_t)FRAME_WIDTH * FRAME_HEIGHT; j++) {
+            dst_pixels[j] = random_pixel(255);
+        }
+
+        start = now_ns();
+        func(kernel_sets[i]);
+        elapsed = now_ns() - start;
+        printf("  %-8s %9.1f Mpix/s\n", kernel_sets[i]->name,
+               (double)pixel_count / elapsed * 1e3);
+        sink += dst_pixels[next_random() % ((size_t)FRAME_WIDTH * FRAME_HEIGHT)];
+    }
+}
+
+//==============================================================================
+//
+// Workloads
+//
+//==============================================================================
+
+// Clears whole frames, as when repainting a window's background.
+static void
+bench_fill(const autk_raster_kernels_t *kernels)
+{
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        for (uint32_t y = 0; y < FRAME_HEIGHT; y++) {
+            kernels->fill(dst_pixels + (size_t)y * FRAME_WIDTH, FRAME_WIDTH, 0xFFC0C0C0 + frame);
+        }
+    }
+}
+
+// Fills button-sized rectangles at arbitrary positions, where per-span overhead and unaligned
+// edges dominate.
+static void
+bench_fill_small(const autk_raster_kernels_t *kernels)
+{
+    for (uint32_t i = 0; i < SMALL_RECT_COUNT; i++) {
+        uint32_t x = next_random() % (FRAME_WIDTH - SMALL_RECT_WIDTH);
+        uint32_t y = next_random() % (FRAME_HEIGHT - SMALL_RECT_HEIGHT);
+
+        for (uint32_t row = 0; row < SMALL_RECT_HEIGHT; row++) {
+            kernels->fill(dst_pixels + (size_t)(y + row) * FRAME_WIDTH + x, SMALL_RECT_WIDTH,
+                          0xFF808080);
+        }
+    }
+}
+
+// Composites a translucent color over whole frames, as for a selection highlight.
+static void
+bench_blend_solid(const autk_raster_kernels_t *kernels)
+{
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        for (uint32_t y = 0; y < FRAME_HEIGHT; y++) {
+            kernels->blend_solid(dst_pixels + (size_t)y * FRAME_WIDTH, FRAME_WIDTH, 0x80004080);
+        }
+    }
+}
+
+// Composites an image over whole frames, given source pixels already prepared by the caller.
+static void
+bench_blend(const autk_raster_kernels_t *kernels)
+{
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        for (uint32_t y = 0; y < FRAME_HEIGHT; y++) {
+            kernels->blend(dst_pixels + (size_t)y * FRAME_WIDTH,
+                           src_pixels + (size_t)y * FRAME_WIDTH, FRAME_WIDTH);
+        }
+    }
+}
+
+//==============================================================================
+//
+// Tiled frames
+//
+//==============================================================================
+
+// Draws frames of a background, button-sized translucent rectangles, and an image over the top,
+// the way a window is redrawn. Only the pool's size changes between runs.
+static double
+draw_tiled_frames(autk_tiler_t *tiler, autk_surface_t *frame, autk_surface_t *image)
+{
+    double start = now_ns();
+
+    for (uint32_t i = 0; i < TILED_FRAME_COUNT; i++) {
+        autk_tile_command_t command = {
+            .bbox = {0, 0, TILED_FRAME_WIDTH, TILED_FRAME_HEIGHT},
+            .pixel = 0xFFC0C0C0 + i,
+            .op = AUTK_TILE_OP_FILL,
+        };
+
+        autk_tiler_begin(tiler, frame, NULL, 0);
+        autk_tiler_record(tiler, &command);
+
+        for (uint32_t j = 0; j < TILED_RECTS_PER_FRAME; j++) {
+            int32_t x = (int32_t)(next_random() % (TILED_FRAME_WIDTH - SMALL_RECT_WIDTH));
+            int32_t y = (int32_t)(next_random() % (TILED_FRAME_HEIGHT - SMALL_RECT_HEIGHT));
+
+            command = (autk_tile_command_t){
+                .bbox = {x, y, x + SMALL_RECT_WIDTH, y + SMALL_RECT_HEIGHT},
+                .pixel = 0x80004080,
+                .op = AUTK_TILE_OP_BLEND,
+            };
+            autk_tiler_record(tiler, &command);
+        }
+
+        command = (autk_tile_command_t){
+            .bbox = {0, 0, TILED_FRAME_WIDTH, TILED_FRAME_HEIGHT},
+            .src = image,
+            .op = AUTK_TILE_OP_BLEND_IMAGE,
+        };
+        autk_tiler_record(tiler, &command);
+        autk_tiler_end(tiler);
+    }
+
+    return now_ns() - start;
+}
+
+// Draws the same frames with each number of threads in `thread_counts`, reporting the speedup over
+// drawing on the calling thread alone. The pool is built here rather than by the instance, so
+// the tiler and the pool run the same copy of the pool's code.
+static autk_status_t
+run_tiled(const char *name)
+{
+    autk_surface_create_params_t surface_params = {
+        .struct_size = sizeof(autk_surface_create_params_t),
+        .width = TILED_FRAME_WIDTH,
+        .height = TILED_FRAME_HEIGHT,
+        .stride = TILED_FRAME_WIDTH * sizeof(uint32_t),
+    };
+    uint64_t pixel_count = (uint64_t)TILED_FRAME_COUNT
+                           * (2 * TILED_FRAME_WIDTH * TILED_FRAME_HEIGHT
+                              + TILED_RECTS_PER_FRAME * SMALL_RECT_WIDTH * SMALL_RECT_HEIGHT);
+    autk_device_t device = {.driver = &autk_device_driver_raster};
+    autk_instance_t *instance = NULL;
+    autk_surface_t *frame = NULL;
+    autk_surface_t *image = NULL;
+    autk_tiler_t tiler = {0};
+    autk_thread_pool_t *pool;
+    autk_status_t status;
+    double baseline = 0.0;
+    double elapsed;
+
+    printf("\n== %s (%s kernels, %ux%u)\n", name, autk_raster_select_kernels()->name,
+           TILED_FRAME_WIDTH, TILED_FRAME_HEIGHT);
+    printf("  CPUs available: %u\n", autk_cpu_count());
+
+    // Devices normally come from a client, but the raster driver doesn't need one.
+    AUTK_TRY(autk_instance_create(NULL, &instance));
+    device.instance = instance;
+    device.driver_data = malloc(device.driver->driver_data_size);
+    if (!device.driver_data) {
+        autk_instance_destroy(instance);
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    status = device.driver->init_from_client(&device, device.driver_data, NULL, NULL, NULL);
+    if (status == AUTK_OK) {
+        surface_params.pixels = dst_pixels;
+        status = autk_surface_create(&device, &surface_params, &frame);
+    }
+    if (status == AUTK_OK) {
+        surface_params.pixels = src_pixels;
+        status = autk_surface_create(&device, &surface_params, &image);
+    }
+    if (status == AUTK_OK) {
+        status = autk_tiler_init(&tiler, instance);
+    }
+
+    for (size_t i = 0; status == AUTK_OK && i < AUTK_LENGTHOF(thread_counts); i++) {
+        pool = NULL;
+        if (thread_counts[i] > 1) {
+            status = autk_thread_pool_create(instance, thread_counts[i] - 1, &pool);
+            if (status != AUTK_OK) {
+                break;
+            }
+        }
+
+        instance->thread_pool = pool;
+        rng_state = 0x9E3779B97F4A7C15u; // same rectangles on every run
+        elapsed = draw_tiled_frames(&tiler, frame, image);
+        instance->thread_pool = NULL;
+        autk_thread_pool_destroy(pool);
+
+        if (thread_counts[i] == 1) {
+            baseline = elapsed;
+        }
+        printf("  %u threads %9.1f Mpix/s  %5.2fx\n", thread_counts[i],
+               (double)pixel_count / elapsed * 1e3, baseline / elapsed);
+        sink += dst_pixels[next_random() % BUFFER_PIXEL_COUNT];
+    }
+
+    autk_tiler_fini(&tiler);
+    autk_surface_destroy(image);
+    autk_surface_destroy(frame);
+    free(device.driver_data);
+    autk_instance_destroy(instance);
+    return status;
+}
+
+//==============================================================================
+//
+// Source images
+//
+//==============================================================================
+
+// Every pixel translucent, like a drop shadow.
+static void
+make_translucent_image(void)
+{
+    for (size_t i = 0; i < BUFFER_PIXEL_COUNT; i++) {
+        src_pixels[i] = random_pixel(1 + next_random() % 254);
+    }
+}
+
+// Runs of opaque and clear pixels with translucent edges, like icons and glyphs.
+static void
+make_icon_image(void)
+{
+    for (size_t i = 0; i < BUFFER_PIXEL_COUNT;) {
+        size_t run = 8 + next_random() % 24;
+        uint32_t alpha = next_random() % 2 ? 255 : 0;
+
+        for (; run > 0 && i < BUFFER_PIXEL_COUNT; run--, i++) {
+            src_pixels[i] = random_pixel(run == 1 ? next_random() % 256 : alpha);
+        }
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const struct {
+        const char *name;
+        workload_func_t func;
+        void (*make_image)(void);
+        uint64_t pixel_count;
+    } workloads[] = {
+        {"fill", bench_fill, NULL, (uint64_t)FRAME_COUNT * FRAME_WIDTH * FRAME_HEIGHT},
+        {"fill-small", bench_fill_small, NULL,
+         (uint64_t)SMALL_RECT_COUNT * SMALL_RECT_WIDTH * SMALL_RECT_HEIGHT},
+        {"blend-solid", bench_blend_solid, NULL,
+         (uint64_t)FRAME_COUNT * FRAME_WIDTH * FRAME_HEIGHT},
+        {"blend-translucent", bench_blend, make_translucent_image,
+         (uint64_t)FRAME_COUNT * FRAME_WIDTH * FRAME_HEIGHT},
+        {"blend-icons", bench_blend, make_icon_image,
+         (uint64_t)FRAME_COUNT * FRAME_WIDTH * FRAME_HEIGHT},
+    };
+    autk_status_t status = AUTK_OK;
+    bool found = argc < 2;
+    bool selected;
+
+    dst_pixels = malloc(BUFFER_PIXEL_COUNT * sizeof(uint32_t));
+    src_pixels = malloc(BUFFER_PIXEL_COUNT * sizeof(uint32_t));
+    if (!dst_pixels || !src_pixels) {
+        fprintf(stderr, "error: %s\n", autk_status_to_string(AUTK_ERR_OUT_OF_MEMORY));
+        return EXIT_FAILURE;
+    }
+
+    printf("kernels selected at runtime: %s\n", autk_raster_select_kernels()->name);
+
+    // Run all workloads, or only the ones named on the command line.
+    for (size_t i = 0; i < AUTK_LENGTHOF(workloads); i++) {
+        selected = argc < 2;
+
+        for (int j = 1; j < argc; j++) {
+            if (strcmp(argv[j], workloads[i].name) == 0) {
+                selected = true;
+                found = true;
+            }
+        }
+        if (selected) {
+            rng_state = 0x2545F4914F6CDD1Du;
+            if (workloads[i].make_image) {
+                workloads[i].make_image();
+            }
+            run_workload(workloads[i].name, workloads[i].func, workloads[i].pixel_count);
+        }
+    }
+
+    // The tiled workload draws icons over the frames.
+    selected = argc < 2;
+    for (int j = 1; j < argc; j++) {
+        if (strcmp(argv[j], "tiled") == 0) {
+            selected = true;
+            found = true;
+        }
+    }
+    if (selected) {
+        rng_state = 0x2545F4914F6CDD1Du;
+        make_icon_image();
+        status = run_tiled("tiled");
+        if (status != AUTK_OK) {
+            fprintf(stderr, "error: %s\n", autk_status_to_string(status));
+        }
+    }
+
+    free(src_pixels);
+    free(dst_pixels);
+
+    if (!found) {
+        fprintf(stderr, "usage: %s [workload...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    return status == AUTK_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// Microbenchmarks for regions under the workloads the toolkit produces: accumulating damage,
+// clipping it to a window, subtracting occluding windows, and hit-testing. Each workload reports
+// time per operation, how many rectangles the result needed, and how much memory regions requested
+// from the instance allocator.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <autk/autk.h>
+#include <utility/region.h>
+
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+#define DAMAGE_RECT_COUNT 64 // rectangles added per frame
+#define FRAME_COUNT 4096
+#define WINDOW_COUNT 24
+#define HIT_TEST_COUNT (1 << 20)
+#define SMALL_OP_COUNT (1 << 20)
+
+typedef struct alloc_stats {
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t total_bytes;
+    size_t alloc_count;
+} alloc_stats_t;
+
+static alloc_stats_t alloc_stats;
+static uint64_t rng_state;
+static volatile uintptr_t sink; // keeps results from being optimized out
+
+//==============================================================================
+//
+// Instrumentation
+//
+//==============================================================================
+
+// Counts the bytes that regions request from the instance. Other allocations are passed through
+// without being counted.
+static void *
+counting_alloc(void *ctx, void *block, size_t old_size, size_t new_size, autk_memory_tag_t tag)
+{
+    void *new_block = autk_default_alloc(ctx, block, old_size, new_size, tag);
+
+    if (tag == AUTK_MEMORY_TAG_REGION && (new_block || new_size == 0)) {
+        alloc_stats.current_bytes -= old_size;
+        alloc_stats.current_bytes += new_size;
+        if (alloc_stats.current_bytes > alloc_stats.peak_bytes) {
+            alloc_stats.peak_bytes = alloc_stats.current_bytes;
+        }
+        if (new_size > old_size) {
+            alloc_stats.total_bytes += new_size - old_size;
+            alloc_stats.alloc_count++;
+        }
+    }
+
+    return new_block;
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void
+check(autk_status_t status)
+{
+    if (status != AUTK_OK) {
+        fprintf(stderr, "error: %s\n", autk_status_to_string(status));
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void
+begin_workload(const char *name)
+{
+    printf("\n== %s\n", name);
+    alloc_stats = (alloc_stats_t){0};
+    rng_state = 0x9E3779B97F4A7C15u; // same inputs on every run
+}
+
+static void
+report_time(const char *op, double start, size_t op_count)
+{
+    printf("  %-16s %8.2f ns/op\n", op, (now_ns() - start) / (double)op_count);
+}
+
+static void
+report_memory(void)
+{
+    printf("  memory: %zu bytes now, %zu peak, %zu allocated over %zu allocations\n",
+           alloc_stats.current_bytes, alloc_stats.peak_bytes, alloc_stats.total_bytes,
+           alloc_stats.alloc_count);
+}
+
+//==============================================================================
+//
+// Inputs
+//
+//==============================================================================
+
+static uint32_t
+next_random(void)
+{
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1Du) >> 32);
+}
+
+static autk_bbox_t
+random_bbox(int32_t max_width, int32_t max_height)
+{
+    int32_t x = (int32_t)(next_random() % SCREEN_WIDTH);
+    int32_t y = (int32_t)(next_random() % SCREEN_HEIGHT);
+
+    return (autk_bbox_t){
+        .x0 = x,
+        .y0 = y,
+        .x1 = x + 1 + (int32_t)(next_random() % (uint32_t)max_width),
+        .y1 = y + 1 + (int32_t)(next_random() % (uint32_t)max_height),
+    };
+}
+
+// Scattered small rectangles, like the exposures and widget updates of one frame.
+static void
+build_damage(autk_region_t *region)
+{
+    autk_region_clear(region);
+    for (uint32_t i = 0; i < DAMAGE_RECT_COUNT; i++) {
+        check(autk_region_union_bbox(region, region, random_bbox(96, 48)));
+    }
+}
+
+//==============================================================================
+//
+// Workloads
+//
+//==============================================================================
+
+// Unions one small rectangle at a time into a frame's damage.
+static void
+bench_damage(autk_instance_t *instance)
+{
+    autk_region_t damage;
+    double start;
+    uint64_t rect_total = 0;
+
+    begin_workload("accumulate damage");
+    autk_region_init(instance, &damage);
+
+    start = now_ns();
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        build_damage(&damage);
+        rect_total += damage.rect_count;
+    }
+    report_time("union bbox", start, (size_t)FRAME_COUNT * DAMAGE_RECT_COUNT);
+    printf("  %.1f rects per frame\n", (double)rect_total / FRAME_COUNT);
+
+    autk_region_fini(&damage);
+    report_memory();
+}
+
+// Clips each frame's damage to a window, and to a scrolled viewport inside it.
+static void
+bench_clip(autk_instance_t *instance)
+{
+    static const autk_bbox_t window = {100, 80, 1380, 880};
+    autk_region_t damage;
+    autk_region_t clipped;
+    autk_region_t viewport;
+    autk_region_t hole;
+    double start;
+    uint64_t rect_total = 0;
+
+    begin_workload("clip damage");
+    autk_region_init(instance, &damage);
+    autk_region_init(instance, &clipped);
+    autk_region_init_bbox(instance, &viewport, (autk_bbox_t){200, 160, 1200, 800});
+    autk_region_init_bbox(instance, &hole, (autk_bbox_t){600, 400, 700, 500});
+    check(autk_region_subtract(&viewport, &viewport, &hole)); // e.g. an opaque child widget
+
+    build_damage(&damage);
+    start = now_ns();
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        check(autk_region_intersect_bbox(&clipped, &damage, window));
+        rect_total += clipped.rect_count;
+    }
+    report_time("intersect bbox", start, FRAME_COUNT);
+
+    start = now_ns();
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        check(autk_region_intersect(&clipped, &damage, &viewport));
+        rect_total += clipped.rect_count;
+    }
+    report_time("intersect", start, FRAME_COUNT);
+    printf("  %.1f rects per result\n", (double)rect_total / (2.0 * FRAME_COUNT));
+
+    autk_region_fini(&hole);
+    autk_region_fini(&viewport);
+    autk_region_fini(&clipped);
+    autk_region_fini(&damage);
+    report_memory();
+}
+
+// Subtracts a stack of overlapping windows from the screen, front to back, to find what's visible
+// of each.
+static void
+bench_occlusion(autk_instance_t *instance)
+{
+    autk_bbox_t windows[WINDOW_COUNT];
+    autk_region_t uncovered;
+    autk_region_t window;
+    double start;
+    uint64_t rect_total = 0;
+
+    begin_workload("occlusion");
+    autk_region_init(instance, &uncovered);
+    autk_region_init(instance, &window);
+    for (uint32_t i = 0; i < WINDOW_COUNT; i++) {
+        windows[i] = random_bbox(800, 600);
+    }
+
+    start = now_ns();
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++) {
+        autk_region_fini(&uncovered);
+        autk_region_init_bbox(instance, &uncovered,
+                              (autk_bbox_t){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+        for (uint32_t i = 0; i < WINDOW_COUNT; i++) {
+            autk_region_fini(&window);
+            autk_region_init_bbox(instance, &window, windows[i]);
+            check(autk_region_subtract(&uncovered, &uncovered, &window));
+        }
+        rect_total += uncovered.rect_count;
+    }
+    report_time("subtract", start, (size_t)FRAME_COUNT * WINDOW_COUNT);
+    printf("  %.1f rects uncovered\n", (double)rect_total / FRAME_COUNT);
+
+    autk_region_fini(&window);
+    autk_region_fini(&uncovered);
+    report_memory();
+}
+
+// Looks up random points in a frame's damage, as pointer hit-testing would.
+static void
+bench_hit_test(autk_instance_t *instance)
+{
+    autk_region_t damage;
+    double start;
+    uint32_t hits = 0;
+
+    begin_workload("hit-test");
+    autk_region_init(instance, &damage);
+    build_damage(&damage);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < HIT_TEST_COUNT; i++) {
+        hits += autk_region_contains_point(&damage, (int32_t)(next_random() % SCREEN_WIDTH),
+                                           (int32_t)(next_random() % SCREEN_HEIGHT));
+    }
+    report_time("contains point", start, HIT_TEST_COUNT);
+    printf("  %u of %u points hit %u rects\n", hits, HIT_TEST_COUNT, damage.rect_count);
+
+    autk_region_fini(&damage);
+    report_memory();
+    sink = hits;
+}
+
+// Unions and intersects pairs of rectangles, which should never leave inline storage.
+static void
+bench_small(autk_instance_t *instance)
+{
+    autk_region_t region;
+    autk_bbox_t bbox;
+    double start;
+    uint64_t rect_total = 0;
+
+    begin_workload("small regions");
+    autk_region_init(instance, &region);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < SMALL_OP_COUNT; i++) {
+        bbox = random_bbox(256, 256);
+        autk_region_fini(&region);
+        autk_region_init_bbox(instance, &region, bbox);
+        check(autk_region_union_bbox(&region, &region,
+                                     (autk_bbox_t){bbox.x0 + 32, bbox.y0 + 32, bbox.x1 + 32,
+                                                   bbox.y1 + 32}));
+        rect_total += region.rect_count;
+    }
+    report_time("union pair", start, SMALL_OP_COUNT);
+    printf("  %.1f rects per result\n", (double)rect_total / SMALL_OP_COUNT);
+
+    autk_region_fini(&region);
+    report_memory();
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const autk_instance_create_params_t instance_params = {
+        .struct_size = sizeof(autk_instance_create_params_t),
+        .alloc_func = &counting_alloc,
+        .message_func = &autk_stderr_message,
+    };
+    static const struct {
+        const char *name;
+        void (*func)(autk_instance_t *instance);
+    } workloads[] = {
+        {"damage", bench_damage},
+        {"clip", bench_clip},
+        {"occlusion", bench_occlusion},
+        {"hit-test", bench_hit_test},
+        {"small", bench_small},
+    };
+    autk_instance_t *instance;
+    bool found = argc < 2;
+
+    check(autk_instance_create(&instance_params, &instance));
+
+    // Run all workloads, or only the ones named on the command line.
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+        for (int j = 1; j < argc; j++) {
+            if (strcmp(argv[j], workloads[i].name) == 0) {
+                found = true;
+                workloads[i].func(instance);
+            }
+        }
+        if (argc < 2) {
+            workloads[i].func(instance);
+        }
+    }
+
+    autk_instance_destroy(instance);
+
+    if (!found) {
+        fprintf(stderr, "usage: %s [workload...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
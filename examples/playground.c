@@ -29,14 +29,72 @@ debug_alloc(void *ctx, void *block, size_t old_size, size_t new_size, autk_memor
     return autk_default_alloc(ctx, block, old_size, new_size, tag);
 }
 
+// Per-window state, allocated along with the window.
+typedef struct {
+    autk_display_list_t *panel; // recorded window contents, kept until the size changes
+    uint32_t panel_width, panel_height;
+} window_state_t;
+
+// Records a raised panel inset from the window's edges.
+static autk_status_t
+record_panel(autk_display_list_t *list, uint32_t width, uint32_t height)
+{
+    autk_bbox_t panel = {16, 16, (int32_t)width - 16, (int32_t)height - 16};
+    autk_bbox_t face = {panel.x0 + 1, panel.y0 + 1, panel.x1 - 1, panel.y1 - 1};
+
+    autk_display_list_clear(list);
+    AUTK_TRY(autk_display_list_fill_rect(list, &face, AUTK_RGB(192, 192, 192)));
+    AUTK_TRY(autk_display_list_draw_bevel(list, &panel, AUTK_RGB(255, 255, 255),
+                                          AUTK_RGB(64, 64, 64)));
+    return AUTK_OK;
+}
+
 static void
-on_redraw_requested(autk_window_t *window, void *user_data, const autk_dirty_region_t *dirty_region)
+on_destroying(autk_window_t *window, void *user_data)
 {
+    window_state_t *state = user_data;
+
     (void)window;
-    (void)user_data;
-    (void)dirty_region;
+
+    autk_display_list_destroy(state->panel);
+}
+
+static void
+on_redraw_requested(autk_window_t *window, void *user_data, const autk_dirty_region_t *dirty_region)
+{
+    window_state_t *state = user_data;
+    autk_surface_t *surface = autk_window_get_surface(window);
+    uint32_t width, height;
 
     fputs("redraw\n", stderr);
+
+    // Only draw if the window can be drawn client-side.
+    if (!surface) {
+        return;
+    }
+
+    // Record the panel the first time, and again when the window's size changes. Other redraws,
+    // such as exposes, just replay it.
+    autk_surface_get_size(surface, &width, &height);
+    if (!state->panel) {
+        AUTK_EXPECT(autk_display_list_create(autk_window_get_instance(window), &state->panel));
+    }
+    if (autk_display_list_is_empty(state->panel) || width != state->panel_width
+        || height != state->panel_height)
+    {
+        AUTK_EXPECT(record_panel(state->panel, width, height));
+        state->panel_width = width;
+        state->panel_height = height;
+    }
+
+    if (!dirty_region) {
+        AUTK_EXPECT(autk_display_list_replay(state->panel, surface, NULL));
+        return;
+    }
+    for (size_t i = 0; i < dirty_region->partial_bbox_count; ++i) {
+        AUTK_EXPECT(
+            autk_display_list_replay(state->panel, surface, &dirty_region->partial_bboxes[i]));
+    }
 }
 
 int
@@ -49,6 +107,7 @@ main(int argc, char *argv[])
     };
     static const autk_window_callbacks_t window_callbacks = {
         .struct_size = sizeof(autk_window_callbacks_t),
+        .destroying = &on_destroying,
         .close_requested = &autk_window_callback_quit, // quit the app when the window is closed
         .redraw_requested = &on_redraw_requested,
     };
@@ -56,6 +115,7 @@ main(int argc, char *argv[])
         .struct_size = sizeof(autk_window_create_params_t),
         .title = "Hello!",
         .callbacks = &window_callbacks,
+        .user_data_size = sizeof(window_state_t),
     };
 
     autk_instance_t *instance;
@@ -39,6 +39,85 @@ autk_client_run(autk_client_t *client);
 AUTK_API autk_status_t
 autk_client_quit(autk_client_t *client);
 
+/// Waits up to `timeout_ms` milliseconds (-1 for no limit, 0 to not block) for something to do,
+/// then does one pass of the client's run loop: pending jobs, due timers, display events, watched
+/// fds and redraws. Lets an application drive the client from its own loop instead of
+/// `autk_client_run()`.
+///
+/// \return `AUTK_OK` on success, `AUTK_ERR_INTERRUPTED` if `autk_client_quit()` was called, or
+///         another error code on failure.
+AUTK_API autk_status_t
+autk_client_dispatch(autk_client_t *client, int timeout_ms);
+
+/// Describes what an external event loop should wait on before calling `autk_client_dispatch()`.
+/// Must be called immediately before each wait, since it also tells other threads posting jobs that
+/// the client is about to sleep and must be woken through `wakeup_fd`. After the wait, call
+/// `autk_client_dispatch()` even if nothing became ready.
+AUTK_API autk_status_t
+autk_client_get_wait_fds(autk_client_t *client, autk_client_wait_fds_t *out_wait_fds);
+
+/// Queues a job to be executed on the thread running the client. May be called from any thread.
+/// If the job can't be queued, its `fini` function is called before returning.
+AUTK_API autk_status_t
+autk_client_post_job(autk_client_t *client, autk_job_t job);
+
+/// Queues several jobs at once, waking the client's thread at most once. Jobs run in array order.
+/// If only some of the jobs can be queued, the rest are finalized and an error is returned.
+AUTK_API autk_status_t
+autk_client_post_jobs(autk_client_t *client, const autk_job_t *jobs, size_t job_count);
+
+/// Queues a job whose context is a copy of `data_size` bytes at `data`, so the caller doesn't need
+/// to allocate one. `job.ctx` is ignored; `exec` and `fini` receive a pointer to the copy, which is
+/// aligned for any type and valid until `fini` returns. Copies of up to
+/// \ref AUTK_JOB_INLINE_DATA_SIZE bytes are stored inside the job queue, and larger ones in pooled
+/// blocks. If the instance's allocator isn't thread-safe, other threads can't allocate blocks, so
+/// the client's thread keeps a few of each size ready: once they're all in use, this fails with
+/// `AUTK_ERR_QUEUE_FULL`, and copies larger than 4096 bytes fail with
+/// `AUTK_ERR_INVALID_CONFIGURATION`. May be called from any thread. If the job can't be queued, its
+/// `fini` function is called with `data` itself before returning.
+AUTK_API autk_status_t
+autk_client_post_job_data(autk_client_t *client, autk_job_t job, const void *data,
+                          size_t data_size);
+
+/// Reads the client's job queue statistics. Must be called on the thread running the client.
+///
+/// \return `AUTK_OK` on success, or `AUTK_ERR_UNSUPPORTED_FEATURE` if Autk was built without
+///         `AUTK_JOB_STATS`.
+AUTK_API autk_status_t
+autk_client_get_stats(autk_client_t *client, autk_client_stats_t *out_stats);
+
+/// Adds a timer that is run by the client's run loop. Must be called on the thread running the
+/// client. If the timer can't be added, its `fini` function is called before returning.
+AUTK_API autk_status_t
+autk_client_add_timer(autk_client_t *client, const autk_timer_params_t *params,
+                      autk_timer_id_t *out_id);
+
+/// Cancels a timer and finalizes it. A timer may cancel itself from its own callback. Must be
+/// called on the thread running the client.
+AUTK_API autk_status_t
+autk_client_cancel_timer(autk_client_t *client, autk_timer_id_t id);
+
+/// Sets the minimum time between redraws. Damage reported in between is collected and delivered in
+/// one `redraw_requested` call per window once the next frame is due. Zero, the default, follows
+/// the display's refresh rate where the driver can find it out, and 60 Hz otherwise. Must be called
+/// on the thread running the client.
+AUTK_API autk_status_t
+autk_client_set_frame_interval(autk_client_t *client, uint64_t interval_ns);
+
+/// Calls `params->callback` from the client's run loop whenever `params->fd` is ready, so sockets
+/// and pipes can be serviced on the client's thread without a reader thread. Watching a descriptor
+/// that is already watched replaces its watch. Must be called on the thread running the client.
+/// If the watch can't be added, its `fini` function is called before returning.
+///
+/// A descriptor must be unwatched before it is closed.
+AUTK_API autk_status_t
+autk_client_watch_fd(autk_client_t *client, const autk_fd_watch_params_t *params);
+
+/// Removes a file descriptor watch and finalizes it. A watch may remove itself from its own
+/// callback. Must be called on the thread running the client.
+AUTK_API autk_status_t
+autk_client_unwatch_fd(autk_client_t *client, int fd);
+
 AUTK_API autk_device_t *
 autk_client_get_device(autk_client_t *client);
 
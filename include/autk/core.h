@@ -22,9 +22,11 @@
 #include "client.h"
 #include "device.h"
 #include "diagnostics.h"
+#include "display_list.h"
 #include "instance.h"
 #include "math.h"
 #include "style.h"
+#include "surface.h"
 #include "types.h"
 #include "window.h"
 
@@ -19,6 +19,9 @@
 
 #include "types.h"
 
+/// Device that draws on the CPU, with SIMD kernels where the CPU supports them.
+AUTK_API extern const autk_device_driver_t autk_device_driver_raster;
+
 AUTK_BEGIN_DECLS
 
 AUTK_API void *
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_DISPLAY_LIST_H_
+#define AUTK_DISPLAY_LIST_H_
+
+#include "types.h"
+
+AUTK_BEGIN_DECLS
+
+AUTK_API autk_status_t
+autk_display_list_create(autk_instance_t *instance, autk_display_list_t **out_list);
+
+AUTK_API void
+autk_display_list_destroy(autk_display_list_t *list);
+
+/// Removes all commands, keeping the list's memory for recording new ones.
+AUTK_API void
+autk_display_list_clear(autk_display_list_t *list);
+
+AUTK_API bool
+autk_display_list_is_empty(const autk_display_list_t *list);
+
+/// Returns the bounding box of every pixel the list's commands may touch.
+AUTK_API autk_bbox_t
+autk_display_list_get_bounds(const autk_display_list_t *list);
+
+// Recording functions. Each records a call to the `autk_surface_*()` function of the same name.
+
+AUTK_API autk_status_t
+autk_display_list_fill_rect(autk_display_list_t *list, const autk_bbox_t *bbox,
+                            autk_rgba_t color);
+
+AUTK_API autk_status_t
+autk_display_list_blend_rect(autk_display_list_t *list, const autk_bbox_t *bbox,
+                             autk_rgba_t color);
+
+/// Records a copy from `src`, which must outlive the list. Its pixels are read when the list is
+/// replayed.
+AUTK_API autk_status_t
+autk_display_list_copy(autk_display_list_t *list, int32_t dst_x, int32_t dst_y,
+                       autk_surface_t *src, const autk_bbox_t *src_bbox);
+
+/// Like `autk_display_list_copy()`, but records a blend.
+AUTK_API autk_status_t
+autk_display_list_blend(autk_display_list_t *list, int32_t dst_x, int32_t dst_y,
+                        autk_surface_t *src, const autk_bbox_t *src_bbox);
+
+AUTK_API autk_status_t
+autk_display_list_draw_line(autk_display_list_t *list, int32_t x0, int32_t y0, int32_t x1,
+                            int32_t y1, autk_rgba_t color);
+
+AUTK_API autk_status_t
+autk_display_list_draw_bevel(autk_display_list_t *list, const autk_bbox_t *bbox,
+                             autk_rgba_t top_left, autk_rgba_t bottom_right);
+
+/// Draws the list's commands onto `surface`, limited to `clip` within the surface's own clip
+/// rectangle, or to the surface's clip rectangle alone if `clip` is `NULL`. Commands that can't
+/// touch the clipped area are skipped. Replaying a list doesn't change it, so it can be kept and
+/// replayed whenever the same area needs redrawing.
+AUTK_API autk_status_t
+autk_display_list_replay(const autk_display_list_t *list, autk_surface_t *surface,
+                         const autk_bbox_t *clip);
+
+AUTK_END_DECLS
+
+#endif // AUTK_DISPLAY_LIST_H_
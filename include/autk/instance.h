@@ -31,7 +31,8 @@ AUTK_API autk_status_t
 autk_instance_create(const autk_instance_create_params_t *params, autk_instance_t **out_instance);
 
 /// Destroys an Autk library instance. The caller is responsible for ensuring that all resources
-/// created from the instance have been destroyed before calling this function.
+/// created from the instance have been destroyed before calling this function. Waits for any
+/// submitted tasks to finish.
 AUTK_API void
 autk_instance_destroy(autk_instance_t *instance);
 
@@ -40,6 +41,15 @@ autk_instance_destroy(autk_instance_t *instance);
 AUTK_API void *
 autk_instance_get_user_data(autk_instance_t *instance);
 
+/// Queues a task to run on one of the instance's worker threads. May be called from any thread,
+/// including from within another task. If the task can't be queued, its `fini` function is called
+/// before returning.
+///
+/// \return `AUTK_OK` on success, `AUTK_ERR_UNSUPPORTED_FEATURE` if the instance was created
+///         without worker threads, or another error code on failure.
+AUTK_API autk_status_t
+autk_instance_submit_task(autk_instance_t *instance, const autk_task_params_t *params);
+
 /// Invokes the instance's message handler, if one was provided at instance creation.
 ///
 /// Calling this manually is inconvenient due to the sheer number of parameters.
@@ -30,6 +30,32 @@ autk_bbox_is_positive(const autk_bbox_t *bbox)
     return bbox->x0 < bbox->x1 && bbox->y0 < bbox->y1;
 }
 
+/// Returns true if `inner` lies entirely within `outer`.
+static inline bool
+autk_bbox_contains(const autk_bbox_t *outer, const autk_bbox_t *inner)
+{
+    return outer->x0 <= inner->x0 && outer->y0 <= inner->y0 && outer->x1 >= inner->x1
+           && outer->y1 >= inner->y1;
+}
+
+/// Returns true if `a` and `b` have at least one pixel in common.
+static inline bool
+autk_bbox_overlaps(const autk_bbox_t *a, const autk_bbox_t *b)
+{
+    return a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1;
+}
+
+/// Clips `bbox` to `clip`, returning false if nothing's left.
+static inline bool
+autk_bbox_intersect(autk_bbox_t *bbox, const autk_bbox_t *clip)
+{
+    bbox->x0 = bbox->x0 > clip->x0 ? bbox->x0 : clip->x0;
+    bbox->y0 = bbox->y0 > clip->y0 ? bbox->y0 : clip->y0;
+    bbox->x1 = bbox->x1 < clip->x1 ? bbox->x1 : clip->x1;
+    bbox->y1 = bbox->y1 < clip->y1 ? bbox->y1 : clip->y1;
+    return autk_bbox_is_positive(bbox);
+}
+
 static inline int32_t
 autk_scale_int32(int32_t n, autk_u30x2_t scale)
 {
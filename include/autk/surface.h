@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_SURFACE_H_
+#define AUTK_SURFACE_H_
+
+#include "types.h"
+
+AUTK_BEGIN_DECLS
+
+AUTK_API autk_status_t
+autk_surface_create(autk_device_t *device, const autk_surface_create_params_t *params,
+                    autk_surface_t **out_surface);
+
+AUTK_API void
+autk_surface_destroy(autk_surface_t *surface);
+
+AUTK_API autk_device_t *
+autk_surface_get_device(autk_surface_t *surface);
+
+/// Returns the surface's pixels. See \ref autk_surface_t for their layout.
+AUTK_API uint32_t *
+autk_surface_get_pixels(autk_surface_t *surface);
+
+/// Returns the number of bytes between the starts of consecutive rows.
+AUTK_API size_t
+autk_surface_get_stride(autk_surface_t *surface);
+
+AUTK_API void
+autk_surface_get_size(autk_surface_t *surface, uint32_t *out_width, uint32_t *out_height);
+
+/// Limits drawing to `clip`, or to the whole surface if `clip` is `NULL`. Copies and blends are
+/// clipped by the destination's clip rectangle but not the source's.
+AUTK_API void
+autk_surface_set_clip(autk_surface_t *surface, const autk_bbox_t *clip);
+
+AUTK_API autk_bbox_t
+autk_surface_get_clip(autk_surface_t *surface);
+
+/// Fills a rectangle with `color`, replacing what's there, alpha included.
+AUTK_API autk_status_t
+autk_surface_fill_rect(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t color);
+
+/// Composites `color` over a rectangle according to its alpha.
+AUTK_API autk_status_t
+autk_surface_blend_rect(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t color);
+
+/// Copies `src_bbox` of `src` to (`dst_x`, `dst_y`) in `dst`, or all of `src` if `src_bbox` is
+/// `NULL`. Both surfaces must belong to the same device. They may be the same surface, in which
+/// case the rectangles may overlap.
+AUTK_API autk_status_t
+autk_surface_copy(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                  const autk_bbox_t *src_bbox);
+
+/// Like `autk_surface_copy()`, but composites `src` over `dst` according to its alpha.
+AUTK_API autk_status_t
+autk_surface_blend(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                   const autk_bbox_t *src_bbox);
+
+/// Draws a 1-pixel line from (`x0`, `y0`) to (`x1`, `y1`), including both end points, compositing
+/// `color` like `autk_surface_blend_rect()`. Sloped lines are stepped without antialiasing, and may
+/// not span more than 2^30 pixels along either axis.
+AUTK_API autk_status_t
+autk_surface_draw_line(autk_surface_t *surface, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                       autk_rgba_t color);
+
+/// Draws a 1-pixel bevel just inside `bbox`, compositing `top_left` along the top and left edges
+/// and `bottom_right` along the bottom and right edges. The bottom and right edges get the corners
+/// they share with the others. Nesting two bevels gives the classic 3D border.
+AUTK_API autk_status_t
+autk_surface_draw_bevel(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t top_left,
+                        autk_rgba_t bottom_right);
+
+AUTK_END_DECLS
+
+#endif // AUTK_SURFACE_H_
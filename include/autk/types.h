@@ -52,6 +52,7 @@ typedef enum autk_status {
     m(AUTK_ERR_INSUFFICIENT_BUFFER, "Insufficient buffer size") \
     m(AUTK_ERR_INTERRUPTED, "Operation interrupted") \
     m(AUTK_ERR_IO_FAILURE, "I/O failure") \
+    m(AUTK_ERR_NOT_FOUND, "Not found") \
     m(AUTK_ERR_OUT_OF_MEMORY, "Out of memory") \
     m(AUTK_ERR_PROTOCOL_VIOLATION, "Protocol violation") \
     m(AUTK_ERR_QUEUE_EMPTY, "Queue is empty") \
@@ -116,12 +117,16 @@ typedef enum autk_memory_tag {
 #define AUTK_FOREACH_MEMORY_TAG(m) \
     m(AUTK_MEMORY_TAG_UNKNOWN, "unknown") \
     m(AUTK_MEMORY_TAG_CLIENT, "client") \
+    m(AUTK_MEMORY_TAG_DISPLAY_LIST, "display list") \
     m(AUTK_MEMORY_TAG_HASH, "hash") \
     m(AUTK_MEMORY_TAG_INSTANCE, "instance") \
     m(AUTK_MEMORY_TAG_LIST, "list") \
     m(AUTK_MEMORY_TAG_QUEUE, "queue") \
+    m(AUTK_MEMORY_TAG_REGION, "region") \
     m(AUTK_MEMORY_TAG_STRING, "string") \
     m(AUTK_MEMORY_TAG_STYLE, "style") \
+    m(AUTK_MEMORY_TAG_SURFACE, "surface") \
+    m(AUTK_MEMORY_TAG_TASK, "task") \
     m(AUTK_MEMORY_TAG_WINDOW, "window")
 /* clang-format on */
 #define AUTK_DO(e, s) e,
@@ -203,6 +208,9 @@ typedef void (*autk_message_func_t)(void *ctx, autk_message_severity_t severity,
                                     const char *module_name, const autk_source_location_t *location,
                                     const char *message);
 
+/// Pass as `worker_thread_count` to start one worker thread per CPU.
+#define AUTK_WORKER_THREAD_COUNT_AUTO UINT32_MAX
+
 typedef struct autk_instance_create_params {
     uint32_t struct_size;
     enum autk_instance_create_flags flags;
@@ -210,10 +218,29 @@ typedef struct autk_instance_create_params {
     void *alloc_ctx;
     autk_message_func_t message_func;
     void *message_ctx;
+    /// Number of background worker threads for `autk_instance_submit_task()`, or
+    /// \ref AUTK_WORKER_THREAD_COUNT_AUTO. Zero starts no threads. Requires a thread-safe
+    /// allocator.
+    uint32_t worker_thread_count;
     uint32_t user_data_size;
     const void *user_data_init;
 } autk_instance_create_params_t;
 
+typedef struct autk_task_params {
+    /// Size of this struct. Must be `sizeof(autk_task_params_t)`.
+    uint32_t struct_size;
+    void *ctx;
+    /// Called on one of the instance's worker threads.
+    void (*exec)(void *ctx);
+    /// Client to deliver `complete` to, or `NULL` if the task has no continuation.
+    struct autk_client *client;
+    /// Posted to `client` as a job once `exec` returns, so it runs on the client's thread.
+    void (*complete)(void *ctx, struct autk_client *client);
+    /// Called once the task is done with `ctx`: after `complete` runs, after `exec` if there is no
+    /// continuation, or if the task or its continuation can't be queued.
+    void (*fini)(void *ctx);
+} autk_task_params_t;
+
 //==============================================================================
 //
 // Client types
@@ -239,12 +266,115 @@ typedef struct autk_client_create_params {
     const void *user_data_init;
 } autk_client_create_params_t;
 
+/// Data posted with `autk_client_post_job_data()` up to this size is stored inside the client's
+/// job queue instead of in a separate allocation.
+#define AUTK_JOB_INLINE_DATA_SIZE 48
+
 typedef struct autk_job {
     void *ctx;
     void (*exec)(void *ctx, struct autk_client *client);
     void (*fini)(void *ctx);
 } autk_job_t;
 
+/// Identifies a timer added with `autk_client_add_timer()`. IDs are never reused by a client, and
+/// zero is never a valid ID.
+typedef uint64_t autk_timer_id_t;
+
+typedef struct autk_timer_params {
+    /// Size of this struct. Must be `sizeof(autk_timer_params_t)`.
+    uint32_t struct_size;
+    /// Time from now until the timer first fires, in nanoseconds.
+    uint64_t delay_ns;
+    /// Time between firings for a repeating timer, or `0` for a one-shot timer.
+    uint64_t interval_ns;
+    /// How late the timer may fire, in nanoseconds. Deadlines are rounded up to a multiple of the
+    /// slack, so timers with the same slack fire together and the client wakes up less often.
+    uint64_t slack_ns;
+    void *ctx;
+    void (*exec)(void *ctx, struct autk_client *client, autk_timer_id_t id);
+    /// Called once the timer will never fire again: after a one-shot timer fires, or when the
+    /// timer is canceled or the client is destroyed.
+    void (*fini)(void *ctx);
+} autk_timer_params_t;
+
+/// Readiness conditions for a file descriptor watched with `autk_client_watch_fd()`.
+enum autk_fd_events {
+    /// Data can be read without blocking.
+    AUTK_FD_EVENT_READABLE = 1 << 0,
+    /// Data can be written without blocking.
+    AUTK_FD_EVENT_WRITABLE = 1 << 1,
+    /// An error is pending on the descriptor. Always reported, whether requested or not.
+    AUTK_FD_EVENT_ERROR = 1 << 2,
+    /// The peer closed its end. Always reported, whether requested or not.
+    AUTK_FD_EVENT_HANGUP = 1 << 3,
+
+    AUTK_FD_EVENT_ALL = AUTK_FD_EVENT_READABLE | AUTK_FD_EVENT_WRITABLE | AUTK_FD_EVENT_ERROR
+                        | AUTK_FD_EVENT_HANGUP,
+
+    AUTK_FD_EVENT_32BIT_ = 0x7FFFFFFFul,
+};
+typedef uint32_t autk_fd_events_t; ///< \see \ref autk_fd_events
+
+typedef struct autk_fd_watch_params {
+    /// Size of this struct. Must be `sizeof(autk_fd_watch_params_t)`.
+    uint32_t struct_size;
+    /// Descriptor to watch. The client doesn't take ownership of it.
+    int fd;
+    /// Conditions to wait for.
+    autk_fd_events_t events;
+    void *ctx;
+    /// Called on the thread running the client while any of `events` hold, with the conditions
+    /// that do. Watches are level-triggered, so it's called again on the next pass of the run loop
+    /// if the condition still holds.
+    void (*callback)(void *ctx, struct autk_client *client, int fd, autk_fd_events_t revents);
+    /// Called once the watch is removed, replaced, or the client is destroyed.
+    void (*fini)(void *ctx);
+} autk_fd_watch_params_t;
+
+/// What to wait on when driving a client from an external event loop. See
+/// `autk_client_get_wait_fds()`.
+typedef struct autk_client_wait_fds {
+    /// Size of this struct. Must be `sizeof(autk_client_wait_fds_t)`.
+    uint32_t struct_size;
+    /// File descriptor that becomes readable when display events arrive, or -1 if none.
+    int display_fd;
+    /// File descriptor that becomes readable when jobs are posted from another thread.
+    int wakeup_fd;
+    /// File descriptor that becomes readable when a descriptor watched with
+    /// `autk_client_watch_fd()` is ready, or -1 if none. Only available where the client can
+    /// combine its watches into one descriptor (epoll on Linux). Elsewhere, watched descriptors are
+    /// only checked when `autk_client_dispatch()` is called.
+    int watch_fd;
+    /// Longest time to wait, in milliseconds, or -1 for no limit. Zero if there's already work to
+    /// do.
+    int timeout_ms;
+} autk_client_wait_fds_t;
+
+/// Summary of a latency distribution. Percentiles are accurate to within 1/8 of their value.
+typedef struct autk_latency_stats {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} autk_latency_stats_t;
+
+/// Job queue statistics, collected only if Autk was built with `AUTK_JOB_STATS`.
+typedef struct autk_client_stats {
+    /// Size of this struct. Must be `sizeof(autk_client_stats_t)`.
+    uint32_t struct_size;
+    /// Time from posting a job until its `exec` function starts.
+    autk_latency_stats_t job_queue_latency;
+    /// Time spent in each job's `exec` and `fini` functions.
+    autk_latency_stats_t job_exec_time;
+    /// Largest number of jobs that were queued at once.
+    uint64_t peak_queued_jobs;
+    /// Number of jobs posted while the queue's preallocated nodes were all in use, each of which
+    /// needed a node from the instance's allocator.
+    uint64_t node_pool_miss_count;
+    /// Number of jobs that couldn't be queued at all.
+    uint64_t post_failure_count;
+} autk_client_stats_t;
+
 typedef struct autk_client_driver {
     /// Size of this struct. Must be `sizeof(autk_client_driver_t)`.
     uint32_t struct_size;
@@ -261,6 +391,29 @@ typedef struct autk_client_driver {
     void (*fini)(struct autk_client *client, void *driver_data);
     autk_status_t (*run)(struct autk_client *client, void *driver_data);
     autk_status_t (*quit)(struct autk_client *client, void *driver_data);
+    /// Function called to wait up to `timeout_ms` for work, then do one pass of the run loop.
+    autk_status_t (*dispatch)(struct autk_client *client, void *driver_data, int timeout_ms);
+    /// Function called to prepare for an external wait and describe what to wait on.
+    autk_status_t (*get_wait_fds)(struct autk_client *client, void *driver_data,
+                                  autk_client_wait_fds_t *out_wait_fds);
+    /// Function called to watch a file descriptor, replacing any existing watch on it. If the
+    /// watch can't be added, it must not be finalized. The caller is responsible for that.
+    autk_status_t (*watch_fd)(struct autk_client *client, void *driver_data,
+                              const autk_fd_watch_params_t *params);
+    /// Function called to remove and finalize a file descriptor watch.
+    autk_status_t (*unwatch_fd)(struct autk_client *client, void *driver_data, int fd);
+    /// Function called to queue jobs for the client's thread. May be called from any thread.
+    /// Jobs that can't be queued must be finalized before returning.
+    autk_status_t (*post_jobs)(struct autk_client *client, void *driver_data,
+                               const autk_job_t *jobs, size_t job_count);
+    /// Function called to queue a job whose context is a copy of `data`. May be called from any
+    /// thread. If the job can't be queued, it must be finalized with `data` before returning.
+    autk_status_t (*post_job_data)(struct autk_client *client, void *driver_data,
+                                   const autk_job_t *job, const void *data, size_t data_size);
+    /// Function called to fill in job queue statistics. Only called if Autk was built with
+    /// `AUTK_JOB_STATS`.
+    void (*get_stats)(struct autk_client *client, void *driver_data,
+                      autk_client_stats_t *out_stats);
 } autk_client_driver_t;
 
 //==============================================================================
@@ -271,14 +424,64 @@ typedef struct autk_client_driver {
 
 typedef struct autk_device autk_device_t;
 
+/// A 32-bit image drawn into by a device. Each pixel is a native-endian `uint32_t` laid out as
+/// `0xAARRGGBB`, with premultiplied alpha.
+typedef struct autk_surface autk_surface_t;
+
+/// A recorded sequence of drawing commands, which can be replayed onto surfaces any number of
+/// times.
+typedef struct autk_display_list autk_display_list_t;
+
+typedef struct autk_surface_create_params {
+    /// Size of this struct. Must be `sizeof(autk_surface_create_params_t)`.
+    uint32_t struct_size;
+    uint32_t width, height;
+    /// Memory to draw into, or `NULL` to have the surface allocate its own. The surface doesn't
+    /// take ownership of it, and it must outlive the surface.
+    void *pixels;
+    /// Number of bytes between the starts of consecutive rows of `pixels`. Must be a multiple of 4,
+    /// and at least `width * 4`. Ignored if `pixels` is `NULL`.
+    size_t stride;
+} autk_surface_create_params_t;
+
+enum autk_device_driver_flags {
+    /// The drawing functions may be called from several threads at once, as long as the calls
+    /// write disjoint pixels. Lets clients spread a frame's drawing across worker threads.
+    AUTK_DEVICE_DRIVER_FLAG_CONCURRENT_DRAWING = 1 << 0,
+
+    AUTK_DEVICE_DRIVER_FLAG_32BIT_ = 0x7FFFFFFFul,
+};
+typedef uint32_t autk_device_driver_flags_t; ///< \see \ref autk_device_driver_flags
+
 typedef struct autk_device_driver {
     uint32_t struct_size;
     uint32_t driver_data_size;
+    autk_device_driver_flags_t flags;
 
     autk_status_t (*init_from_client)(autk_device_t *device, void *driver_data,
                                       autk_client_t *client, void *client_driver_data,
                                       const autk_client_create_params_t *client_params);
     void (*fini)(autk_device_t *device, void *driver_data);
+
+    // Drawing functions. Rectangles are already clipped to the surfaces and aren't empty, and
+    // colors are premultiplied pixels. A device that can't draw leaves these `NULL`.
+
+    /// Function called to fill a rectangle with a pixel, replacing what's there.
+    void (*fill_rect)(autk_device_t *device, void *driver_data, autk_surface_t *surface,
+                      const autk_bbox_t *bbox, uint32_t pixel);
+    /// Function called to composite a pixel over a rectangle.
+    void (*blend_rect)(autk_device_t *device, void *driver_data, autk_surface_t *surface,
+                       const autk_bbox_t *bbox, uint32_t pixel);
+    /// Function called to copy `src_bbox` of `src` to (`dst_x`, `dst_y`) in `dst`. The surfaces may
+    /// be the same, and the rectangles may overlap.
+    void (*copy_rect)(autk_device_t *device, void *driver_data, autk_surface_t *dst,
+                      int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                      const autk_bbox_t *src_bbox);
+    /// Function called to composite `src_bbox` of `src` over `dst` at (`dst_x`, `dst_y`). The
+    /// surfaces may be the same, and the rectangles may overlap.
+    void (*blend_image)(autk_device_t *device, void *driver_data, autk_surface_t *dst,
+                        int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                        const autk_bbox_t *src_bbox);
 } autk_device_driver_t;
 
 //==============================================================================
@@ -337,8 +540,11 @@ typedef enum autk_window_type {
 } autk_window_type_t;
 
 typedef struct autk_dirty_region {
+    /// Bounding box of everything that needs to be redrawn.
     autk_bbox_t full_bbox;
     size_t partial_bbox_count;
+    /// Rectangles whose union covers everything that needs to be redrawn. They may overlap, and
+    /// they may cover some area that doesn't strictly need redrawing.
     const autk_bbox_t *partial_bboxes;
 } autk_dirty_region_t;
 
@@ -369,6 +575,7 @@ typedef struct autk_window_driver {
                                           autk_rgba_t color);
     autk_status_t (*set_title)(autk_window_t *window, void *driver_data, const char *title);
     autk_status_t (*set_visible)(autk_window_t *window, void *driver_data, bool visible);
+    autk_surface_t *(*get_surface)(autk_window_t *window, void *driver_data);
 } autk_window_driver_t;
 
 typedef struct autk_window_create_params {
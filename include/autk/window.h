@@ -52,6 +52,12 @@ autk_window_set_title(autk_window_t *window, const char *title);
 AUTK_API autk_status_t
 autk_window_set_visible(autk_window_t *window, bool visible);
 
+/// Returns the surface to draw the window's contents into from its `redraw_requested` callback.
+/// Drawing is clipped to the dirty region, and is shown once the callback returns. Returns `NULL`
+/// outside of the callback, or if the window can't be drawn by the client.
+AUTK_API autk_surface_t *
+autk_window_get_surface(autk_window_t *window);
+
 // Helper callbacks
 
 AUTK_API void
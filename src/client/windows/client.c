@@ -16,6 +16,7 @@
 
 #include <windows.h>
 
+#include <autk/device.h>
 #include <autk/diagnostics.h>
 #include <core/types.h>
 #include <os/windows/system.h>
@@ -143,6 +144,7 @@ AUTK_API const autk_client_driver_t autk_client_driver_windows = {
     .struct_size = sizeof(autk_client_driver_t),
     .driver_data_size = sizeof(autk_windows_client_data_t),
 
+    .device_driver = &autk_device_driver_raster,
     .window_driver = &autk_window_driver_windows,
 
     .init = &autk_windows_client_init,
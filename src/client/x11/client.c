@@ -23,12 +23,18 @@
 #include <xcb/xcb.h>
 
 #include <autk/client.h>
+#include <autk/device.h>
 #include <autk/diagnostics.h>
 #include <autk/math.h>
+#include <autk/surface.h>
+#include <os/time.h>
 
 #include "client.h"
+#include "framebuffer.h"
 #include "window.h"
 
+#define JOB_BATCH_MAX 64 // jobs to run between checks for X11 events
+
 //==============================================================================
 //
 // Event handling
@@ -55,7 +61,7 @@ handle_xcb_error(autk_client_t *client, autk_x11_client_data_t *client_data,
         if (window) {
             AUTK_ERROR(client->instance, "X11 window creation failed for window id=%" PRIu32,
                        error->resource_id);
-            autk_x11_window_invalidate(window->driver_data);
+            autk_x11_window_invalidate(window);
         }
     }
 
@@ -92,10 +98,19 @@ static autk_status_t
 handle_xcb_event(autk_client_t *client, autk_x11_client_data_t *client_data,
                  const xcb_generic_event_t *event)
 {
-    autk_window_t *window;
+    const xcb_expose_event_t *expose;
+    const xcb_configure_notify_event_t *configure;
     autk_x11_window_data_t *window_data;
+#if AUTK_X11_PRESENT
+    const xcb_ge_generic_event_t *generic;
+#endif
+    autk_window_t *window;
     autk_bbox_t bbox;
 
+    if (autk_x11_framebuffer_handle_event(client_data, event)) {
+        return AUTK_OK;
+    }
+
     switch (event->response_type & ~0x80) {
         case 0:
             return handle_xcb_error(client, client_data, (const xcb_generic_error_t *)event);
@@ -107,25 +122,55 @@ handle_xcb_event(autk_client_t *client, autk_x11_client_data_t *client_data,
             window = autk_x11_window_map_get(&client_data->window_map,
                                              ((xcb_destroy_notify_event_t *)event)->window);
             if (window) {
-                autk_x11_window_invalidate(window->driver_data);
+                autk_x11_window_invalidate(window);
+            }
+            return AUTK_OK;
+
+        case XCB_CONFIGURE_NOTIFY:
+            // Track the size for the window's back buffers. The server exposes whatever the
+            // resize uncovers.
+            configure = (const xcb_configure_notify_event_t *)event;
+            window = autk_x11_window_map_get(&client_data->window_map, configure->window);
+            if (window) {
+                window_data = window->driver_data;
+                window_data->width = configure->width;
+                window_data->height = configure->height;
             }
             return AUTK_OK;
 
         case XCB_EXPOSE:
-            window = autk_x11_window_map_get(&client_data->window_map,
-                                             ((xcb_expose_event_t *)event)->window);
+            expose = (const xcb_expose_event_t *)event;
+            window = autk_x11_window_map_get(&client_data->window_map, expose->window);
             if (window && window->callbacks && window->callbacks->redraw_requested) {
-                window_data = window->driver_data;
                 bbox = (autk_bbox_t){
-                    .x0 = ((xcb_expose_event_t *)event)->x,
-                    .y0 = ((xcb_expose_event_t *)event)->y,
-                    .x1 = ((xcb_expose_event_t *)event)->x + ((xcb_expose_event_t *)event)->width,
-                    .y1 = ((xcb_expose_event_t *)event)->y + ((xcb_expose_event_t *)event)->height,
+                    .x0 = expose->x,
+                    .y0 = expose->y,
+                    .x1 = expose->x + expose->width,
+                    .y1 = expose->y + expose->height,
                 };
-                autk_bbox_extend(&window_data->dirty_region, bbox);
+                autk_x11_window_add_dirty_region(window, bbox);
+
+                // `count` is the number of exposures still to come for this window. Wait for the
+                // last one, so that the redraw sees the whole region.
+                if (expose->count == 0) {
+                    autk_x11_window_queue_redraw(window);
+                }
             }
             return AUTK_OK;
 
+#if AUTK_X11_PRESENT
+        case XCB_GE_GENERIC:
+            // The display refreshed since we asked to be told. Let the next frame start.
+            generic = (const xcb_ge_generic_event_t *)event;
+            if (client_data->present_opcode && generic->extension == client_data->present_opcode
+                && generic->event_type == XCB_PRESENT_COMPLETE_NOTIFY
+                && ((const xcb_present_complete_notify_event_t *)event)->serial
+                       == client_data->present_serial) {
+                autk_frame_clock_vsync(&client->frame_clock, autk_monotonic_time_ns());
+            }
+            return AUTK_OK;
+#endif
+
         default:
             return AUTK_OK;
     }
@@ -325,6 +370,124 @@ create_default_colormap(autk_x11_client_data_t *client_data)
     client_data->default_colormap = colormap;
 }
 
+#if AUTK_X11_PRESENT
+static void
+init_present(autk_x11_client_data_t *client_data)
+{
+    const xcb_query_extension_reply_t *extension;
+    xcb_present_query_version_reply_t *reply;
+
+    extension = xcb_get_extension_data(client_data->connection, &xcb_present_id);
+    if (!extension || !extension->present) {
+        return;
+    }
+
+    reply = xcb_present_query_version_reply(
+        client_data->connection,
+        xcb_present_query_version(client_data->connection, XCB_PRESENT_MAJOR_VERSION,
+                                  XCB_PRESENT_MINOR_VERSION),
+        NULL);
+    if (!reply) {
+        return;
+    }
+    free(reply);
+
+    client_data->present_opcode = extension->major_opcode;
+}
+#endif
+
+#if AUTK_X11_RANDR
+// Returns the refresh interval of a mode, in nanoseconds, or 0 if it's unknown.
+static uint64_t
+get_mode_interval(const xcb_randr_mode_info_t *mode)
+{
+    uint64_t line_count = mode->vtotal;
+
+    if (mode->mode_flags & XCB_RANDR_MODE_FLAG_DOUBLE_SCAN) {
+        line_count *= 2;
+    }
+    if (mode->mode_flags & XCB_RANDR_MODE_FLAG_INTERLACE) {
+        line_count /= 2;
+    }
+    if (!mode->dot_clock || !mode->htotal || !line_count) {
+        return 0;
+    }
+
+    return (uint64_t)mode->htotal * line_count * 1000000000u / mode->dot_clock;
+}
+
+// Returns the refresh interval of the fastest active CRTC, in nanoseconds, or 0 if RandR 1.3 isn't
+// available. Windows can move between monitors, so pacing for the fastest one never holds any of
+// them back.
+static uint64_t
+query_refresh_interval(autk_x11_client_data_t *client_data)
+{
+    xcb_connection_t *connection = client_data->connection;
+    const xcb_query_extension_reply_t *extension;
+    xcb_randr_query_version_reply_t *version;
+    xcb_randr_get_screen_resources_current_reply_t *resources;
+    xcb_randr_get_crtc_info_reply_t *crtc_info;
+    const xcb_randr_crtc_t *crtcs;
+    const xcb_randr_mode_info_t *modes;
+    int crtc_count;
+    int mode_count;
+    uint64_t interval;
+    uint64_t best = 0;
+
+    extension = xcb_get_extension_data(connection, &xcb_randr_id);
+    if (!extension || !extension->present) {
+        return 0;
+    }
+
+    version = xcb_randr_query_version_reply(connection, xcb_randr_query_version(connection, 1, 3),
+                                            NULL);
+    if (!version) {
+        return 0;
+    } else if (version->major_version < 1
+               || (version->major_version == 1 && version->minor_version < 3)) {
+        free(version);
+        return 0;
+    }
+    free(version);
+
+    resources = xcb_randr_get_screen_resources_current_reply(
+        connection,
+        xcb_randr_get_screen_resources_current(connection, client_data->default_screen->root),
+        NULL);
+    if (!resources) {
+        return 0;
+    }
+
+    crtcs = xcb_randr_get_screen_resources_current_crtcs(resources);
+    crtc_count = xcb_randr_get_screen_resources_current_crtcs_length(resources);
+    modes = xcb_randr_get_screen_resources_current_modes(resources);
+    mode_count = xcb_randr_get_screen_resources_current_modes_length(resources);
+
+    for (int i = 0; i < crtc_count; i++) {
+        crtc_info = xcb_randr_get_crtc_info_reply(
+            connection, xcb_randr_get_crtc_info(connection, crtcs[i], resources->config_timestamp),
+            NULL);
+        if (!crtc_info) {
+            continue;
+        }
+
+        for (int j = 0; crtc_info->mode != XCB_NONE && j < mode_count; j++) {
+            if (modes[j].id == crtc_info->mode) {
+                interval = get_mode_interval(&modes[j]);
+                if (interval && (!best || interval < best)) {
+                    best = interval;
+                }
+                break;
+            }
+        }
+        free(crtc_info);
+    }
+
+    free(resources);
+    return best;
+}
+#endif
+
 static autk_status_t
 autk_x11_client_init(autk_client_t *client, void *opaque_client_data,
                      const autk_client_create_params_t *params)
@@ -332,6 +495,10 @@ autk_x11_client_init(autk_client_t *client, void *opaque_client_data,
     autk_x11_client_data_t *client_data = opaque_client_data;
     autk_status_t status;
 
+    // Set up the watch set first, since it's cleaned up even if we fail to connect.
+    AUTK_TRY(autk_posix_fd_watch_set_init(&client_data->fd_watches, client->instance, 2));
+    AUTK_TRY(autk_tiler_init(&client_data->tiler, client->instance));
+
     // Connect to the X11 server.
     client_data->connection = xcb_connect(params->display_name, &client_data->default_screen_num);
     status = check_connection(client->instance, client_data);
@@ -346,8 +513,23 @@ autk_x11_client_init(autk_client_t *client, void *opaque_client_data,
     AUTK_TRY(choose_default_visual(client->instance, client_data));
     create_default_colormap(client_data);
     AUTK_TRY(intern_atoms(client->instance, client_data));
+    autk_x11_framebuffer_init_client(client, client_data);
+#if AUTK_X11_PRESENT
+    init_present(client_data);
+#endif
+#if AUTK_X11_RANDR
+    uint64_t refresh_interval = query_refresh_interval(client_data);
+
+    if (refresh_interval) {
+        autk_frame_clock_set_display_interval(&client->frame_clock, refresh_interval);
+    }
+#endif
     autk_x11_window_map_init(client->instance, &client_data->window_map);
-    AUTK_TRY(autk_posix_job_queue_init(&client_data->job_queue));
+    AUTK_TRY(autk_posix_job_queue_init(&client_data->job_queue, client->instance));
+#if AUTK_JOB_STATS
+    autk_histogram_init(&client_data->job_queue_latency);
+    autk_histogram_init(&client_data->job_exec_time);
+#endif
 
     return AUTK_OK;
 }
@@ -357,9 +539,12 @@ autk_x11_client_fini(autk_client_t *client, void *opaque_client_data)
 {
     autk_x11_client_data_t *client_data = opaque_client_data;
 
-    (void)client;
-
+    autk_x11_framebuffer_fini_client(client, client_data);
+    autk_tiler_fini(&client_data->tiler);
+    autk_posix_fd_watch_set_fini(&client_data->fd_watches);
     autk_posix_job_queue_fini(&client_data->job_queue);
+    free(client_data->pending_event);
+    client_data->pending_event = NULL;
     autk_x11_window_map_fini(&client_data->window_map);
 
     if (client_data->default_colormap) {
@@ -370,133 +555,405 @@ autk_x11_client_fini(autk_client_t *client, void *opaque_client_data)
     }
 }
 
+// Asks the X server to tell us when the display next refreshes, if it can.
+static void
+request_vsync(autk_client_t *client, autk_x11_client_data_t *client_data)
+{
+#if AUTK_X11_PRESENT
+    autk_x11_window_data_t *window_data = client_data->dirty_windows->driver_data;
+
+    if (!client_data->present_opcode || client->frame_clock.vsync_pending) {
+        return;
+    }
+
+    // Any of our windows will do. Present reports the refresh of whichever CRTC shows it.
+    xcb_present_notify_msc(client_data->connection, window_data->window_id,
+                           ++client_data->present_serial, 0, 1, 0);
+    autk_frame_clock_begin_vsync(&client->frame_clock);
+#else
+    (void)client;
+    (void)client_data;
+#endif
+}
+
+// Redraws every window in the dirty list, if the next frame is due.
 static void
-redraw_dirty_windows(autk_x11_client_data_t *client_data)
+redraw_dirty_windows(autk_client_t *client, autk_x11_client_data_t *client_data)
 {
-    autk_hash_iter_t iter;
-    autk_x11_window_map_node_t *node;
+    autk_window_t *window;
     autk_x11_window_data_t *window_data;
+    autk_bbox_t rects[AUTK_DAMAGE_MAX_RECTS];
     autk_dirty_region_t dirty_region;
+    autk_surface_t *surface;
+    autk_status_t status;
+    uint64_t now;
 
-    if (autk_hash_table_begin(&client_data->window_map.ht, &iter)) {
-        do {
-            node = autk_hash_table_get(&client_data->window_map.ht, iter);
-            window_data = node->window->driver_data;
-            if (autk_bbox_is_positive(&window_data->dirty_region)) {
-                if (node->window->callbacks && node->window->callbacks->redraw_requested) {
-                    // NOTE: We're not currently tracking partial regions.
-                    dirty_region = (autk_dirty_region_t){
-                        .full_bbox = window_data->dirty_region,
-                        .partial_bbox_count = 1,
-                        .partial_bboxes = &dirty_region.full_bbox,
-                    };
-                    node->window->callbacks->redraw_requested(node->window, node->window->user_data,
-                                                              &dirty_region);
-                }
-                window_data->dirty_region = (autk_bbox_t){0};
+    if (!client_data->dirty_windows) {
+        return;
+    }
+
+    // Hold the damage back until the next frame, so a flood of updates costs one redraw per frame.
+    now = autk_monotonic_time_ns();
+    if (!autk_frame_clock_is_due(&client->frame_clock, now)) {
+        request_vsync(client, client_data);
+        return;
+    }
+    autk_frame_clock_tick(&client->frame_clock, now);
+
+    // Take one window off the list at a time, since a callback may destroy other windows.
+    while ((window = client_data->dirty_windows)) {
+        window_data = window->driver_data;
+
+        // Draw into a back buffer if the window can be drawn client-side. If the server is still
+        // reading every buffer, try again once it releases one.
+        status = autk_x11_framebuffer_begin(window, &surface);
+        if (status == AUTK_ERR_WOULD_BLOCK) {
+            autk_x11_window_defer_redraw(window);
+            continue;
+        } else if (status != AUTK_OK) {
+            if (status != AUTK_ERR_UNSUPPORTED_FEATURE && status != AUTK_ERR_RESOURCE_LOST) {
+                AUTK_WARN(client->instance, "Failed to set up window back buffer: %s",
+                          autk_status_to_string(status));
             }
-        } while (autk_hash_table_next(&client_data->window_map.ht, &iter));
+            surface = NULL;
+        }
+
+        // Copy the region out, since the callback may damage the window again.
+        for (uint32_t i = 0; i < window_data->damage.rect_count; i++) {
+            rects[i] = window_data->damage.rects[i];
+        }
+        dirty_region = (autk_dirty_region_t){
+            .full_bbox = window_data->damage.bounds,
+            .partial_bbox_count = window_data->damage.rect_count,
+            .partial_bboxes = rects,
+        };
+        autk_x11_window_clear_dirty_region(window);
+
+        // Record what the callback draws, to be drawn a tile at a time afterwards. If that can't
+        // be set up, the callback draws directly.
+        if (surface) {
+            autk_surface_set_clip(surface, &dirty_region.full_bbox);
+            autk_tiler_begin(&client_data->tiler, surface, rects,
+                             (uint32_t)dirty_region.partial_bbox_count);
+        }
+        window_data->drawing_surface = surface;
+        window_data->surface_used = false;
+        client_data->drawing_window = window;
+
+        if (window->callbacks && window->callbacks->redraw_requested) {
+            window->callbacks->redraw_requested(window, window->user_data, &dirty_region);
+        }
+
+        // The callback may have destroyed the window.
+        if (client_data->drawing_window != window) {
+            continue;
+        }
+        client_data->drawing_window = NULL;
+        window_data->drawing_surface = NULL;
+
+        // Show what was drawn, if anything.
+        if (surface) {
+            autk_tiler_end(&client_data->tiler);
+            autk_surface_set_clip(surface, NULL);
+            if (window_data->surface_used) {
+                autk_x11_framebuffer_present(window, rects,
+                                             (uint32_t)dirty_region.partial_bbox_count);
+            }
+        }
     }
 }
 
+// Runs jobs in bounded batches so that a steady stream of them can't starve X11 events. Anything
+// left over keeps the next wait from blocking.
 static autk_status_t
-autk_x11_client_run(autk_client_t *client, void *opaque_client_data)
+run_jobs(autk_client_t *client, autk_x11_client_data_t *client_data)
 {
-    autk_x11_client_data_t *client_data = opaque_client_data;
     autk_status_t status;
-    autk_job_t job;
-    int queue_result;
-    int display_result;
-    xcb_generic_event_t *event;
+    autk_job_queue_item_t item;
 
-    client_data->quit_requested = false;
+    for (size_t i = 0; i < JOB_BATCH_MAX && !client_data->quit_requested; i++) {
+        status = autk_posix_job_queue_try_pop(&client_data->job_queue, &item);
+        if (status == AUTK_ERR_QUEUE_EMPTY || status == AUTK_ERR_TRY_AGAIN) {
+            break;
+        } else if (status != AUTK_OK) {
+            return status;
+        }
 
-    while (!client_data->quit_requested) {
-        // Execute all pending jobs before doing anything else.
-        status = autk_posix_job_queue_try_pop(&client_data->job_queue, &job, client->instance);
-        switch (status) {
-            case AUTK_OK:
-                if (job.exec) {
-                    job.exec(job.ctx, client);
-                }
-                if (job.fini) {
-                    job.fini(job.ctx);
-                }
-                continue;
-            case AUTK_ERR_QUEUE_EMPTY:
-            case AUTK_ERR_TRY_AGAIN:
-                break;
-            default:
-                return status;
+#if AUTK_JOB_STATS
+        uint64_t exec_start_ns = autk_monotonic_time_ns();
+
+        autk_histogram_record(&client_data->job_queue_latency, exec_start_ns - item.post_time_ns);
+#endif
+        if (item.job.exec) {
+            item.job.exec(item.job.ctx, client);
         }
+        if (item.job.fini) {
+            item.job.fini(item.job.ctx);
+        }
+#if AUTK_JOB_STATS
+        autk_histogram_record(&client_data->job_exec_time,
+                              autk_monotonic_time_ns() - exec_start_ns);
+#endif
+        autk_posix_job_queue_release(&client_data->job_queue, &item);
+    }
 
-        // Flush all pending X11 requests and check the connection.
-        xcb_flush(client_data->connection);
-        status = check_connection(client->instance, client_data);
-        if (status != AUTK_OK) {
+    return AUTK_OK;
+}
+
+static autk_status_t
+handle_xcb_events(autk_client_t *client, autk_x11_client_data_t *client_data)
+{
+    autk_status_t status;
+    xcb_generic_event_t *event = client_data->pending_event;
+
+    client_data->pending_event = NULL;
+    if (!event) {
+        event = xcb_poll_for_event(client_data->connection);
+    }
+
+    while (event) {
+        status = handle_xcb_event(client, client_data, event);
+        free(event);
+        if (status != AUTK_OK || client_data->quit_requested) {
             return status;
         }
+        event = xcb_poll_for_event(client_data->connection);
+    }
 
-        // Handle any available X11 events.
-        while ((event = xcb_poll_for_event(client_data->connection)) != NULL) {
-            status = handle_xcb_event(client, client_data, event);
-            free(event);
-            if (status != AUTK_OK) {
-                return status;
-            }
-            if (client_data->quit_requested) {
-                return AUTK_OK;
-            }
-        }
+    return AUTK_OK;
+}
 
-        // Notify the application that we've processed all pending events and jobs,
-        // so it can perform any necessary idle work.
-        if (client->callbacks && client->callbacks->begin_wait) {
-            client->callbacks->begin_wait(client, client->user_data);
-        }
+// Does one pass over everything that's ready: jobs, timers, X11 events, the idle callback, and
+// redraws. Stops early if a quit is requested.
+static autk_status_t
+dispatch_pending(autk_client_t *client, autk_x11_client_data_t *client_data)
+{
+    AUTK_TRY(run_jobs(client, client_data));
+    if (client_data->quit_requested) {
+        return AUTK_OK;
+    }
 
-        redraw_dirty_windows(client_data);
+    // Run any timers that are due.
+    autk_timer_heap_run(&client->timers, client, autk_monotonic_time_ns());
+    if (client_data->quit_requested) {
+        return AUTK_OK;
+    }
 
-        // Block until either a new job is posted or an X11 event is available.
-        status = autk_posix_job_queue_poll(&client_data->job_queue, client_data->display_fd, -1,
-                                           &queue_result, &display_result);
-        switch (status) {
-            case AUTK_OK:
-                break;
-            case AUTK_ERR_INTERRUPTED:
-                continue;
-            default:
-                return status;
+    // Flush all pending X11 requests and check the connection.
+    xcb_flush(client_data->connection);
+    AUTK_TRY(check_connection(client->instance, client_data));
+
+    // Handle any available X11 events.
+    AUTK_TRY(handle_xcb_events(client, client_data));
+    if (client_data->quit_requested) {
+        return AUTK_OK;
+    }
+
+    // Notify the application that we've processed all pending events and jobs,
+    // so it can perform any necessary idle work.
+    if (client->callbacks && client->callbacks->begin_wait) {
+        client->callbacks->begin_wait(client, client->user_data);
+    }
+
+    redraw_dirty_windows(client, client_data);
+
+    // No callbacks are running now, so it's safe to give back memory from closed windows.
+    autk_x11_window_map_trim(&client_data->window_map);
+
+    // Redrawing may have queued requests of its own.
+    xcb_flush(client_data->connection);
+    return AUTK_OK;
+}
+
+// Returns how long the loop may sleep, given a caller-imposed limit (-1 for none): until the next
+// timer or frame is due, or not at all if XCB already read an event off the socket, since the
+// display fd won't become readable for it.
+static int
+wait_timeout(autk_client_t *client, autk_x11_client_data_t *client_data, int timeout)
+{
+    uint64_t now = autk_monotonic_time_ns();
+    int timer_timeout = autk_timer_heap_timeout_ms(&client->timers, now);
+    int frame_timeout;
+
+    if (timer_timeout >= 0 && (timeout < 0 || timer_timeout < timeout)) {
+        timeout = timer_timeout;
+    }
+
+    if (client_data->dirty_windows) {
+        frame_timeout = autk_frame_clock_timeout_ms(&client->frame_clock, now);
+        if (timeout < 0 || frame_timeout < timeout) {
+            timeout = frame_timeout;
         }
+    }
 
-        if (queue_result == -1 || display_result == -1) {
-            return AUTK_ERR_IO_FAILURE;
+    if (!client_data->pending_event) {
+        client_data->pending_event = xcb_poll_for_queued_event(client_data->connection);
+    }
+    if (client_data->pending_event) {
+        timeout = 0;
+    }
+
+    return timeout;
+}
+
+// Blocks until a new job is posted, an X11 event is available, a watched fd is ready, the next
+// timer is due, or `timeout` milliseconds pass. Runs the callbacks of any ready fd watches.
+static autk_status_t
+wait_for_work(autk_client_t *client, autk_x11_client_data_t *client_data, int timeout)
+{
+    struct pollfd *poll_fds;
+    size_t poll_fd_count;
+    autk_status_t status;
+    int queue_result;
+
+    timeout = wait_timeout(client, client_data, timeout);
+    poll_fds = autk_posix_fd_watch_set_get_poll_fds(&client_data->fd_watches, &poll_fd_count);
+    poll_fds[1] = (struct pollfd){.fd = client_data->display_fd, .events = POLLIN};
+    status = autk_posix_job_queue_poll(&client_data->job_queue, poll_fds, poll_fd_count, timeout,
+                                       &queue_result);
+    switch (status) {
+        case AUTK_OK:
+            break;
+        case AUTK_ERR_INTERRUPTED:
+        case AUTK_ERR_TIMEOUT:
+            return AUTK_OK;
+        default:
+            return status;
+    }
+
+    if (queue_result == -1 || (poll_fds[1].revents & (POLLERR | POLLHUP | POLLNVAL))) {
+        return AUTK_ERR_IO_FAILURE;
+    }
+
+    autk_posix_fd_watch_set_dispatch(&client_data->fd_watches, client);
+    return AUTK_OK;
+}
+
+static autk_status_t
+autk_x11_client_run(autk_client_t *client, void *opaque_client_data)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+
+    client_data->quit_requested = false;
+
+    for (;;) {
+        AUTK_TRY(dispatch_pending(client, client_data));
+        if (client_data->quit_requested) {
+            return AUTK_OK;
         }
+        AUTK_TRY(wait_for_work(client, client_data, -1));
     }
+}
+
+static autk_status_t
+autk_x11_client_dispatch(autk_client_t *client, void *opaque_client_data, int timeout)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
 
+    AUTK_TRY(wait_for_work(client, client_data, timeout));
+    AUTK_TRY(dispatch_pending(client, client_data));
+
+    if (client_data->quit_requested) {
+        client_data->quit_requested = false;
+        return AUTK_ERR_INTERRUPTED;
+    }
+
+    return AUTK_OK;
+}
+
+static autk_status_t
+autk_x11_client_get_wait_fds(autk_client_t *client, void *opaque_client_data,
+                             autk_client_wait_fds_t *out_wait_fds)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+    int timeout = wait_timeout(client, client_data, -1);
+
+    // From here on, producers will signal the wakeup fd.
+    if (autk_posix_job_queue_begin_wait(&client_data->job_queue)) {
+        timeout = 0;
+    }
+
+    out_wait_fds->display_fd = client_data->display_fd;
+    out_wait_fds->wakeup_fd = client_data->job_queue.wakeup_read_fd;
+    out_wait_fds->watch_fd = autk_posix_fd_watch_set_get_fd(&client_data->fd_watches);
+    out_wait_fds->timeout_ms = timeout;
     return AUTK_OK;
 }
 
 static autk_status_t
-autk_x11_client_post_job(autk_client_t *client, void *opaque_client_data, autk_job_t job)
+autk_x11_client_watch_fd(autk_client_t *client, void *opaque_client_data,
+                         const autk_fd_watch_params_t *params)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+
+    (void)client;
+
+    return autk_posix_fd_watch_set_add(&client_data->fd_watches, params);
+}
+
+static autk_status_t
+autk_x11_client_unwatch_fd(autk_client_t *client, void *opaque_client_data, int fd)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+
+    (void)client;
+
+    return autk_posix_fd_watch_set_remove(&client_data->fd_watches, fd);
+}
+
+static autk_status_t
+autk_x11_client_post_jobs(autk_client_t *client, void *opaque_client_data, const autk_job_t *jobs,
+                          size_t job_count)
 {
     autk_x11_client_data_t *client_data = opaque_client_data;
     autk_status_t status;
-    bool queued;
+    size_t queued_count;
 
     (void)client;
 
-    status = autk_posix_job_queue_push(&client_data->job_queue, job, &queued);
-    if (status != AUTK_OK) {
-        if (!queued && job.fini) {
-            job.fini(job.ctx);
+    status = autk_posix_job_queue_push(&client_data->job_queue, jobs, job_count, &queued_count);
+    for (size_t i = queued_count; i < job_count; i++) {
+        if (jobs[i].fini) {
+            jobs[i].fini(jobs[i].ctx);
         }
-        return status;
     }
 
-    return AUTK_OK;
+    return status;
 }
 
+static autk_status_t
+autk_x11_client_post_job_data(autk_client_t *client, void *opaque_client_data,
+                              const autk_job_t *job, const void *data, size_t data_size)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+    autk_status_t status;
+    bool queued;
+
+    (void)client;
+
+    status = autk_posix_job_queue_push_data(&client_data->job_queue, job, data, data_size, &queued);
+    if (!queued && job->fini) {
+        job->fini((void *)data);
+    }
+
+    return status;
+}
+
+#if AUTK_JOB_STATS
+static void
+autk_x11_client_get_stats(autk_client_t *client, void *opaque_client_data,
+                          autk_client_stats_t *out_stats)
+{
+    autk_x11_client_data_t *client_data = opaque_client_data;
+
+    (void)client;
+
+    autk_histogram_summarize(&client_data->job_queue_latency, &out_stats->job_queue_latency);
+    autk_histogram_summarize(&client_data->job_exec_time, &out_stats->job_exec_time);
+    autk_job_queue_get_stats(&client_data->job_queue.queue, out_stats);
+}
+#endif
+
 static void
 quit_job(void *ctx, autk_client_t *client)
 {
@@ -512,22 +969,33 @@ quit_job(void *ctx, autk_client_t *client)
 static autk_status_t
 autk_x11_client_quit(autk_client_t *client, void *opaque_client_data)
 {
-    return autk_x11_client_post_job(client, opaque_client_data,
-                                    (autk_job_t){
-                                        .exec = quit_job,
-                                    });
+    static const autk_job_t job = {
+        .exec = quit_job,
+    };
+
+    return autk_x11_client_post_jobs(client, opaque_client_data, &job, 1);
 }
 
 AUTK_API const autk_client_driver_t autk_client_driver_x11 = {
     .struct_size = sizeof(autk_client_driver_t),
     .driver_data_size = sizeof(autk_x11_client_data_t),
 
+    .device_driver = &autk_device_driver_raster,
     .window_driver = &autk_window_driver_x11,
 
     .init = autk_x11_client_init,
     .fini = autk_x11_client_fini,
     .run = autk_x11_client_run,
     .quit = autk_x11_client_quit,
+    .dispatch = autk_x11_client_dispatch,
+    .get_wait_fds = autk_x11_client_get_wait_fds,
+    .watch_fd = autk_x11_client_watch_fd,
+    .unwatch_fd = autk_x11_client_unwatch_fd,
+    .post_jobs = autk_x11_client_post_jobs,
+    .post_job_data = autk_x11_client_post_job_data,
+#if AUTK_JOB_STATS
+    .get_stats = autk_x11_client_get_stats,
+#endif
 };
 
 //==============================================================================
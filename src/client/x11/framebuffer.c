@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#define _XOPEN_SOURCE 600 // for System V shared memory
+
+#if AUTK_X11_SHM
+# include <sys/ipc.h>
+# include <sys/shm.h>
+#endif
+
+#include <string.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <autk/math.h>
+#include <autk/surface.h>
+#include <utility/math.h>
+
+#include "framebuffer.h"
+#include "window.h"
+
+// Most image data sent in one PutImage request. Bands smaller than the server's limit let other
+// requests through sooner, and bound the staging buffer.
+#define PUT_IMAGE_BAND_SIZE_MAX (256 * 1024)
+
+// Room for a PutImage request's header, including the length field BIG-REQUESTS adds.
+#define PUT_IMAGE_HEADER_SIZE (sizeof(xcb_put_image_request_t) + 4)
+
+//==============================================================================
+//
+// Buffers
+//
+//==============================================================================
+
+#if AUTK_X11_SHM
+// Allocates the buffer's pixels in shared memory attached to the server. Fails if the server can't
+// attach it, e.g. because it's on another machine, in which case SHM isn't tried again.
+static autk_status_t
+alloc_shm_pixels(autk_window_t *window, autk_x11_buffer_t *buffer)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    xcb_generic_error_t *error;
+    uint32_t shm_seg;
+    void *pixels;
+    int shm_id;
+
+    shm_id = shmget(IPC_PRIVATE, buffer->size, IPC_CREAT | 0600);
+    if (shm_id < 0) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    pixels = shmat(shm_id, NULL, 0);
+    if (pixels == (void *)-1) {
+        shmctl(shm_id, IPC_RMID, NULL);
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    shm_seg = xcb_generate_id(client_data->connection);
+    error = xcb_request_check(client_data->connection,
+                              xcb_shm_attach_checked(client_data->connection, shm_seg,
+                                                     (uint32_t)shm_id, 0));
+
+    // The segment is destroyed once both sides detach from it, even if we crash.
+    shmctl(shm_id, IPC_RMID, NULL);
+
+    if (error) {
+        free(error);
+        shmdt(pixels);
+        AUTK_DEBUG(window->instance, "MIT-SHM attach failed, falling back to PutImage");
+        client_data->shm_attach_failed = true;
+        return AUTK_ERR_REQUEST_DENIED;
+    }
+
+    buffer->pixels = pixels;
+    buffer->shm_seg = shm_seg;
+    return AUTK_OK;
+}
+#endif
+
+static autk_status_t
+alloc_buffer(autk_window_t *window, autk_x11_buffer_t *buffer, uint32_t width, uint32_t height)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    autk_status_t status = AUTK_ERR_UNSUPPORTED_FEATURE;
+    autk_surface_create_params_t surface_params;
+
+    // Width and height come from 16-bit protocol fields, so this only overflows on 32-bit systems.
+    if (height > SIZE_MAX / 4 / width) {
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
+    }
+    buffer->size = (size_t)width * height * 4;
+
+#if AUTK_X11_SHM
+    if (client_data->shm_completion_event && !client_data->shm_attach_failed) {
+        status = alloc_shm_pixels(window, buffer);
+    }
+#else
+    (void)client_data;
+#endif
+    if (status != AUTK_OK) {
+        buffer->pixels =
+            autk_instance_alloc(window->instance, NULL, 0, buffer->size, AUTK_MEMORY_TAG_SURFACE);
+        if (!buffer->pixels) {
+            return AUTK_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    surface_params = (autk_surface_create_params_t){
+        .struct_size = sizeof(autk_surface_create_params_t),
+        .width = width,
+        .height = height,
+        .pixels = buffer->pixels,
+        .stride = (size_t)width * 4,
+    };
+    return autk_surface_create(window->client->device, &surface_params, &buffer->surface);
+}
+
+static void
+free_buffer(autk_window_t *window, autk_x11_buffer_t *buffer)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+
+    autk_surface_destroy(buffer->surface);
+
+    // The server keeps its own mapping of a shared segment, so it's safe to let go of ours while
+    // the server is still reading it. The detach request is handled after any earlier uploads.
+#if AUTK_X11_SHM
+    if (buffer->shm_seg) {
+        xcb_shm_detach(window_data->connection, buffer->shm_seg);
+        shmdt(buffer->pixels);
+    } else
+#endif
+    if (buffer->pixels) {
+        autk_instance_alloc(window->instance, buffer->pixels, buffer->size, 0,
+                            AUTK_MEMORY_TAG_SURFACE);
+    }
+    (void)window_data;
+
+    *buffer = (autk_x11_buffer_t){0};
+}
+
+static void
+free_buffers(autk_window_t *window)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_framebuffer_t *framebuffer = &window_data->framebuffer;
+
+    for (uint32_t i = 0; i < AUTK_LENGTHOF(framebuffer->buffers); i++) {
+        free_buffer(window, &framebuffer->buffers[i]);
+    }
+    framebuffer->buffer_count = 0;
+    framebuffer->back = 0;
+    autk_damage_clear(&framebuffer->stale);
+}
+
+//==============================================================================
+//
+// Uploads
+//
+//==============================================================================
+
+#if AUTK_X11_SHM
+// Has the server copy `rects` out of a shared buffer. Only the last copy asks for a completion
+// event, which tells us the server is done reading the buffer.
+static void
+shm_put_image_rects(autk_window_t *window, autk_x11_buffer_t *buffer, const autk_bbox_t *rects,
+                    uint32_t rect_count)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_framebuffer_t *framebuffer = &window_data->framebuffer;
+
+    for (uint32_t i = 0; i < rect_count; i++) {
+        xcb_shm_put_image(window_data->connection, window_data->window_id, framebuffer->gc,
+                          (uint16_t)framebuffer->width, (uint16_t)framebuffer->height,
+                          (uint16_t)rects[i].x0, (uint16_t)rects[i].y0,
+                          (uint16_t)(rects[i].x1 - rects[i].x0),
+                          (uint16_t)(rects[i].y1 - rects[i].y0), (int16_t)rects[i].x0,
+                          (int16_t)rects[i].y0, client_data->default_depth,
+                          XCB_IMAGE_FORMAT_Z_PIXMAP, i == rect_count - 1, buffer->shm_seg, 0);
+    }
+    buffer->busy = true;
+}
+#endif
+
+static void
+put_image(autk_window_t *window, autk_bbox_t bbox, const uint8_t *data)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    autk_x11_window_data_t *window_data = window->driver_data;
+    uint32_t width = (uint32_t)(bbox.x1 - bbox.x0);
+    uint32_t height = (uint32_t)(bbox.y1 - bbox.y0);
+
+    xcb_put_image(window_data->connection, XCB_IMAGE_FORMAT_Z_PIXMAP, window_data->window_id,
+                  window_data->framebuffer.gc, (uint16_t)width, (uint16_t)height,
+                  (int16_t)bbox.x0, (int16_t)bbox.y0, 0, client_data->default_depth,
+                  width * height * 4, data);
+}
+
+// Uploads `rect` of a buffer without shared memory, in bands of rows that each fit in a request.
+// Unless the rect spans the whole buffer, its rows aren't contiguous, so each band is packed into
+// a staging buffer first. That way, only damaged pixels go over the wire.
+static void
+put_image_rect(autk_window_t *window, const autk_x11_buffer_t *buffer, autk_bbox_t rect)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    autk_x11_window_data_t *window_data = window->driver_data;
+    size_t stride = (size_t)window_data->framebuffer.width * 4;
+    size_t row_size = (size_t)(rect.x1 - rect.x0) * 4;
+    size_t band_size = client_data->put_image_band_size;
+    const uint8_t *src;
+    uint32_t band_rows;
+    int32_t piece_width;
+    autk_bbox_t band;
+
+    if (row_size != stride && !client_data->put_image_staging) {
+        client_data->put_image_staging = autk_instance_alloc(window->instance, NULL, 0, band_size,
+                                                             AUTK_MEMORY_TAG_SURFACE);
+    }
+
+    // Send rows one at a time if they can't be packed, and in pieces if one doesn't fit in a
+    // request. Each piece is contiguous.
+    if (row_size > band_size || (row_size != stride && !client_data->put_image_staging)) {
+        piece_width = (int32_t)(band_size / 4);
+        for (int32_t y = rect.y0; y < rect.y1; y++) {
+            for (int32_t x = rect.x0; x < rect.x1; x += piece_width) {
+                band = (autk_bbox_t){x, y, autk_int32_min(x + piece_width, rect.x1), y + 1};
+                put_image(window, band,
+                          (const uint8_t *)buffer->pixels + (size_t)y * stride + (size_t)x * 4);
+            }
+        }
+        return;
+    }
+
+    band_rows = (uint32_t)(band_size / row_size);
+    for (int32_t y = rect.y0; y < rect.y1; y = band.y1) {
+        band = (autk_bbox_t){rect.x0, y, rect.x1,
+                             (int32_t)autk_int64_min((int64_t)y + band_rows, rect.y1)};
+        src = (const uint8_t *)buffer->pixels + (size_t)y * stride + (size_t)rect.x0 * 4;
+        if (row_size != stride) {
+            for (int32_t row = 0; row < band.y1 - band.y0; row++) {
+                memcpy((uint8_t *)client_data->put_image_staging + (size_t)row * row_size,
+                       src + (size_t)row * stride, row_size);
+            }
+            src = client_data->put_image_staging;
+        }
+        put_image(window, band, src);
+    }
+}
+
+//==============================================================================
+//
+// Internal API
+//
+//==============================================================================
+
+AUTK_HIDDEN void
+autk_x11_framebuffer_init_client(autk_client_t *client, autk_x11_client_data_t *client_data)
+{
+    static const uint16_t byte_order_probe = 1;
+    const xcb_setup_t *setup = xcb_get_setup(client_data->connection);
+    uint8_t host_byte_order = *(const uint8_t *)&byte_order_probe ? XCB_IMAGE_ORDER_LSB_FIRST
+                                                                   : XCB_IMAGE_ORDER_MSB_FIRST;
+    xcb_format_iterator_t format_iter;
+    size_t max_request_size;
+
+    // Surfaces hold native-endian 0xAARRGGBB pixels, which the server must take as they are.
+    client_data->framebuffer_supported = false;
+    if (client_data->color_shift.r != 16 || client_data->color_shift.g != 8
+        || client_data->color_shift.b != 0 || setup->image_byte_order != host_byte_order)
+    {
+        AUTK_DEBUG(client->instance, "Default visual doesn't match surface pixels");
+        return;
+    }
+    format_iter = xcb_setup_pixmap_formats_iterator(setup);
+    for (; format_iter.rem > 0; xcb_format_next(&format_iter)) {
+        if (format_iter.data->depth == client_data->default_depth) {
+            client_data->framebuffer_supported = format_iter.data->bits_per_pixel == 32;
+            break;
+        }
+    }
+    if (!client_data->framebuffer_supported) {
+        AUTK_DEBUG(client->instance, "Default depth doesn't use 32-bit pixels");
+        return;
+    }
+
+    // Uploads without shared memory are split to fit the server's request limit. Asking for the
+    // limit enables BIG-REQUESTS if the server has it, which raises the limit from 256 KiB.
+    max_request_size = (size_t)xcb_get_maximum_request_length(client_data->connection) * 4;
+    client_data->put_image_band_size =
+        autk_size_min(max_request_size - PUT_IMAGE_HEADER_SIZE, PUT_IMAGE_BAND_SIZE_MAX);
+    client_data->put_image_band_size &= ~(size_t)3; // whole pixels
+
+#if AUTK_X11_SHM
+    const xcb_query_extension_reply_t *extension;
+    xcb_shm_query_version_reply_t *reply;
+
+    extension = xcb_get_extension_data(client_data->connection, &xcb_shm_id);
+    if (!extension || !extension->present) {
+        return;
+    }
+
+    reply = xcb_shm_query_version_reply(client_data->connection,
+                                        xcb_shm_query_version(client_data->connection), NULL);
+    if (!reply) {
+        return;
+    }
+    free(reply);
+
+    client_data->shm_completion_event = extension->first_event + XCB_SHM_COMPLETION;
+#endif
+}
+
+AUTK_HIDDEN void
+autk_x11_framebuffer_fini_client(autk_client_t *client, autk_x11_client_data_t *client_data)
+{
+    if (client_data->put_image_staging) {
+        autk_instance_alloc(client->instance, client_data->put_image_staging,
+                            client_data->put_image_band_size, 0, AUTK_MEMORY_TAG_SURFACE);
+        client_data->put_image_staging = NULL;
+    }
+}
+
+AUTK_HIDDEN void
+autk_x11_framebuffer_fini(autk_window_t *window)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_framebuffer_t *framebuffer = &window_data->framebuffer;
+
+    free_buffers(window);
+    if (framebuffer->gc) {
+        xcb_free_gc(window_data->connection, framebuffer->gc);
+    }
+    framebuffer->gc = 0;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_x11_framebuffer_begin(autk_window_t *window, autk_surface_t **out_surface)
+{
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_framebuffer_t *framebuffer = &window_data->framebuffer;
+    autk_x11_buffer_t *back;
+    autk_x11_buffer_t *front;
+    autk_bbox_t bounds;
+    autk_status_t status;
+
+    if (!client_data->framebuffer_supported) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    } else if (!window_data->window_id) {
+        return AUTK_ERR_RESOURCE_LOST;
+    }
+
+    // Start over when the window's size changes. The server exposes all of it afterwards, so
+    // nothing of the old contents is needed.
+    if (framebuffer->width != window_data->width || framebuffer->height != window_data->height) {
+        free_buffers(window);
+        framebuffer->width = window_data->width;
+        framebuffer->height = window_data->height;
+    }
+    bounds = (autk_bbox_t){0, 0, (int32_t)framebuffer->width, (int32_t)framebuffer->height};
+
+    if (!framebuffer->gc) {
+        framebuffer->gc = xcb_generate_id(window_data->connection);
+        xcb_create_gc(window_data->connection, framebuffer->gc, window_data->window_id, 0, NULL);
+    }
+
+    back = &framebuffer->buffers[framebuffer->back];
+    front = framebuffer->buffer_count == 2 ? &framebuffer->buffers[framebuffer->back ^ 1] : NULL;
+    if (back->busy) {
+        return AUTK_ERR_WOULD_BLOCK;
+    }
+
+    if (!back->surface) {
+        status = alloc_buffer(window, back, framebuffer->width, framebuffer->height);
+        if (status != AUTK_OK) {
+            free_buffer(window, back);
+            return status;
+        }
+
+        // Double buffering only pays off if the server reads the pixels after PutImage returns.
+        if (!framebuffer->buffer_count) {
+#if AUTK_X11_SHM
+            framebuffer->buffer_count = back->shm_seg ? 2 : 1;
+#else
+            framebuffer->buffer_count = 1;
+#endif
+        }
+
+        // A new buffer starts out as a copy of the other one, or as the window's background.
+        if (front && front->surface) {
+            autk_damage_clear(&framebuffer->stale);
+            autk_damage_add(&framebuffer->stale, bounds);
+        } else {
+            autk_surface_fill_rect(back->surface, &bounds, window->background_color);
+        }
+    }
+
+    // Bring the back buffer up to date with what was drawn into the front one since it was last
+    // drawn itself.
+    if (front && front->surface) {
+        for (uint32_t i = 0; i < framebuffer->stale.rect_count; i++) {
+            autk_surface_copy(back->surface, framebuffer->stale.rects[i].x0,
+                              framebuffer->stale.rects[i].y0, front->surface,
+                              &framebuffer->stale.rects[i]);
+        }
+    }
+    autk_damage_clear(&framebuffer->stale);
+
+    *out_surface = back->surface;
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_x11_framebuffer_present(autk_window_t *window, const autk_bbox_t *rects, uint32_t rect_count)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_framebuffer_t *framebuffer = &window_data->framebuffer;
+    autk_x11_buffer_t *back = &framebuffer->buffers[framebuffer->back];
+    autk_bbox_t bounds = {0, 0, (int32_t)framebuffer->width, (int32_t)framebuffer->height};
+    autk_bbox_t clipped[AUTK_DAMAGE_MAX_RECTS];
+    uint32_t count = 0;
+
+    if (!back->surface || !window_data->window_id) {
+        return;
+    }
+
+    // Only upload what's within the buffer.
+    for (uint32_t i = 0; i < rect_count && count < AUTK_LENGTHOF(clipped); i++) {
+        clipped[count] = (autk_bbox_t){
+            .x0 = autk_int32_max(rects[i].x0, bounds.x0),
+            .y0 = autk_int32_max(rects[i].y0, bounds.y0),
+            .x1 = autk_int32_min(rects[i].x1, bounds.x1),
+            .y1 = autk_int32_min(rects[i].y1, bounds.y1),
+        };
+        if (autk_bbox_is_positive(&clipped[count])) {
+            count++;
+        }
+    }
+    if (!count) {
+        return;
+    }
+
+#if AUTK_X11_SHM
+    if (back->shm_seg) {
+        shm_put_image_rects(window, back, clipped, count);
+    } else
+#endif
+    {
+        for (uint32_t i = 0; i < count; i++) {
+            put_image_rect(window, back, clipped[i]);
+        }
+    }
+
+    // The other buffer is now missing what was just drawn. Draw into it next.
+    if (framebuffer->buffer_count == 2) {
+        for (uint32_t i = 0; i < count; i++) {
+            autk_damage_add(&framebuffer->stale, clipped[i]);
+        }
+        framebuffer->back ^= 1;
+    }
+}
+
+AUTK_HIDDEN bool
+autk_x11_framebuffer_handle_event(autk_x11_client_data_t *client_data,
+                                  const xcb_generic_event_t *event)
+{
+#if AUTK_X11_SHM
+    const xcb_shm_completion_event_t *completion;
+    autk_window_t *window;
+    autk_x11_window_data_t *window_data;
+
+    if (!client_data->shm_completion_event
+        || (event->response_type & 0x7F) != client_data->shm_completion_event)
+    {
+        return false;
+    }
+
+    completion = (const xcb_shm_completion_event_t *)event;
+    window = autk_x11_window_map_get(&client_data->window_map, completion->drawable);
+    if (!window) {
+        return true;
+    }
+
+    window_data = window->driver_data;
+    for (uint32_t i = 0; i < AUTK_LENGTHOF(window_data->framebuffer.buffers); i++) {
+        if (window_data->framebuffer.buffers[i].shm_seg == completion->shmseg) {
+            window_data->framebuffer.buffers[i].busy = false;
+        }
+    }
+
+    // Pick up the redraw that was waiting on this buffer.
+    if (window_data->awaiting_buffer) {
+        window_data->awaiting_buffer = false;
+        autk_x11_window_queue_redraw(window);
+    }
+    return true;
+#else
+    (void)client_data;
+    (void)event;
+    return false;
+#endif
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_CLIENT_X11_FRAMEBUFFER_H_
+#define AUTK_CLIENT_X11_FRAMEBUFFER_H_
+
+#include "types.h"
+
+// Checks whether windows can be drawn client-side, and sets up MIT-SHM if it's available.
+AUTK_HIDDEN void
+autk_x11_framebuffer_init_client(autk_client_t *client, autk_x11_client_data_t *client_data);
+
+AUTK_HIDDEN void
+autk_x11_framebuffer_fini_client(autk_client_t *client, autk_x11_client_data_t *client_data);
+
+// Frees the window's back buffers. The window must still exist on the server, or have been
+// invalidated.
+AUTK_HIDDEN void
+autk_x11_framebuffer_fini(autk_window_t *window);
+
+// Returns the back buffer to draw the window's next frame into, brought up to date with the last
+// frame and sized to match the window. Returns `AUTK_ERR_WOULD_BLOCK` if the server is still
+// reading every buffer, in which case the window should be redrawn once one is released.
+AUTK_HIDDEN autk_status_t
+autk_x11_framebuffer_begin(autk_window_t *window, autk_surface_t **out_surface);
+
+// Uploads the parts of the back buffer drawn since `autk_x11_framebuffer_begin()`, and swaps
+// buffers if there are two.
+AUTK_HIDDEN void
+autk_x11_framebuffer_present(autk_window_t *window, const autk_bbox_t *rects, uint32_t rect_count);
+
+// Handles events about buffers being released. Returns false if the event isn't one of them.
+AUTK_HIDDEN bool
+autk_x11_framebuffer_handle_event(autk_x11_client_data_t *client_data,
+                                  const xcb_generic_event_t *event);
+
+#endif // AUTK_CLIENT_X11_FRAMEBUFFER_H_
@@ -19,15 +19,44 @@
 
 #include <xcb/xcb.h>
 
+// Optional extensions, detected by the build.
+#ifndef AUTK_X11_PRESENT
+# define AUTK_X11_PRESENT 0
+#endif
+#ifndef AUTK_X11_RANDR
+# define AUTK_X11_RANDR 0
+#endif
+#ifndef AUTK_X11_SHM
+# define AUTK_X11_SHM 0
+#endif
+
+#if AUTK_X11_PRESENT
+# include <xcb/present.h>
+#endif
+#if AUTK_X11_RANDR
+# include <xcb/randr.h>
+#endif
+#if AUTK_X11_SHM
+# include <xcb/shm.h>
+#endif
+
+#include <core/tiler.h>
 #include <core/types.h>
+#include <os/posix/fd_watch.h>
 #include <os/posix/job_queue.h>
+#include <utility/damage.h>
 #include <utility/hash.h>
+#include <utility/histogram.h>
 
 typedef struct autk_x11_atoms autk_x11_atoms_t;
+typedef struct autk_x11_buffer autk_x11_buffer_t;
 typedef struct autk_x11_client_data autk_x11_client_data_t;
+typedef struct autk_x11_framebuffer autk_x11_framebuffer_t;
 typedef struct autk_x11_window_data autk_x11_window_data_t;
 typedef struct autk_x11_window_map autk_x11_window_map_t;
-typedef struct autk_x11_window_map_node autk_x11_window_map_node_t;
+
+AUTK_DEFINE_HASH_TABLE(autk_x11_window_table, uint32_t, autk_window_t *, autk_hash_uint32,
+                       autk_hash_uint32_eq)
 
 struct autk_x11_atoms {
     /* clang-format off */
@@ -43,19 +72,44 @@ struct autk_x11_atoms {
 #undef AUTK_DO
 };
 
+// Pixels drawn by the client and uploaded to a window.
+struct autk_x11_buffer {
+    autk_surface_t *surface; // NULL until the buffer is first needed
+    void *pixels; // rows are exactly `width * 4` bytes apart, as the X server expects
+    size_t size;
+#if AUTK_X11_SHM
+    uint32_t shm_seg; // 0 if the pixels aren't shared with the server
+#endif
+    bool busy; // set while the server may still be reading the pixels
+};
+
+// A window's back buffers. With MIT-SHM, there are two, so one can be drawn while the server reads
+// the other. Otherwise, PutImage copies the pixels into the request, so one is enough.
+struct autk_x11_framebuffer {
+    autk_x11_buffer_t buffers[2];
+    uint32_t buffer_count;
+    uint32_t back; // index of the buffer to draw into next
+    uint32_t width, height; // size of the buffers
+    uint32_t gc;
+    autk_damage_t stale; // areas drawn into the other buffer since the back one was last drawn
+};
+
 struct autk_x11_window_data {
     xcb_connection_t *connection;
     uint32_t window_id;
-    autk_bbox_t dirty_region;
+    uint32_t width, height;
+    autk_damage_t damage; // exposed areas waiting to be redrawn
+    bool redraw_queued; // set while the window is in the client's dirty list
+    bool awaiting_buffer; // set while a redraw waits for the server to release a back buffer
+    autk_x11_framebuffer_t framebuffer;
+    autk_surface_t *drawing_surface; // back buffer being drawn, only set during redraw callbacks
+    bool surface_used; // set once the redraw callback asks for the drawing surface
+    autk_window_t *dirty_prev;
+    autk_window_t *dirty_next;
 };
 
 struct autk_x11_window_map {
-    autk_hash_table_t ht;
-};
-
-struct autk_x11_window_map_node {
-    uint32_t id;
-    autk_window_t *window;
+    autk_x11_window_table_t table;
 };
 
 struct autk_x11_client_data {
@@ -69,8 +123,28 @@ struct autk_x11_client_data {
     uint32_t default_colormap;
     autk_x11_atoms_t atoms;
     autk_x11_window_map_t window_map;
+    autk_window_t *dirty_windows; // head of the list of windows waiting to be redrawn
+    autk_window_t *drawing_window; // window whose redraw callback is running, if any
+    autk_tiler_t tiler; // records each redraw, then draws its damaged tiles in parallel
     autk_posix_job_queue_t job_queue;
+    autk_posix_fd_watch_set_t fd_watches; // reserves poll slots for the wakeup and display fds
+    xcb_generic_event_t *pending_event; // already read from the connection, but not handled yet
     bool quit_requested;
+    bool framebuffer_supported; // whether our pixel layout matches the default visual's
+    size_t put_image_band_size; // most image bytes sent in one PutImage request
+    void *put_image_staging; // `put_image_band_size` bytes for packing partial rows, or NULL
+#if AUTK_X11_SHM
+    uint8_t shm_completion_event; // response type of ShmCompletion, or 0 if SHM is unavailable
+    bool shm_attach_failed; // set once the server can't attach a segment, e.g. over the network
+#endif
+#if AUTK_X11_PRESENT
+    uint8_t present_opcode; // major opcode of the Present extension, or 0 if it's unavailable
+    uint32_t present_serial; // serial of the last refresh notification requested
+#endif
+#if AUTK_JOB_STATS
+    autk_histogram_t job_queue_latency;
+    autk_histogram_t job_exec_time;
+#endif
 };
 
 #endif // AUTK_CLIENT_X11_TYPES_H_
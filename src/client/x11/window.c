@@ -21,12 +21,14 @@
 #include <xcb/xcb.h>
 
 #include <autk/diagnostics.h>
+#include <autk/math.h>
 #include <autk/window.h>
 #include <utility/encoding.h>
 #include <utility/hash.h>
 #include <utility/math.h>
 
 #include "client.h"
+#include "framebuffer.h"
 #include "window.h"
 
 // wm_normal_hints_t flags
@@ -123,6 +125,8 @@ autk_x11_window_init(autk_window_t *window, void *opaque_driver_data,
         width = (uint16_t)autk_uint32_clamp(params->width, 1, UINT16_MAX);
         height = (uint16_t)autk_uint32_clamp(params->height, 1, UINT16_MAX);
     }
+    window_data->width = width;
+    window_data->height = height;
 
     // Set up the value list for window creation.
     value_list[value_list_index++] = XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_STRUCTURE_NOTIFY;
@@ -138,6 +142,15 @@ autk_x11_window_init(autk_window_t *window, void *opaque_driver_data,
                       XCB_WINDOW_CLASS_INPUT_OUTPUT, client_data->default_visual->visual_id,
                       value_list_mask, value_list);
 
+#if AUTK_X11_PRESENT
+    // Ask for the refresh notifications that pace the client's frames.
+    if (client_data->present_opcode) {
+        xcb_present_select_input(window_data->connection,
+                                 xcb_generate_id(window_data->connection),
+                                 window_data->window_id, XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY);
+    }
+#endif
+
     // Set post-creation properties.
     AUTK_TRY(set_wm_normal_hints(client_data, window_data, params));
     AUTK_TRY(set_wm_protocols(client_data, window_data));
@@ -158,6 +171,9 @@ autk_x11_window_fini(autk_window_t *window, void *opaque_driver_data)
     autk_x11_window_data_t *window_data = opaque_driver_data;
     autk_x11_client_data_t *client_data = window->client->driver_data;
 
+    // Free the back buffers before the window they're drawn with.
+    autk_x11_framebuffer_fini(window);
+
     if (window_data->window_id != 0) {
         // Send a destroy request.
         xcb_destroy_window(window_data->connection, window_data->window_id);
@@ -167,6 +183,13 @@ autk_x11_window_fini(autk_window_t *window, void *opaque_driver_data)
 
         window_data->window_id = 0;
     }
+
+    autk_x11_window_clear_dirty_region(window);
+
+    // The window may be destroyed from its own redraw callback.
+    if (client_data->drawing_window == window) {
+        client_data->drawing_window = NULL;
+    }
 }
 
 typedef struct {
@@ -267,6 +290,17 @@ autk_x11_window_set_visible(autk_window_t *window, void *opaque_driver_data, boo
     return AUTK_OK;
 }
 
+static autk_surface_t *
+autk_x11_window_get_surface(autk_window_t *window, void *opaque_driver_data)
+{
+    autk_x11_window_data_t *window_data = opaque_driver_data;
+
+    (void)window;
+
+    window_data->surface_used |= window_data->drawing_surface != NULL;
+    return window_data->drawing_surface;
+}
+
 AUTK_HIDDEN const autk_window_driver_t autk_window_driver_x11 = {
     .struct_size = sizeof(autk_window_driver_t),
     .driver_data_size = sizeof(autk_x11_window_data_t),
@@ -277,6 +311,7 @@ AUTK_HIDDEN const autk_window_driver_t autk_window_driver_x11 = {
     .set_background_color = &autk_x11_window_set_background_color,
     .set_title = &autk_x11_window_set_title,
     .set_visible = &autk_x11_window_set_visible,
+    .get_surface = &autk_x11_window_get_surface,
 };
 
 //==============================================================================
@@ -288,7 +323,7 @@ AUTK_HIDDEN const autk_window_driver_t autk_window_driver_x11 = {
 AUTK_HIDDEN void
 autk_x11_window_invalidate(autk_window_t *window)
 {
-    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_window_data_t *window_data;
     autk_x11_client_data_t *client_data;
     autk_window_t *removed_window;
 
@@ -297,6 +332,7 @@ autk_x11_window_invalidate(autk_window_t *window)
     }
 
     assert(window->driver == &autk_window_driver_x11);
+    window_data = window->driver_data;
     client_data = window->client->driver_data;
 
     if (window_data->window_id != 0) {
@@ -306,73 +342,135 @@ autk_x11_window_invalidate(autk_window_t *window)
         window_data->window_id = 0;
     }
 
+    // An invalidated window won't be redrawn.
+    autk_x11_window_clear_dirty_region(window);
+
     if (window->callbacks && window->callbacks->invalidated) {
         window->callbacks->invalidated(window, window->user_data);
     }
 }
 
-//==============================================================================
-//
-// X11 window map
-//
-//==============================================================================
+AUTK_HIDDEN void
+autk_x11_window_add_dirty_region(autk_window_t *window, autk_bbox_t bbox)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+
+    autk_damage_add(&window_data->damage, bbox);
+}
+
+AUTK_HIDDEN void
+autk_x11_window_queue_redraw(autk_window_t *window)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+
+    if (window_data->redraw_queued || window_data->awaiting_buffer
+        || autk_damage_is_empty(&window_data->damage))
+    {
+        return;
+    }
+
+    window_data->dirty_prev = NULL;
+    window_data->dirty_next = client_data->dirty_windows;
+    if (client_data->dirty_windows) {
+        ((autk_x11_window_data_t *)client_data->dirty_windows->driver_data)->dirty_prev = window;
+    }
+    client_data->dirty_windows = window;
+    window_data->redraw_queued = true;
+}
+
+static void
+unqueue_redraw(autk_window_t *window)
+{
+    autk_x11_window_data_t *window_data = window->driver_data;
+    autk_x11_client_data_t *client_data = window->client->driver_data;
+
+    if (!window_data->redraw_queued) {
+        return;
+    }
 
-static autk_hash_t
-window_map_node_hash(const void *opaque)
+    if (window_data->dirty_prev) {
+        ((autk_x11_window_data_t *)window_data->dirty_prev->driver_data)->dirty_next =
+            window_data->dirty_next;
+    } else {
+        client_data->dirty_windows = window_data->dirty_next;
+    }
+    if (window_data->dirty_next) {
+        ((autk_x11_window_data_t *)window_data->dirty_next->driver_data)->dirty_prev =
+            window_data->dirty_prev;
+    }
+
+    window_data->dirty_prev = NULL;
+    window_data->dirty_next = NULL;
+    window_data->redraw_queued = false;
+}
+
+AUTK_HIDDEN void
+autk_x11_window_clear_dirty_region(autk_window_t *window)
 {
-    return *(const uint32_t *)opaque * 32939;
+    autk_x11_window_data_t *window_data = window->driver_data;
+
+    autk_damage_clear(&window_data->damage);
+    window_data->awaiting_buffer = false;
+    unqueue_redraw(window);
 }
 
-static bool
-window_map_node_eq(const void *opaque0, const void *opaque1)
+AUTK_HIDDEN void
+autk_x11_window_defer_redraw(autk_window_t *window)
 {
-    return *(const uint32_t *)opaque0 == *(const uint32_t *)opaque1;
+    autk_x11_window_data_t *window_data = window->driver_data;
+
+    window_data->awaiting_buffer = true;
+    unqueue_redraw(window);
 }
 
+//==============================================================================
+//
+// X11 window map
+//
+//==============================================================================
+
 AUTK_HIDDEN void
 autk_x11_window_map_init(autk_instance_t *instance, autk_x11_window_map_t *map)
 {
-    autk_hash_table_init(instance, &map->ht, sizeof(autk_x11_window_map_node_t),
-                         window_map_node_hash, window_map_node_eq);
+    autk_x11_window_table_init(instance, &map->table);
 }
 
 AUTK_HIDDEN void
 autk_x11_window_map_fini(autk_x11_window_map_t *map)
 {
-    autk_hash_table_fini(&map->ht);
+    autk_x11_window_table_fini(&map->table);
 }
 
 AUTK_HIDDEN autk_window_t *
 autk_x11_window_map_get(autk_x11_window_map_t *map, uint32_t id)
 {
-    autk_hash_iter_t iter;
-    autk_x11_window_map_node_t *node;
+    autk_window_t **window = autk_x11_window_table_find(&map->table, id);
 
-    if (autk_hash_table_find(&map->ht, &id, &iter)) {
-        node = autk_hash_table_get(&map->ht, iter);
-        return node->window;
-    } else {
-        return NULL;
-    }
+    return window ? *window : NULL;
 }
 
 AUTK_HIDDEN autk_status_t
 autk_x11_window_map_insert(autk_x11_window_map_t *map, uint32_t id, autk_window_t *window)
 {
-    autk_x11_window_map_node_t node = {id, window};
-    autk_x11_window_map_node_t *internal_node;
-    autk_hash_iter_t iter;
+    autk_window_t **internal_window;
+    autk_window_t *old_window;
     bool inserted;
 
-    AUTK_TRY(autk_hash_table_insert(&map->ht, &node, &iter, &inserted));
+    AUTK_TRY(autk_x11_window_table_insert(&map->table, id, window, &internal_window, &inserted));
 
     if (!inserted) {
-        // The specified ID already belongs to another window. Invalidate that window.
+        // The specified ID already belongs to another window. Invalidate that window, which removes
+        // it from the map, then try again. The entry we got back is gone by then, so it can't be
+        // reused.
+        old_window = *internal_window;
         AUTK_WARN(autk_window_get_instance(window),
                   "Window ID %" PRIu32 " already exists--invalidating the old window", id);
-        internal_node = autk_hash_table_get(&map->ht, iter);
-        autk_x11_window_invalidate(internal_node->window);
-        AUTK_TRY(autk_hash_table_insert(&map->ht, &node, &iter, NULL));
+        autk_x11_window_invalidate(old_window);
+        AUTK_TRY(autk_x11_window_table_insert(&map->table, id, window, NULL, &inserted));
+        if (!inserted) {
+            return AUTK_ERR_DATA_CORRUPTION;
+        }
     }
 
     return AUTK_OK;
@@ -381,8 +479,19 @@ autk_x11_window_map_insert(autk_x11_window_map_t *map, uint32_t id, autk_window_
 AUTK_HIDDEN autk_window_t *
 autk_x11_window_map_remove(autk_x11_window_map_t *map, uint32_t id)
 {
-    autk_x11_window_map_node_t *node;
+    autk_window_t *window;
+
+    return autk_x11_window_table_remove(&map->table, id, &window) ? window : NULL;
+}
 
-    node = autk_hash_table_remove(&map->ht, &id);
-    return node ? node->window : NULL;
+AUTK_HIDDEN void
+autk_x11_window_map_trim(autk_x11_window_map_t *map)
+{
+    autk_hash_table_t *ht = &map->table.ht;
+
+    // Give memory back once most of the windows from a burst have been closed. Failing to shrink
+    // isn't an error, since the table is still intact.
+    if (ht->used_count < ht->buf.bucket_count / 8) {
+        autk_hash_table_shrink_to_fit(ht);
+    }
 }
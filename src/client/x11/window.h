@@ -24,6 +24,24 @@ AUTK_HIDDEN extern const autk_window_driver_t autk_window_driver_x11;
 AUTK_HIDDEN void
 autk_x11_window_invalidate(autk_window_t *window);
 
+// Adds `bbox` to the window's dirty region. The window isn't redrawn until it's queued with
+// `autk_x11_window_queue_redraw()`.
+AUTK_HIDDEN void
+autk_x11_window_add_dirty_region(autk_window_t *window, autk_bbox_t bbox);
+
+// Queues the window for redrawing if its dirty region isn't empty and it isn't queued already.
+AUTK_HIDDEN void
+autk_x11_window_queue_redraw(autk_window_t *window);
+
+// Empties the window's dirty region and takes it out of the client's dirty list.
+AUTK_HIDDEN void
+autk_x11_window_clear_dirty_region(autk_window_t *window);
+
+// Takes the window out of the client's dirty list until a back buffer is released, keeping its
+// dirty region.
+AUTK_HIDDEN void
+autk_x11_window_defer_redraw(autk_window_t *window);
+
 AUTK_HIDDEN void
 autk_x11_window_map_init(autk_instance_t *instance, autk_x11_window_map_t *map);
 
@@ -39,4 +57,9 @@ autk_x11_window_map_insert(autk_x11_window_map_t *map, uint32_t id, autk_window_
 AUTK_HIDDEN autk_window_t *
 autk_x11_window_map_remove(autk_x11_window_map_t *map, uint32_t id);
 
+// Shrinks the map if most of its buckets are unused. This can move or free the map's storage, so it
+// must not be called while anything is iterating over the map.
+AUTK_HIDDEN void
+autk_x11_window_map_trim(autk_x11_window_map_t *map);
+
 #endif // AUTK_CLIENT_X11_WINDOW_H_
@@ -22,6 +22,7 @@
 #include <autk/instance.h>
 #include <autk/style.h>
 #include <core/types.h>
+#include <os/time.h>
 #include <utility/math.h>
 
 #define ALLOC_FALLBACK_STYLE_INCREMENT 4
@@ -118,6 +119,9 @@ autk_client_create(autk_instance_t *instance, const autk_client_create_params_t
         .user_data = params->user_data_size ? (char *)client + user_data_offset : NULL,
     };
 
+    autk_timer_heap_init(instance, &client->timers);
+    autk_frame_clock_init(&client->frame_clock);
+
     if (driver->driver_data_size) {
         memset(client->driver_data, 0, driver->driver_data_size);
     }
@@ -161,6 +165,7 @@ err_fini_client_driver:
     if (driver->fini) {
         driver->fini(client, client->driver_data);
     }
+    autk_timer_heap_fini(&client->timers);
     autk_instance_alloc(instance, client, alloc_size, 0, AUTK_MEMORY_TAG_CLIENT);
     return status;
 }
@@ -172,6 +177,9 @@ autk_client_destroy(autk_client_t *client)
         return;
     }
 
+    // Finalize pending timers while the driver is still around for them to use.
+    autk_timer_heap_fini(&client->timers);
+
     // Clean up the driver data.
     if (client->driver->fini) {
         client->driver->fini(client, client->driver_data);
@@ -223,6 +231,185 @@ autk_client_quit(autk_client_t *client)
     return client->driver->quit(client, client->driver_data);
 }
 
+AUTK_API autk_status_t
+autk_client_dispatch(autk_client_t *client, int timeout_ms)
+{
+    if (!client || timeout_ms < -1) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client->driver->dispatch) {
+        return AUTK_ERR_UNIMPLEMENTED;
+    }
+
+    return client->driver->dispatch(client, client->driver_data, timeout_ms);
+}
+
+AUTK_API autk_status_t
+autk_client_get_wait_fds(autk_client_t *client, autk_client_wait_fds_t *out_wait_fds)
+{
+    if (!client || !out_wait_fds) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (out_wait_fds->struct_size != sizeof(autk_client_wait_fds_t)) {
+        return AUTK_ERR_INVALID_STRUCT_SIZE;
+    } else if (!client->driver->get_wait_fds) {
+        return AUTK_ERR_UNIMPLEMENTED;
+    }
+
+    return client->driver->get_wait_fds(client, client->driver_data, out_wait_fds);
+}
+
+AUTK_API autk_status_t
+autk_client_post_job(autk_client_t *client, autk_job_t job)
+{
+    return autk_client_post_jobs(client, &job, 1);
+}
+
+AUTK_API autk_status_t
+autk_client_post_jobs(autk_client_t *client, const autk_job_t *jobs, size_t job_count)
+{
+    autk_status_t status;
+
+    if (!client || (!jobs && job_count)) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client->driver->post_jobs) {
+        status = AUTK_ERR_UNIMPLEMENTED;
+    } else if (job_count == 0) {
+        return AUTK_OK;
+    } else {
+        return client->driver->post_jobs(client, client->driver_data, jobs, job_count);
+    }
+
+    // The jobs are still ours to finalize if the driver never saw them.
+    for (size_t i = 0; jobs && i < job_count; i++) {
+        if (jobs[i].fini) {
+            jobs[i].fini(jobs[i].ctx);
+        }
+    }
+    return status;
+}
+
+AUTK_API autk_status_t
+autk_client_post_job_data(autk_client_t *client, autk_job_t job, const void *data,
+                          size_t data_size)
+{
+    autk_status_t status;
+
+    if (!client || (!data && data_size)) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client->driver->post_job_data) {
+        status = AUTK_ERR_UNIMPLEMENTED;
+    } else {
+        return client->driver->post_job_data(client, client->driver_data, &job, data, data_size);
+    }
+
+    if (job.fini) {
+        job.fini((void *)data);
+    }
+    return status;
+}
+
+AUTK_API autk_status_t
+autk_client_get_stats(autk_client_t *client, autk_client_stats_t *out_stats)
+{
+    if (!client || !out_stats) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (out_stats->struct_size != sizeof(autk_client_stats_t)) {
+        return AUTK_ERR_INVALID_STRUCT_SIZE;
+    }
+
+#if AUTK_JOB_STATS
+    if (!client->driver->get_stats) {
+        return AUTK_ERR_UNIMPLEMENTED;
+    }
+
+    *out_stats = (autk_client_stats_t){.struct_size = sizeof(autk_client_stats_t)};
+    client->driver->get_stats(client, client->driver_data, out_stats);
+    return AUTK_OK;
+#else
+    return AUTK_ERR_UNSUPPORTED_FEATURE;
+#endif
+}
+
+AUTK_API autk_status_t
+autk_client_add_timer(autk_client_t *client, const autk_timer_params_t *params,
+                      autk_timer_id_t *out_id)
+{
+    autk_status_t status;
+
+    if (!params) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (params->struct_size != sizeof(autk_timer_params_t)) {
+        status = AUTK_ERR_INVALID_STRUCT_SIZE;
+    } else {
+        status = autk_timer_heap_add(&client->timers, params, autk_monotonic_time_ns(), out_id);
+    }
+
+    if (status != AUTK_OK && params->fini) {
+        params->fini(params->ctx);
+    }
+    return status;
+}
+
+AUTK_API autk_status_t
+autk_client_cancel_timer(autk_client_t *client, autk_timer_id_t id)
+{
+    if (!client) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    return autk_timer_heap_cancel(&client->timers, id);
+}
+
+AUTK_API autk_status_t
+autk_client_set_frame_interval(autk_client_t *client, uint64_t interval_ns)
+{
+    if (!client) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    autk_frame_clock_set_interval(&client->frame_clock, interval_ns);
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_client_watch_fd(autk_client_t *client, const autk_fd_watch_params_t *params)
+{
+    autk_status_t status;
+
+    if (!params) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (params->struct_size != sizeof(autk_fd_watch_params_t)) {
+        status = AUTK_ERR_INVALID_STRUCT_SIZE;
+    } else if (params->fd < 0 || !params->callback
+               || (params->events & (autk_fd_events_t)~AUTK_FD_EVENT_ALL)) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client->driver->watch_fd) {
+        status = AUTK_ERR_UNIMPLEMENTED;
+    } else {
+        status = client->driver->watch_fd(client, client->driver_data, params);
+    }
+
+    if (status != AUTK_OK && params->fini) {
+        params->fini(params->ctx);
+    }
+    return status;
+}
+
+AUTK_API autk_status_t
+autk_client_unwatch_fd(autk_client_t *client, int fd)
+{
+    if (!client || fd < 0) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!client->driver->unwatch_fd) {
+        return AUTK_ERR_UNIMPLEMENTED;
+    }
+
+    return client->driver->unwatch_fd(client, client->driver_data, fd);
+}
+
 AUTK_API autk_device_t *
 autk_client_get_device(autk_client_t *client)
 {
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <autk/display_list.h>
+#include <autk/instance.h>
+#include <autk/math.h>
+#include <autk/surface.h>
+#include <utility/math.h>
+
+#include "types.h"
+
+typedef enum {
+    OP_FILL_RECT,
+    OP_BLEND_RECT,
+    OP_COPY,
+    OP_BLEND,
+    OP_DRAW_LINE,
+    OP_DRAW_BEVEL,
+} op_t;
+
+// Every command starts with a header, and is followed in the arena by the next one.
+typedef struct {
+    op_t op;
+    autk_bbox_t bbox; // every pixel the command may touch, for culling
+} command_header_t;
+
+typedef struct {
+    command_header_t header; // `bbox` is the rectangle
+    autk_rgba_t color;
+} rect_command_t;
+
+typedef struct {
+    command_header_t header;
+    autk_surface_t *src;
+    autk_bbox_t src_bbox;
+    int32_t dst_x, dst_y;
+} transfer_command_t;
+
+typedef struct {
+    command_header_t header;
+    int32_t x0, y0, x1, y1;
+    autk_rgba_t color;
+} line_command_t;
+
+typedef struct {
+    command_header_t header; // `bbox` is the bevel's
+    autk_rgba_t top_left;
+    autk_rgba_t bottom_right;
+} bevel_command_t;
+
+//==============================================================================
+//
+// Helpers
+//
+//==============================================================================
+
+static size_t
+get_command_size(op_t op)
+{
+    switch (op) {
+        case OP_FILL_RECT:
+        case OP_BLEND_RECT:
+            return sizeof(rect_command_t);
+        case OP_COPY:
+        case OP_BLEND:
+            return sizeof(transfer_command_t);
+        case OP_DRAW_LINE:
+            return sizeof(line_command_t);
+        case OP_DRAW_BEVEL:
+            return sizeof(bevel_command_t);
+    }
+    return sizeof(command_header_t);
+}
+
+// Allocates a command and fills in its header. Returns `NULL` if we're out of memory.
+static void *
+add_command(autk_display_list_t *list, op_t op, autk_bbox_t bbox)
+{
+    command_header_t *header = autk_arena_alloc(&list->commands, get_command_size(op));
+
+    if (!header) {
+        return NULL;
+    }
+
+    *header = (command_header_t){
+        .op = op,
+        .bbox = bbox,
+    };
+    autk_bbox_extend(&list->bounds, bbox);
+    list->command_count++;
+    return header;
+}
+
+static autk_status_t
+record_rect(autk_display_list_t *list, op_t op, const autk_bbox_t *bbox, autk_rgba_t color)
+{
+    rect_command_t *command;
+
+    if (!list || !bbox) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!autk_bbox_is_positive(bbox)) {
+        return AUTK_OK;
+    }
+
+    command = add_command(list, op, *bbox);
+    if (!command) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+    command->color = color;
+    return AUTK_OK;
+}
+
+static autk_status_t
+record_transfer(autk_display_list_t *list, op_t op, int32_t dst_x, int32_t dst_y,
+                autk_surface_t *src, const autk_bbox_t *src_bbox)
+{
+    transfer_command_t *command;
+    autk_bbox_t clipped;
+    autk_bbox_t dst_bbox;
+    uint32_t width;
+    uint32_t height;
+    int64_t offset_x;
+    int64_t offset_y;
+
+    if (!list || !src) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    // Only the part of the source that exists can land anywhere, so that's what gets recorded.
+    autk_surface_get_size(src, &width, &height);
+    clipped = (autk_bbox_t){0, 0, (int32_t)width, (int32_t)height};
+    if (src_bbox ? !autk_bbox_intersect(&clipped, src_bbox) : !autk_bbox_is_positive(&clipped)) {
+        return AUTK_OK;
+    }
+
+    offset_x = (int64_t)dst_x - (src_bbox ? src_bbox->x0 : 0);
+    offset_y = (int64_t)dst_y - (src_bbox ? src_bbox->y0 : 0);
+    dst_bbox = (autk_bbox_t){
+        .x0 = (int32_t)autk_int64_clamp(clipped.x0 + offset_x, INT32_MIN, INT32_MAX),
+        .y0 = (int32_t)autk_int64_clamp(clipped.y0 + offset_y, INT32_MIN, INT32_MAX),
+        .x1 = (int32_t)autk_int64_clamp(clipped.x1 + offset_x, INT32_MIN, INT32_MAX),
+        .y1 = (int32_t)autk_int64_clamp(clipped.y1 + offset_y, INT32_MIN, INT32_MAX),
+    };
+    if (!autk_bbox_is_positive(&dst_bbox)) {
+        return AUTK_OK;
+    }
+
+    command = add_command(list, op, dst_bbox);
+    if (!command) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+    command->src = src;
+    command->src_bbox = clipped;
+    command->dst_x = dst_bbox.x0;
+    command->dst_y = dst_bbox.y0;
+    return AUTK_OK;
+}
+
+static autk_status_t
+replay_command(const command_header_t *header, autk_surface_t *surface)
+{
+    const rect_command_t *rect = (const rect_command_t *)header;
+    const transfer_command_t *transfer = (const transfer_command_t *)header;
+    const line_command_t *line = (const line_command_t *)header;
+    const bevel_command_t *bevel = (const bevel_command_t *)header;
+
+    switch (header->op) {
+        case OP_FILL_RECT:
+            return autk_surface_fill_rect(surface, &header->bbox, rect->color);
+        case OP_BLEND_RECT:
+            return autk_surface_blend_rect(surface, &header->bbox, rect->color);
+        case OP_COPY:
+            return autk_surface_copy(surface, transfer->dst_x, transfer->dst_y, transfer->src,
+                                     &transfer->src_bbox);
+        case OP_BLEND:
+            return autk_surface_blend(surface, transfer->dst_x, transfer->dst_y, transfer->src,
+                                      &transfer->src_bbox);
+        case OP_DRAW_LINE:
+            return autk_surface_draw_line(surface, line->x0, line->y0, line->x1, line->y1,
+                                          line->color);
+        case OP_DRAW_BEVEL:
+            return autk_surface_draw_bevel(surface, &header->bbox, bevel->top_left,
+                                           bevel->bottom_right);
+    }
+    return AUTK_ERR_DATA_CORRUPTION;
+}
+
+//==============================================================================
+//
+// Public API
+//
+//==============================================================================
+
+AUTK_API autk_status_t
+autk_display_list_create(autk_instance_t *instance, autk_display_list_t **out_list)
+{
+    autk_display_list_t *list;
+
+    if (!instance || !out_list) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    list = autk_instance_alloc(instance, NULL, 0, sizeof(autk_display_list_t),
+                               AUTK_MEMORY_TAG_DISPLAY_LIST);
+    if (!list) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *list = (autk_display_list_t){
+        .instance = instance,
+    };
+    autk_arena_init(&list->commands, instance, AUTK_MEMORY_TAG_DISPLAY_LIST);
+
+    *out_list = list;
+    return AUTK_OK;
+}
+
+AUTK_API void
+autk_display_list_destroy(autk_display_list_t *list)
+{
+    if (!list) {
+        return;
+    }
+
+    autk_arena_fini(&list->commands);
+    autk_instance_alloc(list->instance, list, sizeof(autk_display_list_t), 0,
+                        AUTK_MEMORY_TAG_DISPLAY_LIST);
+}
+
+AUTK_API void
+autk_display_list_clear(autk_display_list_t *list)
+{
+    if (!list) {
+        return;
+    }
+
+    autk_arena_reset(&list->commands);
+    list->bounds = (autk_bbox_t){0, 0, 0, 0};
+    list->command_count = 0;
+}
+
+AUTK_API bool
+autk_display_list_is_empty(const autk_display_list_t *list)
+{
+    return !list || !list->command_count;
+}
+
+AUTK_API autk_bbox_t
+autk_display_list_get_bounds(const autk_display_list_t *list)
+{
+    return list ? list->bounds : (autk_bbox_t){0, 0, 0, 0};
+}
+
+AUTK_API autk_status_t
+autk_display_list_fill_rect(autk_display_list_t *list, const autk_bbox_t *bbox,
+                            autk_rgba_t color)
+{
+    return record_rect(list, OP_FILL_RECT, bbox, color);
+}
+
+AUTK_API autk_status_t
+autk_display_list_blend_rect(autk_display_list_t *list, const autk_bbox_t *bbox,
+                             autk_rgba_t color)
+{
+    return record_rect(list, OP_BLEND_RECT, bbox, color);
+}
+
+AUTK_API autk_status_t
+autk_display_list_copy(autk_display_list_t *list, int32_t dst_x, int32_t dst_y,
+                       autk_surface_t *src, const autk_bbox_t *src_bbox)
+{
+    return record_transfer(list, OP_COPY, dst_x, dst_y, src, src_bbox);
+}
+
+AUTK_API autk_status_t
+autk_display_list_blend(autk_display_list_t *list, int32_t dst_x, int32_t dst_y,
+                        autk_surface_t *src, const autk_bbox_t *src_bbox)
+{
+    return record_transfer(list, OP_BLEND, dst_x, dst_y, src, src_bbox);
+}
+
+AUTK_API autk_status_t
+autk_display_list_draw_line(autk_display_list_t *list, int32_t x0, int32_t y0, int32_t x1,
+                            int32_t y1, autk_rgba_t color)
+{
+    int64_t dx = (int64_t)x1 - x0;
+    int64_t dy = (int64_t)y1 - y0;
+    line_command_t *command;
+    autk_bbox_t bbox;
+
+    if (!list) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (dx && dy
+               && (dx < -AUTK_MAX_LINE_SPAN || dx > AUTK_MAX_LINE_SPAN
+                   || dy < -AUTK_MAX_LINE_SPAN || dy > AUTK_MAX_LINE_SPAN))
+    {
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
+    }
+
+    // Lines include both end points.
+    bbox = (autk_bbox_t){
+        .x0 = autk_int32_min(x0, x1),
+        .y0 = autk_int32_min(y0, y1),
+        .x1 = (int32_t)autk_int64_min((int64_t)autk_int32_max(x0, x1) + 1, INT32_MAX),
+        .y1 = (int32_t)autk_int64_min((int64_t)autk_int32_max(y0, y1) + 1, INT32_MAX),
+    };
+
+    command = add_command(list, OP_DRAW_LINE, bbox);
+    if (!command) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+    *command = (line_command_t){
+        .header = command->header,
+        .x0 = x0,
+        .y0 = y0,
+        .x1 = x1,
+        .y1 = y1,
+        .color = color,
+    };
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_display_list_draw_bevel(autk_display_list_t *list, const autk_bbox_t *bbox,
+                             autk_rgba_t top_left, autk_rgba_t bottom_right)
+{
+    bevel_command_t *command;
+
+    if (!list || !bbox) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!autk_bbox_is_positive(bbox)) {
+        return AUTK_OK;
+    }
+
+    command = add_command(list, OP_DRAW_BEVEL, *bbox);
+    if (!command) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+    command->top_left = top_left;
+    command->bottom_right = bottom_right;
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_display_list_replay(const autk_display_list_t *list, autk_surface_t *surface,
+                         const autk_bbox_t *clip)
+{
+    autk_status_t status = AUTK_OK;
+    const command_header_t *header;
+    const char *data;
+    autk_bbox_t saved_clip;
+    autk_bbox_t area;
+    autk_bbox_t bbox;
+    size_t offset;
+
+    if (!list || !surface) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    saved_clip = autk_surface_get_clip(surface);
+    area = saved_clip;
+    if (clip && !autk_bbox_intersect(&area, clip)) {
+        return AUTK_OK;
+    }
+    bbox = list->bounds;
+    if (!autk_bbox_intersect(&bbox, &area)) {
+        return AUTK_OK;
+    }
+
+    // Commands are packed in recording order through the arena's chunks.
+    autk_surface_set_clip(surface, &area);
+    for (autk_arena_chunk_t *chunk = list->commands.head; chunk && status == AUTK_OK;
+         chunk = chunk->next) {
+        data = autk_arena_chunk_data(chunk);
+        for (offset = 0; offset < chunk->used && status == AUTK_OK;
+             offset += autk_arena_round_size(get_command_size(header->op))) {
+            header = (const command_header_t *)(data + offset);
+            bbox = header->bbox;
+            if (autk_bbox_intersect(&bbox, &area)) {
+                status = replay_command(header, surface);
+            }
+        }
+    }
+    autk_surface_set_clip(surface, &saved_clip);
+
+    return status;
+}
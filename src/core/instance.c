@@ -21,7 +21,9 @@
 #include <autk/diagnostics.h>
 #include <autk/instance.h>
 #include <core/types.h>
+#include <os/thread.h>
 #include <utility/math.h>
+#include <utility/thread_pool.h>
 
 AUTK_API autk_status_t
 autk_instance_create(const autk_instance_create_params_t *params, autk_instance_t **out_instance)
@@ -33,6 +35,8 @@ autk_instance_create(const autk_instance_create_params_t *params, autk_instance_
     autk_instance_create_flags_t flags;
     autk_alloc_func_t alloc_func;
     autk_instance_t *instance;
+    uint32_t worker_thread_count;
+    autk_status_t status;
     size_t alloc_size = autk_align_up(sizeof(autk_instance_t));
     size_t user_data_offset = 0;
 
@@ -63,6 +67,15 @@ autk_instance_create(const autk_instance_create_params_t *params, autk_instance_
         return AUTK_ERR_INVALID_ARGUMENT;
     }
 
+    // Worker threads allocate task storage concurrently.
+    worker_thread_count = params->worker_thread_count;
+    if (worker_thread_count == AUTK_WORKER_THREAD_COUNT_AUTO) {
+        worker_thread_count = autk_cpu_count();
+    }
+    if (worker_thread_count && !(flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC)) {
+        return AUTK_ERR_INVALID_CONFIGURATION;
+    }
+
     // Compute the actual size of the instance object.
     AUTK_TRY(autk_add_alloc_region(&alloc_size, params->user_data_size, &user_data_offset));
 
@@ -91,6 +104,15 @@ autk_instance_create(const autk_instance_create_params_t *params, autk_instance_
         }
     }
 
+    // Start worker threads last, since they can see the instance as soon as they run.
+    if (worker_thread_count) {
+        status = autk_thread_pool_create(instance, worker_thread_count, &instance->thread_pool);
+        if (status != AUTK_OK) {
+            alloc_func(params->alloc_ctx, instance, alloc_size, 0, AUTK_MEMORY_TAG_INSTANCE);
+            return status;
+        }
+    }
+
     // Success!
     *out_instance = instance;
     return AUTK_OK;
@@ -103,6 +125,7 @@ autk_instance_destroy(autk_instance_t *instance)
         return;
     }
 
+    autk_thread_pool_destroy(instance->thread_pool);
     autk_instance_alloc(instance, instance, instance->alloc_size, 0, AUTK_MEMORY_TAG_INSTANCE);
 }
 
@@ -112,6 +135,29 @@ autk_instance_get_user_data(autk_instance_t *instance)
     return instance ? instance->user_data : NULL;
 }
 
+AUTK_API autk_status_t
+autk_instance_submit_task(autk_instance_t *instance, const autk_task_params_t *params)
+{
+    autk_status_t status;
+
+    if (!params) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (params->struct_size != sizeof(autk_task_params_t)) {
+        return AUTK_ERR_INVALID_STRUCT_SIZE;
+    } else if (!instance || !params->exec) {
+        status = AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!instance->thread_pool) {
+        status = AUTK_ERR_UNSUPPORTED_FEATURE;
+    } else {
+        return autk_thread_pool_submit(instance->thread_pool, params);
+    }
+
+    if (params->fini) {
+        params->fini(params->ctx);
+    }
+    return status;
+}
+
 AUTK_API void
 autk_instance_message(const autk_instance_t *instance, autk_message_severity_t severity,
                       const char *module_name, const autk_source_location_t *location,
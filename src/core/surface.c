@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <autk/math.h>
+#include <autk/surface.h>
+#include <utility/math.h>
+
+#include "tiler.h"
+#include "types.h"
+
+//==============================================================================
+//
+// Helpers
+//
+//==============================================================================
+
+// Converts a color to a premultiplied pixel.
+static uint32_t
+premultiply(autk_rgba_t color)
+{
+    uint32_t a = color.a;
+    uint32_t r = (color.r * a + 127) / 255;
+    uint32_t g = (color.g * a + 127) / 255;
+    uint32_t b = (color.b * a + 127) / 255;
+
+    return a << 24 | r << 16 | g << 8 | b;
+}
+
+static autk_bbox_t
+get_bounds(const autk_surface_t *surface)
+{
+    return (autk_bbox_t){0, 0, (int32_t)surface->width, (int32_t)surface->height};
+}
+
+// Draws anything that's been recorded to read `surface`, before the surface changes or goes away.
+static void
+flush_reader(autk_surface_t *surface)
+{
+    if (surface->reader) {
+        autk_tiler_flush(surface->reader);
+    }
+}
+
+// Draws a clipped command, or records it if the surface's drawing is being tiled.
+static void
+submit(autk_surface_t *surface, const autk_tile_command_t *command)
+{
+    flush_reader(surface);
+    if (surface->tiler) {
+        autk_tiler_record(surface->tiler, command);
+    } else {
+        autk_tile_command_run(surface, command, &command->bbox);
+    }
+}
+
+// Fills or blends a rectangle, whichever `color` calls for, after clipping it.
+static void
+draw_rect(autk_surface_t *surface, autk_bbox_t bbox, autk_rgba_t color, bool blend)
+{
+    autk_tile_command_t command = {
+        .bbox = bbox,
+        .pixel = premultiply(color),
+        .op = blend && color.a < 255 ? AUTK_TILE_OP_BLEND : AUTK_TILE_OP_FILL,
+    };
+
+    if (!autk_bbox_intersect(&command.bbox, &surface->clip) || (blend && !color.a)) {
+        return;
+    }
+
+    submit(surface, &command);
+}
+
+// Copies or blends a clipped transfer. Sources are read when the command runs, so any drawing
+// recorded into the source is done first, and the source remembers the tiler that reads it until
+// then. A surface that's transferred onto itself is drawn directly, since other tiles would read
+// pixels this one writes.
+static void
+submit_transfer(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                const autk_bbox_t *src_bbox, autk_tile_op_t op)
+{
+    autk_tile_command_t command = {
+        .bbox = {dst_x, dst_y, dst_x + (src_bbox->x1 - src_bbox->x0),
+                 dst_y + (src_bbox->y1 - src_bbox->y0)},
+        .src = src,
+        .src_x = src_bbox->x0,
+        .src_y = src_bbox->y0,
+        .op = op,
+    };
+
+    if (src->tiler) {
+        autk_tiler_flush(src->tiler);
+    }
+    if (src == dst) {
+        flush_reader(dst);
+        autk_tile_command_run(dst, &command, &command.bbox);
+    } else {
+        submit(dst, &command);
+    }
+}
+
+static bool
+can_draw_rects(const autk_surface_t *surface)
+{
+    const autk_device_driver_t *driver = surface->device->driver;
+
+    return driver && driver->fill_rect && driver->blend_rect;
+}
+
+// Clips a transfer of `src_bbox` from `src` to (`*dst_x`, `*dst_y`) in `dst`, adjusting both ends
+// to match. Returns false if nothing's left.
+static bool
+clip_transfer(autk_surface_t *dst, int32_t *dst_x, int32_t *dst_y, autk_surface_t *src,
+              autk_bbox_t *src_bbox)
+{
+    autk_bbox_t src_bounds = get_bounds(src);
+    int64_t offset_x;
+    int64_t offset_y;
+    autk_bbox_t dst_bbox;
+
+    offset_x = (int64_t)*dst_x - src_bbox->x0;
+    offset_y = (int64_t)*dst_y - src_bbox->y0;
+    if (!autk_bbox_intersect(src_bbox, &src_bounds)) {
+        return false;
+    }
+
+    // Work out where the clipped source lands. Anything that lands outside the int32_t range is
+    // certainly outside the destination's clip rectangle, so it's clamped away.
+    dst_bbox = (autk_bbox_t){
+        .x0 = (int32_t)autk_int64_clamp(src_bbox->x0 + offset_x, INT32_MIN, INT32_MAX),
+        .y0 = (int32_t)autk_int64_clamp(src_bbox->y0 + offset_y, INT32_MIN, INT32_MAX),
+        .x1 = (int32_t)autk_int64_clamp(src_bbox->x1 + offset_x, INT32_MIN, INT32_MAX),
+        .y1 = (int32_t)autk_int64_clamp(src_bbox->y1 + offset_y, INT32_MIN, INT32_MAX),
+    };
+    if (!autk_bbox_intersect(&dst_bbox, &dst->clip)) {
+        return false;
+    }
+
+    *src_bbox = (autk_bbox_t){
+        .x0 = (int32_t)(dst_bbox.x0 - offset_x),
+        .y0 = (int32_t)(dst_bbox.y0 - offset_y),
+        .x1 = (int32_t)(dst_bbox.x1 - offset_x),
+        .y1 = (int32_t)(dst_bbox.y1 - offset_y),
+    };
+    *dst_x = dst_bbox.x0;
+    *dst_y = dst_bbox.y0;
+    return true;
+}
+
+//==============================================================================
+//
+// Public API
+//
+//==============================================================================
+
+AUTK_API autk_status_t
+autk_surface_create(autk_device_t *device, const autk_surface_create_params_t *params,
+                    autk_surface_t **out_surface)
+{
+    autk_surface_t *surface;
+    size_t alloc_size = autk_align_up(sizeof(autk_surface_t));
+    size_t pixels_offset = 0;
+    size_t stride;
+
+    if (!device || !params || !out_surface) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (params->struct_size != sizeof(autk_surface_create_params_t)) {
+        return AUTK_ERR_INVALID_STRUCT_SIZE;
+    } else if (!params->width || !params->height || params->width > INT32_MAX
+               || params->height > INT32_MAX)
+    {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    // Compute the size and layout of the surface. Our own rows are padded like allocation regions,
+    // so every row is as aligned as the first.
+    if (params->pixels) {
+        stride = params->stride;
+        if (stride % 4 || stride / 4 < params->width) {
+            return AUTK_ERR_INVALID_ARGUMENT;
+        }
+    } else {
+        stride = 0;
+        AUTK_TRY(autk_add_alloc_array_region(&stride, params->width, sizeof(uint32_t),
+                                             &pixels_offset));
+        AUTK_TRY(autk_add_alloc_array_region(&alloc_size, params->height, stride, &pixels_offset));
+    }
+
+    // Allocate the surface.
+    surface = autk_instance_alloc(device->instance, NULL, 0, alloc_size, AUTK_MEMORY_TAG_SURFACE);
+    if (!surface) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *surface = (autk_surface_t){
+        .device = device,
+        .alloc_size = alloc_size,
+        .width = params->width,
+        .height = params->height,
+        .stride = stride,
+        .pixels = params->pixels ? params->pixels : (uint32_t *)((char *)surface + pixels_offset),
+    };
+    surface->clip = get_bounds(surface);
+
+    if (!params->pixels) {
+        memset(surface->pixels, 0, stride * params->height);
+    }
+
+    *out_surface = surface;
+    return AUTK_OK;
+}
+
+AUTK_API void
+autk_surface_destroy(autk_surface_t *surface)
+{
+    if (!surface) {
+        return;
+    }
+
+    flush_reader(surface);
+    if (surface->tiler) {
+        autk_tiler_discard(surface->tiler);
+    }
+    autk_instance_alloc(surface->device->instance, surface, surface->alloc_size, 0,
+                        AUTK_MEMORY_TAG_SURFACE);
+}
+
+AUTK_API autk_device_t *
+autk_surface_get_device(autk_surface_t *surface)
+{
+    return surface ? surface->device : NULL;
+}
+
+AUTK_API uint32_t *
+autk_surface_get_pixels(autk_surface_t *surface)
+{
+    if (!surface) {
+        return NULL;
+    }
+
+    // Whoever reads the pixels expects to see what's been drawn, and may change them.
+    flush_reader(surface);
+    if (surface->tiler) {
+        autk_tiler_flush(surface->tiler);
+    }
+    return surface->pixels;
+}
+
+AUTK_API size_t
+autk_surface_get_stride(autk_surface_t *surface)
+{
+    return surface ? surface->stride : 0;
+}
+
+AUTK_API void
+autk_surface_get_size(autk_surface_t *surface, uint32_t *out_width, uint32_t *out_height)
+{
+    if (out_width) {
+        *out_width = surface ? surface->width : 0;
+    }
+    if (out_height) {
+        *out_height = surface ? surface->height : 0;
+    }
+}
+
+AUTK_API void
+autk_surface_set_clip(autk_surface_t *surface, const autk_bbox_t *clip)
+{
+    if (!surface) {
+        return;
+    }
+
+    surface->clip = get_bounds(surface);
+    if (clip && !autk_bbox_intersect(&surface->clip, clip)) {
+        surface->clip = (autk_bbox_t){0, 0, 0, 0};
+    }
+}
+
+AUTK_API autk_bbox_t
+autk_surface_get_clip(autk_surface_t *surface)
+{
+    return surface ? surface->clip : (autk_bbox_t){0, 0, 0, 0};
+}
+
+AUTK_API autk_status_t
+autk_surface_fill_rect(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t color)
+{
+    if (!surface || !bbox) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!can_draw_rects(surface)) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    }
+
+    draw_rect(surface, *bbox, color, false);
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_surface_blend_rect(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t color)
+{
+    if (!surface || !bbox) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!can_draw_rects(surface)) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    }
+
+    draw_rect(surface, *bbox, color, true);
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_surface_copy(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                  const autk_bbox_t *src_bbox)
+{
+    autk_device_t *device;
+    autk_bbox_t clipped;
+
+    if (!dst || !src || dst->device != src->device) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    device = dst->device;
+    if (!device->driver || !device->driver->copy_rect) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    }
+
+    clipped = src_bbox ? *src_bbox : get_bounds(src);
+    if (clip_transfer(dst, &dst_x, &dst_y, src, &clipped)) {
+        submit_transfer(dst, dst_x, dst_y, src, &clipped, AUTK_TILE_OP_COPY);
+    }
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_surface_blend(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                   const autk_bbox_t *src_bbox)
+{
+    autk_device_t *device;
+    autk_bbox_t clipped;
+
+    if (!dst || !src || dst->device != src->device) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    }
+
+    device = dst->device;
+    if (!device->driver || !device->driver->blend_image) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    }
+
+    clipped = src_bbox ? *src_bbox : get_bounds(src);
+    if (clip_transfer(dst, &dst_x, &dst_y, src, &clipped)) {
+        submit_transfer(dst, dst_x, dst_y, src, &clipped, AUTK_TILE_OP_BLEND_IMAGE);
+    }
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_surface_draw_line(autk_surface_t *surface, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                       autk_rgba_t color)
+{
+    int64_t dx = (int64_t)x1 - x0;
+    int64_t dy = (int64_t)y1 - y0;
+    int64_t major_span;
+    int64_t minor_span;
+    int64_t major0;
+    int64_t minor0;
+    int64_t major_step;
+    int64_t minor_step;
+    int64_t major_min;
+    int64_t major_max;
+    int64_t t_begin;
+    int64_t t_end;
+    int64_t run_start;
+    int64_t run_minor;
+    int64_t minor;
+    bool x_major;
+
+    if (!surface) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!can_draw_rects(surface)) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    }
+
+    // Horizontal and vertical lines are just rectangles.
+    if (dx == 0 || dy == 0) {
+        draw_rect(surface,
+                  (autk_bbox_t){
+                      .x0 = autk_int32_min(x0, x1),
+                      .y0 = autk_int32_min(y0, y1),
+                      .x1 = autk_int32_max(x0, x1) == INT32_MAX ? INT32_MAX
+                                                                 : autk_int32_max(x0, x1) + 1,
+                      .y1 = autk_int32_max(y0, y1) == INT32_MAX ? INT32_MAX
+                                                                 : autk_int32_max(y0, y1) + 1,
+                  },
+                  color, true);
+        return AUTK_OK;
+    }
+
+    if (dx < -AUTK_MAX_LINE_SPAN || dx > AUTK_MAX_LINE_SPAN || dy < -AUTK_MAX_LINE_SPAN
+        || dy > AUTK_MAX_LINE_SPAN)
+    {
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
+    }
+
+    // Step along the longer axis, t pixels from the start. The minor coordinate at t is the start's
+    // plus round(t * minor_span / major_span), which is symmetric and hits both end points.
+    x_major = (dx < 0 ? -dx : dx) >= (dy < 0 ? -dy : dy);
+    major0 = x_major ? x0 : y0;
+    minor0 = x_major ? y0 : x0;
+    major_span = x_major ? dx : dy;
+    minor_span = x_major ? dy : dx;
+    major_step = major_span < 0 ? -1 : 1;
+    minor_step = minor_span < 0 ? -1 : 1;
+    major_span *= major_step;
+    minor_span *= minor_step;
+
+    // Only step through the part of the line that's within the clip rectangle along the major axis.
+    // Pixels outside it along the minor axis are clipped when they're drawn.
+    major_min = x_major ? surface->clip.x0 : surface->clip.y0;
+    major_max = (x_major ? surface->clip.x1 : surface->clip.y1) - 1;
+    if (major_step > 0) {
+        t_begin = autk_int64_max(0, major_min - major0);
+        t_end = autk_int64_min(major_span, major_max - major0);
+    } else {
+        t_begin = autk_int64_max(0, major0 - major_max);
+        t_end = autk_int64_min(major_span, major0 - major_min);
+    }
+
+    // Draw each run of pixels that share a minor coordinate as one rectangle.
+    run_start = t_begin;
+    run_minor = 0;
+    for (int64_t t = t_begin; t <= t_end + 1; t++) {
+        minor = t <= t_end ? (2 * minor_span * t + major_span) / (2 * major_span) : -1;
+        if (t > t_begin && minor != run_minor) {
+            int64_t a = major0 + run_start * major_step;
+            int64_t b = major0 + (t - 1) * major_step;
+            int32_t run_min = (int32_t)autk_int64_min(a, b);
+            int32_t run_max = (int32_t)autk_int64_max(a, b);
+            int32_t run_pos = (int32_t)(minor0 + run_minor * minor_step);
+
+            // Both ends are within the clip rectangle along the major axis, so adding one to the
+            // maximum can't overflow. The minor coordinate might be anywhere.
+            if (run_pos != INT32_MAX) {
+                draw_rect(surface,
+                          x_major ? (autk_bbox_t){run_min, run_pos, run_max + 1, run_pos + 1}
+                                  : (autk_bbox_t){run_pos, run_min, run_pos + 1, run_max + 1},
+                          color, true);
+            }
+            run_start = t;
+        }
+        run_minor = minor;
+    }
+
+    return AUTK_OK;
+}
+
+AUTK_API autk_status_t
+autk_surface_draw_bevel(autk_surface_t *surface, const autk_bbox_t *bbox, autk_rgba_t top_left,
+                        autk_rgba_t bottom_right)
+{
+    if (!surface || !bbox) {
+        return AUTK_ERR_INVALID_ARGUMENT;
+    } else if (!can_draw_rects(surface)) {
+        return AUTK_ERR_UNSUPPORTED_FEATURE;
+    } else if (!autk_bbox_is_positive(bbox)) {
+        return AUTK_OK;
+    }
+
+    // Bottom and right edges, which own the corners they share with the others. A bevel one pixel
+    // wide or tall is all bottom or right edge.
+    draw_rect(surface, (autk_bbox_t){bbox->x0, bbox->y1 - 1, bbox->x1, bbox->y1}, bottom_right,
+              true);
+    draw_rect(surface, (autk_bbox_t){bbox->x1 - 1, bbox->y0, bbox->x1, bbox->y1 - 1}, bottom_right,
+              true);
+
+    // Top and left edges, with whatever's left.
+    if (bbox->y1 - 1 > bbox->y0) {
+        draw_rect(surface, (autk_bbox_t){bbox->x0, bbox->y0, bbox->x1 - 1, bbox->y0 + 1},
+                  top_left, true);
+    }
+    if (bbox->x1 - 1 > bbox->x0) {
+        draw_rect(surface, (autk_bbox_t){bbox->x0, bbox->y0 + 1, bbox->x0 + 1, bbox->y1 - 1},
+                  top_left, true);
+    }
+
+    return AUTK_OK;
+}
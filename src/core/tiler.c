@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <autk/math.h>
+#include <os/sync.h>
+#include <utility/math.h>
+#include <utility/thread_pool.h>
+
+#include "tiler.h"
+
+#define CLEAN_TILE UINT32_MAX
+#define MIN_CAPACITY 64
+
+// Set in `queued_helpers` once `autk_tiler_fini()` is waiting for the last helper task to finish.
+#define HELPERS_FINISHING (UINT32_C(1) << 31)
+
+// Recorded commands are drawn once binning them could take this many entries, which bounds the
+// memory a frame of large or numerous commands takes.
+#define MAX_BIN_ENTRIES (1 << 16)
+
+//==============================================================================
+//
+// Helpers
+//
+//==============================================================================
+
+// Grows an array to hold at least `min_capacity` elements, keeping its contents.
+static autk_status_t
+reserve(autk_instance_t *instance, void **array, size_t *capacity, size_t min_capacity,
+        size_t element_size)
+{
+    size_t new_capacity;
+    void *new_array;
+
+    if (*capacity >= min_capacity) {
+        return AUTK_OK;
+    }
+
+    new_capacity = *capacity ? *capacity : MIN_CAPACITY;
+    while (new_capacity < min_capacity) {
+        if (new_capacity > SIZE_MAX / element_size / 2) {
+            return AUTK_ERR_OUT_OF_MEMORY;
+        }
+        new_capacity *= 2;
+    }
+
+    new_array = autk_instance_alloc(instance, *array, *capacity * element_size,
+                                    new_capacity * element_size, AUTK_MEMORY_TAG_SURFACE);
+    if (!new_array) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *array = new_array;
+    *capacity = new_capacity;
+    return AUTK_OK;
+}
+
+static void
+release(autk_instance_t *instance, void **array, size_t *capacity, size_t element_size)
+{
+    if (*array) {
+        autk_instance_alloc(instance, *array, *capacity * element_size, 0,
+                            AUTK_MEMORY_TAG_SURFACE);
+    }
+    *array = NULL;
+    *capacity = 0;
+}
+
+// Returns the range of tiles that `bbox` touches, which must be positive and within the surface.
+static void
+get_tile_range(const autk_bbox_t *bbox, autk_bbox_t *out_range)
+{
+    *out_range = (autk_bbox_t){
+        .x0 = bbox->x0 >> AUTK_TILE_SHIFT,
+        .y0 = bbox->y0 >> AUTK_TILE_SHIFT,
+        .x1 = ((bbox->x1 - 1) >> AUTK_TILE_SHIFT) + 1,
+        .y1 = ((bbox->y1 - 1) >> AUTK_TILE_SHIFT) + 1,
+    };
+}
+
+static uint64_t
+get_tile_range_area(const autk_bbox_t *range)
+{
+    return (uint64_t)(range->x1 - range->x0) * (uint64_t)(range->y1 - range->y0);
+}
+
+static autk_bbox_t
+get_tile_bbox(const autk_tiler_t *tiler, uint32_t tile)
+{
+    int32_t x = (int32_t)(tile % tiler->tiles_x) << AUTK_TILE_SHIFT;
+    int32_t y = (int32_t)(tile / tiler->tiles_x) << AUTK_TILE_SHIFT;
+
+    return (autk_bbox_t){
+        .x0 = x,
+        .y0 = y,
+        .x1 = (int32_t)autk_int64_min((int64_t)x + AUTK_TILE_SIZE, tiler->surface->width),
+        .y1 = (int32_t)autk_int64_min((int64_t)y + AUTK_TILE_SIZE, tiler->surface->height),
+    };
+}
+
+//==============================================================================
+//
+// Drawing
+//
+//==============================================================================
+
+// Sorts the recorded commands into the bins of the dirty tiles they touch, keeping them in order.
+static autk_status_t
+bin_commands(autk_tiler_t *tiler)
+{
+    uint32_t *offsets = tiler->bin_offsets;
+    const autk_tile_command_t *command;
+    autk_bbox_t range;
+    uint32_t slot;
+    size_t total = 0;
+
+    // Count each bin's commands into the entry after its own.
+    memset(offsets, 0, (tiler->dirty_tile_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < tiler->command_count; i++) {
+        get_tile_range(&tiler->commands[i].bbox, &range);
+        for (int32_t y = range.y0; y < range.y1; y++) {
+            for (int32_t x = range.x0; x < range.x1; x++) {
+                slot = tiler->tile_slots[(size_t)y * tiler->tiles_x + (size_t)x];
+                if (slot != CLEAN_TILE) {
+                    offsets[slot + 1]++;
+                    total++;
+                }
+            }
+        }
+    }
+    AUTK_TRY(reserve(tiler->instance, (void **)&tiler->bin_entries, &tiler->bin_entry_capacity,
+                     total, sizeof(uint32_t)));
+
+    // Turn the counts into starting offsets, then fill the bins. Filling advances each bin's offset
+    // to the start of the next, so shift them back afterwards.
+    for (uint32_t i = 0; i < tiler->dirty_tile_count; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    for (uint32_t i = 0; i < tiler->command_count; i++) {
+        command = &tiler->commands[i];
+        get_tile_range(&command->bbox, &range);
+        for (int32_t y = range.y0; y < range.y1; y++) {
+            for (int32_t x = range.x0; x < range.x1; x++) {
+                slot = tiler->tile_slots[(size_t)y * tiler->tiles_x + (size_t)x];
+                if (slot != CLEAN_TILE) {
+                    tiler->bin_entries[offsets[slot]++] = i;
+                }
+            }
+        }
+    }
+    memmove(offsets + 1, offsets, tiler->dirty_tile_count * sizeof(uint32_t));
+    offsets[0] = 0;
+
+    return AUTK_OK;
+}
+
+static void
+draw_tile(autk_tiler_t *tiler, uint32_t slot)
+{
+    autk_bbox_t bbox = get_tile_bbox(tiler, tiler->dirty_tiles[slot]);
+
+    for (uint32_t i = tiler->bin_offsets[slot]; i < tiler->bin_offsets[slot + 1]; i++) {
+        autk_tile_command_run(tiler->surface, &tiler->commands[tiler->bin_entries[i]], &bbox);
+    }
+}
+
+// Draws tiles of the frame being drawn until there are none left, if there is one. Runs on the
+// recording thread and on worker threads. Returns true if this call drew the frame's last tile.
+static bool
+draw_claimed_tiles(autk_tiler_t *tiler)
+{
+    uint64_t work;
+    uint32_t slot;
+    uint32_t count;
+    bool last = false;
+
+    // Claiming a slot and reading the frame's tile count is one atomic step, so a task that starts
+    // between frames claims nothing. A frame isn't over until its claimed tiles are done.
+    for (;;) {
+        work = atomic_fetch_add_explicit(&tiler->work, 1, memory_order_acquire);
+        slot = (uint32_t)work;
+        count = (uint32_t)(work >> 32);
+        if (slot >= count) {
+            return last;
+        }
+
+        draw_tile(tiler, slot);
+        last = atomic_fetch_add_explicit(&tiler->tiles_done, 1, memory_order_acq_rel) + 1 == count;
+    }
+}
+
+static void
+draw_tiles_exec(void *ctx)
+{
+    autk_tiler_t *tiler = ctx;
+
+    if (draw_claimed_tiles(tiler)) {
+        autk_semaphore_release(&tiler->helpers_done);
+    }
+}
+
+// Called once a helper task is done with the tiler, or if it couldn't be queued.
+static void
+draw_tiles_fini(void *ctx)
+{
+    autk_tiler_t *tiler = ctx;
+
+    if (atomic_fetch_sub_explicit(&tiler->queued_helpers, 1, memory_order_acq_rel)
+        == (HELPERS_FINISHING | 1))
+    {
+        autk_semaphore_release(&tiler->helpers_done);
+    }
+}
+
+static void
+draw_tiles(autk_tiler_t *tiler)
+{
+    autk_thread_pool_t *pool = tiler->instance->thread_pool;
+    autk_device_t *device = tiler->surface->device;
+    uint32_t count = tiler->dirty_tile_count;
+    uint32_t helper_count = 0;
+    uint32_t queued;
+    autk_task_params_t task_params = {
+        .struct_size = sizeof(autk_task_params_t),
+        .ctx = tiler,
+        .exec = &draw_tiles_exec,
+        .fini = &draw_tiles_fini,
+    };
+
+    if (!count) {
+        return;
+    }
+
+    // Only hand tiles to worker threads if there's more than one, and the device can draw them
+    // concurrently. Helpers still queued from earlier frames count, since they'll help with this
+    // one if they start in time, so a busy pool doesn't pile up tasks.
+    if (pool && count > 1 && (device->driver->flags & AUTK_DEVICE_DRIVER_FLAG_CONCURRENT_DRAWING)) {
+        helper_count = autk_uint32_min(pool->worker_count, count - 1);
+        queued = atomic_load_explicit(&tiler->queued_helpers, memory_order_relaxed);
+        helper_count = helper_count > queued ? helper_count - queued : 0;
+    }
+
+    atomic_store_explicit(&tiler->tiles_done, 0, memory_order_relaxed);
+    atomic_store_explicit(&tiler->work, (uint64_t)count << 32, memory_order_release);
+    atomic_fetch_add_explicit(&tiler->queued_helpers, helper_count, memory_order_relaxed);
+    for (uint32_t i = 0; i < helper_count; i++) {
+        autk_thread_pool_submit(pool, &task_params);
+    }
+
+    // The recording thread draws tiles too. Once every tile has been claimed, it only waits for
+    // helpers that are still drawing one, not for ones that haven't started.
+    if (!draw_claimed_tiles(tiler)) {
+        autk_semaphore_acquire(&tiler->helpers_done);
+    }
+    atomic_store_explicit(&tiler->work, 0, memory_order_relaxed);
+}
+
+// Forgets the tiler's reads from the sources of its recorded commands.
+static void
+release_sources(autk_tiler_t *tiler)
+{
+    autk_surface_t *src;
+
+    for (uint32_t i = 0; i < tiler->command_count; i++) {
+        src = tiler->commands[i].src;
+        if (src && src->reader == tiler) {
+            src->reader = NULL;
+        }
+    }
+}
+
+//==============================================================================
+//
+// Internal API
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_tiler_init(autk_tiler_t *tiler, autk_instance_t *instance)
+{
+    *tiler = (autk_tiler_t){.instance = instance};
+    return autk_semaphore_init(&tiler->helpers_done, 0);
+}
+
+AUTK_HIDDEN void
+autk_tiler_fini(autk_tiler_t *tiler)
+{
+    autk_tiler_discard(tiler);
+
+    // Helper tasks from the last frames may still be queued. Wait for the last one to finish with
+    // the tiler.
+    if (atomic_fetch_or_explicit(&tiler->queued_helpers, HELPERS_FINISHING, memory_order_acq_rel)) {
+        autk_semaphore_acquire(&tiler->helpers_done);
+    }
+
+    release(tiler->instance, (void **)&tiler->commands, &tiler->command_capacity,
+            sizeof(autk_tile_command_t));
+    release(tiler->instance, (void **)&tiler->tile_data, &tiler->tile_capacity, sizeof(uint32_t));
+    release(tiler->instance, (void **)&tiler->bin_entries, &tiler->bin_entry_capacity,
+            sizeof(uint32_t));
+    autk_semaphore_fini(&tiler->helpers_done);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_tiler_begin(autk_tiler_t *tiler, autk_surface_t *surface, const autk_bbox_t *rects,
+                 uint32_t rect_count)
+{
+    autk_bbox_t bounds = {0, 0, (int32_t)surface->width, (int32_t)surface->height};
+    size_t tile_count;
+    autk_bbox_t bbox;
+    autk_bbox_t range;
+
+    autk_tiler_end(tiler);
+
+    tiler->tiles_x = (uint32_t)((surface->width + AUTK_TILE_SIZE - 1) >> AUTK_TILE_SHIFT);
+    tiler->tiles_y = (uint32_t)((surface->height + AUTK_TILE_SIZE - 1) >> AUTK_TILE_SHIFT);
+    tile_count = (size_t)tiler->tiles_x * tiler->tiles_y;
+    if (tile_count >= UINT32_MAX / 3) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    // The per-tile arrays share one block, with room for the end of the last bin. Nothing in it is
+    // kept from the last frame.
+    AUTK_TRY(reserve(tiler->instance, (void **)&tiler->tile_data, &tiler->tile_capacity,
+                     (tile_count + 1) * 3, sizeof(uint32_t)));
+    tiler->tile_slots = tiler->tile_data;
+    tiler->dirty_tiles = tiler->tile_slots + tile_count + 1;
+    tiler->bin_offsets = tiler->dirty_tiles + tile_count + 1;
+
+    // Mark the tiles the damage touches, then number them in order.
+    memset(tiler->tile_slots, rects ? 0xFF : 0, tile_count * sizeof(uint32_t));
+    for (uint32_t i = 0; rects && i < rect_count; i++) {
+        bbox = rects[i];
+        if (!autk_bbox_intersect(&bbox, &bounds)) {
+            continue;
+        }
+
+        get_tile_range(&bbox, &range);
+        for (int32_t y = range.y0; y < range.y1; y++) {
+            for (int32_t x = range.x0; x < range.x1; x++) {
+                tiler->tile_slots[(size_t)y * tiler->tiles_x + (size_t)x] = 0;
+            }
+        }
+    }
+
+    tiler->dirty_tile_count = 0;
+    for (uint32_t tile = 0; tile < tile_count; tile++) {
+        if (tiler->tile_slots[tile] != CLEAN_TILE) {
+            tiler->tile_slots[tile] = tiler->dirty_tile_count;
+            tiler->dirty_tiles[tiler->dirty_tile_count++] = tile;
+        }
+    }
+
+    tiler->surface = surface;
+    surface->tiler = tiler;
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_tiler_end(autk_tiler_t *tiler)
+{
+    autk_tiler_flush(tiler);
+    autk_tiler_discard(tiler);
+}
+
+AUTK_HIDDEN void
+autk_tiler_discard(autk_tiler_t *tiler)
+{
+    if (tiler->surface) {
+        tiler->surface->tiler = NULL;
+    }
+    release_sources(tiler);
+    tiler->surface = NULL;
+    tiler->command_count = 0;
+    tiler->pending_bin_entries = 0;
+}
+
+AUTK_HIDDEN void
+autk_tiler_flush(autk_tiler_t *tiler)
+{
+    if (!tiler->surface || !tiler->command_count) {
+        return;
+    }
+
+    if (bin_commands(tiler) == AUTK_OK) {
+        draw_tiles(tiler);
+    } else {
+        // Without bins, draw everything directly. That might touch clean tiles, which is harmless.
+        for (uint32_t i = 0; i < tiler->command_count; i++) {
+            autk_tile_command_run(tiler->surface, &tiler->commands[i], &tiler->commands[i].bbox);
+        }
+    }
+
+    release_sources(tiler);
+    tiler->command_count = 0;
+    tiler->pending_bin_entries = 0;
+}
+
+AUTK_HIDDEN void
+autk_tiler_record(autk_tiler_t *tiler, const autk_tile_command_t *command)
+{
+    autk_bbox_t range;
+    uint64_t entries;
+
+    // Only one tiler at a time records reads from a surface, so the surface knows whom to flush
+    // before it changes.
+    if (command->src && command->src->reader && command->src->reader != tiler) {
+        autk_tiler_flush(command->src->reader);
+    }
+
+    get_tile_range(&command->bbox, &range);
+    entries = get_tile_range_area(&range);
+
+    if (tiler->pending_bin_entries + entries > MAX_BIN_ENTRIES
+        || tiler->command_count == UINT32_MAX)
+    {
+        autk_tiler_flush(tiler);
+    }
+
+    if (entries > MAX_BIN_ENTRIES
+        || reserve(tiler->instance, (void **)&tiler->commands, &tiler->command_capacity,
+                   (size_t)tiler->command_count + 1, sizeof(autk_tile_command_t))
+               != AUTK_OK)
+    {
+        // Too big to bin, or no room to record it: draw it now, after what came before it.
+        autk_tiler_flush(tiler);
+        autk_tile_command_run(tiler->surface, command, &command->bbox);
+        return;
+    }
+
+    tiler->commands[tiler->command_count++] = *command;
+    tiler->pending_bin_entries += entries;
+    if (command->src) {
+        command->src->reader = tiler;
+    }
+}
+
+AUTK_HIDDEN void
+autk_tile_command_run(autk_surface_t *surface, const autk_tile_command_t *command,
+                      const autk_bbox_t *clip)
+{
+    autk_device_t *device = surface->device;
+    autk_bbox_t bbox = command->bbox;
+    autk_bbox_t src_bbox;
+
+    if (!autk_bbox_intersect(&bbox, clip)) {
+        return;
+    }
+
+    switch (command->op) {
+        case AUTK_TILE_OP_FILL:
+            device->driver->fill_rect(device, device->driver_data, surface, &bbox, command->pixel);
+            break;
+
+        case AUTK_TILE_OP_BLEND:
+            device->driver->blend_rect(device, device->driver_data, surface, &bbox,
+                                       command->pixel);
+            break;
+
+        case AUTK_TILE_OP_COPY:
+        case AUTK_TILE_OP_BLEND_IMAGE:
+            src_bbox = (autk_bbox_t){
+                .x0 = command->src_x + (bbox.x0 - command->bbox.x0),
+                .y0 = command->src_y + (bbox.y0 - command->bbox.y0),
+                .x1 = command->src_x + (bbox.x1 - command->bbox.x0),
+                .y1 = command->src_y + (bbox.y1 - command->bbox.y0),
+            };
+            if (command->op == AUTK_TILE_OP_COPY) {
+                device->driver->copy_rect(device, device->driver_data, surface, bbox.x0, bbox.y0,
+                                          command->src, &src_bbox);
+            } else {
+                device->driver->blend_image(device, device->driver_data, surface, bbox.x0,
+                                            bbox.y0, command->src, &src_bbox);
+            }
+            break;
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_CORE_TILER_H_
+#define AUTK_CORE_TILER_H_
+
+#include <stdatomic.h>
+
+#include <os/types.h>
+
+#include "types.h"
+
+#define AUTK_TILE_SHIFT 6
+#define AUTK_TILE_SIZE (1 << AUTK_TILE_SHIFT) // width and height of a tile, in pixels
+
+typedef struct autk_tile_command autk_tile_command_t;
+typedef struct autk_tiler autk_tiler_t;
+
+typedef enum autk_tile_op {
+    AUTK_TILE_OP_FILL,
+    AUTK_TILE_OP_BLEND,
+    AUTK_TILE_OP_COPY,
+    AUTK_TILE_OP_BLEND_IMAGE,
+} autk_tile_op_t;
+
+// One device drawing call, already clipped.
+struct autk_tile_command {
+    autk_bbox_t bbox; // pixels written
+    autk_surface_t *src; // source of copies and image blends
+    int32_t src_x, src_y; // source of the top-left pixel of `bbox`
+    uint32_t pixel; // premultiplied color of fills and blends
+    autk_tile_op_t op;
+};
+
+// Records a frame's drawing into a surface, then draws it one tile at a time, on worker threads if
+// the instance has them and the device allows it. Each tile replays the commands that touch it in
+// the order they were recorded, so the result is the same as drawing them directly, whichever
+// threads draw which tiles. Only tiles touching the frame's damage are drawn.
+struct autk_tiler {
+    autk_instance_t *instance;
+    autk_surface_t *surface; // surface being recorded, or NULL
+    uint32_t tiles_x, tiles_y;
+
+    autk_tile_command_t *commands;
+    uint32_t command_count;
+    size_t command_capacity;
+    size_t pending_bin_entries; // upper bound on the bin entries the recorded commands need
+
+    // Dirty tiles, and the commands binned into each. Kept between frames.
+    uint32_t *tile_data; // holds the three per-tile arrays below
+    size_t tile_capacity; // in elements of `tile_data`
+    uint32_t *tile_slots; // for each tile, its index in `dirty_tiles`, or UINT32_MAX if clean
+    uint32_t *dirty_tiles; // tile indices, in order
+    uint32_t dirty_tile_count;
+    uint32_t *bin_offsets; // start of each dirty tile's commands in `bin_entries`, plus the end
+    uint32_t *bin_entries; // command indices
+    size_t bin_entry_capacity;
+
+    // Tiles are handed out to threads in order until none are left. Worker threads only help with
+    // a frame while it's being drawn, but their tasks can start late, or help with a later frame.
+    _Atomic uint64_t work; // tile count in the high half and next slot in the low, or zero
+    _Atomic uint32_t tiles_done;
+    _Atomic uint32_t queued_helpers; // helper tasks not yet finished; see `autk_tiler_fini()`
+    autk_semaphore_t helpers_done; // released by a helper that draws a frame's last tile
+};
+
+AUTK_HIDDEN autk_status_t
+autk_tiler_init(autk_tiler_t *tiler, autk_instance_t *instance);
+
+// Safe to call on a zeroed tiler, even if `autk_tiler_init()` was never called.
+AUTK_HIDDEN void
+autk_tiler_fini(autk_tiler_t *tiler);
+
+// Starts recording drawing into `surface`, which is damaged by `rects`, or all over if `rects` is
+// `NULL`. On failure, the surface is drawn into directly.
+AUTK_HIDDEN autk_status_t
+autk_tiler_begin(autk_tiler_t *tiler, autk_surface_t *surface, const autk_bbox_t *rects,
+                 uint32_t rect_count);
+
+// Draws what's been recorded and stops recording.
+AUTK_HIDDEN void
+autk_tiler_end(autk_tiler_t *tiler);
+
+// Stops recording without drawing anything, as when the surface is destroyed.
+AUTK_HIDDEN void
+autk_tiler_discard(autk_tiler_t *tiler);
+
+// Draws what's been recorded so far, and keeps recording.
+AUTK_HIDDEN void
+autk_tiler_flush(autk_tiler_t *tiler);
+
+// Queues a command for the tiles it touches. If it can't be queued, what's been recorded so far is
+// drawn, and then so is the command. A command's source is marked as being read by the tiler until
+// it's drawn, and whichever tiler was reading it before is flushed first.
+AUTK_HIDDEN void
+autk_tiler_record(autk_tiler_t *tiler, const autk_tile_command_t *command);
+
+// Draws the part of a command within `clip` into `surface` right away.
+AUTK_HIDDEN void
+autk_tile_command_run(autk_surface_t *surface, const autk_tile_command_t *command,
+                      const autk_bbox_t *clip);
+
+#endif // AUTK_CORE_TILER_H_
@@ -20,6 +20,9 @@
 #include <stdatomic.h>
 
 #include <autk/types.h>
+#include <utility/arena.h>
+#include <utility/frame_clock.h>
+#include <utility/timer_heap.h>
 
 enum autk_window_flags {
     AUTK_WINDOW_FLAG_EXPLICIT_BACKGROUND_COLOR = 1 << 0,
@@ -42,6 +45,12 @@ struct autk_client {
     uint16_t fallback_style_count;
     autk_style_t **fallback_styles;
 
+    // Timers, which are run by the driver's event loop
+    autk_timer_heap_t timers;
+
+    // Paces redraws, which drivers hold back until the next frame is due
+    autk_frame_clock_t frame_clock;
+
     void *driver_data;
     autk_device_t *device;
     void *user_data;
@@ -57,6 +66,28 @@ struct autk_device {
     void *user_data;
 };
 
+// Longest line, along either axis, that surfaces can step without overflow. Display lists check it
+// when recording, so a list can't hold a line that would fail when drawn.
+#define AUTK_MAX_LINE_SPAN (INT64_C(1) << 30)
+
+struct autk_surface {
+    autk_device_t *device;
+    size_t alloc_size;
+    uint32_t width, height;
+    size_t stride; // bytes between rows
+    uint32_t *pixels;
+    autk_bbox_t clip; // drawing is limited to this, which is always within the surface
+    struct autk_tiler *tiler; // records drawing to do later, or NULL to draw right away
+    struct autk_tiler *reader; // has recorded commands that read this surface, or NULL
+};
+
+struct autk_display_list {
+    autk_instance_t *instance;
+    autk_arena_t commands;
+    autk_bbox_t bounds; // of every command's bounding box
+    uint32_t command_count;
+};
+
 struct autk_instance {
     size_t alloc_size;
     autk_instance_create_flags_t flags;
@@ -64,6 +95,7 @@ struct autk_instance {
     void *alloc_ctx;
     autk_message_func_t message_func;
     void *message_ctx;
+    struct autk_thread_pool *thread_pool; // NULL if no worker threads were requested
     void *user_data;
 };
 
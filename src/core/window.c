@@ -222,6 +222,16 @@ autk_window_set_visible(autk_window_t *window, bool visible)
     return window->driver->set_visible(window, window->driver_data, visible);
 }
 
+AUTK_API autk_surface_t *
+autk_window_get_surface(autk_window_t *window)
+{
+    if (!window || !window->driver->get_surface) {
+        return NULL;
+    }
+
+    return window->driver->get_surface(window, window->driver_data);
+}
+
 AUTK_API void
 autk_window_callback_destroy(autk_window_t *window, void *unused)
 {
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <autk/device.h>
+#include <core/types.h>
+
+#include "kernels.h"
+
+// Pixels blended at a time through a temporary buffer when a surface is blended onto itself.
+#define OVERLAP_CHUNK_SIZE 256
+
+typedef struct autk_raster_device_data {
+    const autk_raster_kernels_t *kernels;
+} autk_raster_device_data_t;
+
+static inline uint32_t *
+get_row(autk_surface_t *surface, int32_t y)
+{
+    return (uint32_t *)((char *)surface->pixels + (size_t)y * surface->stride);
+}
+
+// Returns whether two equally sized rectangles of the same surface overlap.
+static bool
+transfer_overlaps(autk_surface_t *dst, int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                  const autk_bbox_t *src_bbox)
+{
+    return dst == src && dst_x < src_bbox->x1
+           && src_bbox->x0 < dst_x + (src_bbox->x1 - src_bbox->x0) && dst_y < src_bbox->y1
+           && src_bbox->y0 < dst_y + (src_bbox->y1 - src_bbox->y0);
+}
+
+static autk_status_t
+autk_raster_device_init_from_client(autk_device_t *device, void *opaque_device_data,
+                                    autk_client_t *client, void *client_driver_data,
+                                    const autk_client_create_params_t *client_params)
+{
+    autk_raster_device_data_t *device_data = opaque_device_data;
+
+    (void)device;
+    (void)client;
+    (void)client_driver_data;
+    (void)client_params;
+
+    device_data->kernels = autk_raster_select_kernels();
+    return AUTK_OK;
+}
+
+static void
+autk_raster_device_fill_rect(autk_device_t *device, void *opaque_device_data,
+                             autk_surface_t *surface, const autk_bbox_t *bbox, uint32_t pixel)
+{
+    autk_raster_device_data_t *device_data = opaque_device_data;
+    size_t width = (size_t)(bbox->x1 - bbox->x0);
+
+    (void)device;
+
+    for (int32_t y = bbox->y0; y < bbox->y1; y++) {
+        device_data->kernels->fill(get_row(surface, y) + bbox->x0, width, pixel);
+    }
+}
+
+static void
+autk_raster_device_blend_rect(autk_device_t *device, void *opaque_device_data,
+                              autk_surface_t *surface, const autk_bbox_t *bbox, uint32_t pixel)
+{
+    autk_raster_device_data_t *device_data = opaque_device_data;
+    size_t width = (size_t)(bbox->x1 - bbox->x0);
+
+    (void)device;
+
+    for (int32_t y = bbox->y0; y < bbox->y1; y++) {
+        device_data->kernels->blend_solid(get_row(surface, y) + bbox->x0, width, pixel);
+    }
+}
+
+static void
+autk_raster_device_copy_rect(autk_device_t *device, void *opaque_device_data, autk_surface_t *dst,
+                             int32_t dst_x, int32_t dst_y, autk_surface_t *src,
+                             const autk_bbox_t *src_bbox)
+{
+    size_t row_size = (size_t)(src_bbox->x1 - src_bbox->x0) * sizeof(uint32_t);
+    int32_t height = src_bbox->y1 - src_bbox->y0;
+
+    (void)device;
+    (void)opaque_device_data;
+
+    // Rows are copied with memmove(), which is already vectorized. When moving down within a
+    // surface, copy the bottom row first so no source row is overwritten before it's read.
+    if (dst == src && dst_y > src_bbox->y0) {
+        for (int32_t i = height - 1; i >= 0; i--) {
+            memmove(get_row(dst, dst_y + i) + dst_x, get_row(src, src_bbox->y0 + i) + src_bbox->x0,
+                    row_size);
+        }
+    } else {
+        for (int32_t i = 0; i < height; i++) {
+            memmove(get_row(dst, dst_y + i) + dst_x, get_row(src, src_bbox->y0 + i) + src_bbox->x0,
+                    row_size);
+        }
+    }
+}
+
+// Blends a surface onto an overlapping part of itself. Each piece of source is copied out before
+// it's blended, and rows and pieces are visited in an order that reads them before they're
+// overwritten.
+static void
+blend_overlapping(const autk_raster_kernels_t *kernels, autk_surface_t *surface, int32_t dst_x,
+                  int32_t dst_y, const autk_bbox_t *src_bbox)
+{
+    uint32_t chunk[OVERLAP_CHUNK_SIZE];
+    int32_t width = src_bbox->x1 - src_bbox->x0;
+    int32_t height = src_bbox->y1 - src_bbox->y0;
+    bool bottom_up = dst_y > src_bbox->y0;
+    bool right_to_left = dst_x > src_bbox->x0;
+
+    for (int32_t row = 0; row < height; row++) {
+        int32_t i = bottom_up ? height - 1 - row : row;
+        uint32_t *dst_row = get_row(surface, dst_y + i) + dst_x;
+        const uint32_t *src_row = get_row(surface, src_bbox->y0 + i) + src_bbox->x0;
+
+        for (int32_t done = 0; done < width; done += OVERLAP_CHUNK_SIZE) {
+            int32_t count = width - done < OVERLAP_CHUNK_SIZE ? width - done : OVERLAP_CHUNK_SIZE;
+            int32_t start = right_to_left ? width - done - count : done;
+
+            memcpy(chunk, src_row + start, (size_t)count * sizeof(uint32_t));
+            kernels->blend(dst_row + start, chunk, (size_t)count);
+        }
+    }
+}
+
+static void
+autk_raster_device_blend_image(autk_device_t *device, void *opaque_device_data,
+                               autk_surface_t *dst, int32_t dst_x, int32_t dst_y,
+                               autk_surface_t *src, const autk_bbox_t *src_bbox)
+{
+    autk_raster_device_data_t *device_data = opaque_device_data;
+    size_t width = (size_t)(src_bbox->x1 - src_bbox->x0);
+    int32_t height = src_bbox->y1 - src_bbox->y0;
+
+    (void)device;
+
+    if (transfer_overlaps(dst, dst_x, dst_y, src, src_bbox)) {
+        blend_overlapping(device_data->kernels, dst, dst_x, dst_y, src_bbox);
+        return;
+    }
+
+    for (int32_t i = 0; i < height; i++) {
+        device_data->kernels->blend(get_row(dst, dst_y + i) + dst_x,
+                                    get_row(src, src_bbox->y0 + i) + src_bbox->x0, width);
+    }
+}
+
+AUTK_API const autk_device_driver_t autk_device_driver_raster = {
+    .struct_size = sizeof(autk_device_driver_t),
+    .driver_data_size = sizeof(autk_raster_device_data_t),
+    .flags = AUTK_DEVICE_DRIVER_FLAG_CONCURRENT_DRAWING,
+
+    .init_from_client = autk_raster_device_init_from_client,
+    .fill_rect = autk_raster_device_fill_rect,
+    .blend_rect = autk_raster_device_blend_rect,
+    .copy_rect = autk_raster_device_copy_rect,
+    .blend_image = autk_raster_device_blend_image,
+};
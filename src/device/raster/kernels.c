@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "kernels.h"
+
+#if AUTK_RASTER_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+//==============================================================================
+//
+// Scalar kernels
+//
+//==============================================================================
+
+static void
+fill_scalar(uint32_t *dst, size_t count, uint32_t pixel)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = pixel;
+    }
+}
+
+static void
+blend_solid_scalar(uint32_t *dst, size_t count, uint32_t pixel)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = autk_raster_blend_pixel(dst[i], pixel);
+    }
+}
+
+static void
+blend_scalar(uint32_t *AUTK_RESTRICT dst, const uint32_t *AUTK_RESTRICT src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (src[i] >= 0xFF000000) {
+            dst[i] = src[i];
+        } else if (src[i]) {
+            dst[i] = autk_raster_blend_pixel(dst[i], src[i]);
+        }
+    }
+}
+
+AUTK_HIDDEN const autk_raster_kernels_t autk_raster_kernels_scalar = {
+    .name = "scalar",
+    .fill = fill_scalar,
+    .blend_solid = blend_solid_scalar,
+    .blend = blend_scalar,
+};
+
+//==============================================================================
+//
+// Kernel selection
+//
+//==============================================================================
+
+#if AUTK_RASTER_AVX2
+AUTK_HIDDEN bool
+autk_raster_cpu_has_avx2(void)
+{
+# ifdef __GNUC__
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+# else
+    int info[4];
+
+    // The OS must save the AVX registers (OSXSAVE, then XCR0 bits 1 and 2) as well as the CPU
+    // supporting them.
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+# endif
+}
+#endif
+
+AUTK_HIDDEN const autk_raster_kernels_t *
+autk_raster_select_kernels(void)
+{
+#if AUTK_RASTER_AVX2
+    if (autk_raster_kernels_avx2.is_supported()) {
+        return &autk_raster_kernels_avx2;
+    }
+#endif
+#if AUTK_RASTER_SSE2
+    return &autk_raster_kernels_sse2;
+#else
+    return &autk_raster_kernels_scalar;
+#endif
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_DEVICE_RASTER_KERNELS_H_
+#define AUTK_DEVICE_RASTER_KERNELS_H_
+
+#include <autk/types.h>
+
+// SSE2 is part of the x86-64 baseline, so its kernels are always usable there. AVX2 kernels are
+// built alongside them and chosen at runtime if the CPU supports them.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)                                    \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define AUTK_RASTER_SSE2 1
+#else
+# define AUTK_RASTER_SSE2 0
+#endif
+
+#if AUTK_RASTER_SSE2 && (defined(__GNUC__) || defined(_MSC_VER))
+# define AUTK_RASTER_AVX2 1
+#else
+# define AUTK_RASTER_AVX2 0
+#endif
+
+AUTK_BEGIN_DECLS
+
+// Span kernels for premultiplied 0xAARRGGBB pixels. Every set produces bit-identical results.
+typedef struct autk_raster_kernels {
+    const char *name;
+    // Returns whether the CPU can run these kernels, or NULL if it always can.
+    bool (*is_supported)(void);
+    // Sets `count` pixels to `pixel`.
+    void (*fill)(uint32_t *dst, size_t count, uint32_t pixel);
+    // Composites `pixel` over `count` pixels.
+    void (*blend_solid)(uint32_t *dst, size_t count, uint32_t pixel);
+    // Composites `count` pixels of `src` over `dst`.
+    void (*blend)(uint32_t *AUTK_RESTRICT dst, const uint32_t *AUTK_RESTRICT src, size_t count);
+} autk_raster_kernels_t;
+
+AUTK_HIDDEN extern const autk_raster_kernels_t autk_raster_kernels_scalar;
+#if AUTK_RASTER_SSE2
+AUTK_HIDDEN extern const autk_raster_kernels_t autk_raster_kernels_sse2;
+#endif
+#if AUTK_RASTER_AVX2
+AUTK_HIDDEN extern const autk_raster_kernels_t autk_raster_kernels_avx2;
+
+AUTK_HIDDEN bool
+autk_raster_cpu_has_avx2(void);
+#endif
+
+// Returns the fastest kernels the CPU supports.
+AUTK_HIDDEN const autk_raster_kernels_t *
+autk_raster_select_kernels(void);
+
+// Composites a premultiplied pixel over another. The scalar kernels and the tails of the vector
+// ones share this, so every kernel rounds the same way.
+static inline uint32_t
+autk_raster_blend_pixel(uint32_t dst, uint32_t src)
+{
+    uint32_t inv_alpha = 255 - (src >> 24);
+    uint32_t rb = (dst & 0x00FF00FF) * inv_alpha + 0x00800080;
+    uint32_t ag = (dst >> 8 & 0x00FF00FF) * inv_alpha + 0x00800080;
+
+    // Divide each 16-bit lane by 255, rounding to nearest. No lane carries into the next.
+    rb = (rb + (rb >> 8 & 0x00FF00FF)) >> 8 & 0x00FF00FF;
+    ag = (ag + (ag >> 8 & 0x00FF00FF)) >> 8 & 0x00FF00FF;
+
+    // Add the source with unsigned saturation, like the vector kernels.
+    rb += src & 0x00FF00FF;
+    ag += src >> 8 & 0x00FF00FF;
+    rb |= (rb >> 8 & 0x00010001) * 0xFF;
+    ag |= (ag >> 8 & 0x00010001) * 0xFF;
+
+    return (rb & 0x00FF00FF) | (ag & 0x00FF00FF) << 8;
+}
+
+AUTK_END_DECLS
+
+#endif // AUTK_DEVICE_RASTER_KERNELS_H_
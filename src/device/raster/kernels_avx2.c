@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "kernels.h"
+
+#if AUTK_RASTER_AVX2
+
+#include <immintrin.h>
+
+// The rest of the library is built for the baseline CPU, so only these functions may use AVX2, and
+// only once `autk_raster_cpu_has_avx2()` says so.
+#ifdef __GNUC__
+# define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+# define TARGET_AVX2
+#endif
+
+// Composites 8 premultiplied pixels over `dst`. See blend4() in kernels_sse2.c.
+static inline TARGET_AVX2 __m256i
+blend8(__m256i dst, __m256i src, __m256i inv_alpha_lo, __m256i inv_alpha_hi)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi16(0x80);
+    __m256i lo = _mm256_unpacklo_epi8(dst, zero);
+    __m256i hi = _mm256_unpackhi_epi8(dst, zero);
+
+    lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, inv_alpha_lo), bias);
+    hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, inv_alpha_hi), bias);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+    // Unpacking and packing both work within 128-bit lanes, so the pixels end up where they began.
+    return _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), src);
+}
+
+static inline TARGET_AVX2 __m256i
+inv_alpha_lanes(__m256i src_half)
+{
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src_half, 0xFF), 0xFF);
+
+    return _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+}
+
+static TARGET_AVX2 void
+fill_avx2(uint32_t *dst, size_t count, uint32_t pixel)
+{
+    __m256i value = _mm256_set1_epi32((int)pixel);
+    size_t i = 0;
+
+    for (; i < count && ((uintptr_t)(dst + i) & 31); i++) {
+        dst[i] = pixel;
+    }
+    for (; i + 16 <= count; i += 16) {
+        _mm256_store_si256((__m256i *)(dst + i), value);
+        _mm256_store_si256((__m256i *)(dst + i + 8), value);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_store_si256((__m256i *)(dst + i), value);
+    }
+    for (; i < count; i++) {
+        dst[i] = pixel;
+    }
+}
+
+static TARGET_AVX2 void
+blend_solid_avx2(uint32_t *dst, size_t count, uint32_t pixel)
+{
+    __m256i src = _mm256_set1_epi32((int)pixel);
+    __m256i inv_alpha = inv_alpha_lanes(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()));
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+
+        _mm256_storeu_si256((__m256i *)(dst + i), blend8(d, src, inv_alpha, inv_alpha));
+    }
+    for (; i < count; i++) {
+        dst[i] = autk_raster_blend_pixel(dst[i], pixel);
+    }
+}
+
+static TARGET_AVX2 void
+blend_avx2(uint32_t *AUTK_RESTRICT dst, const uint32_t *AUTK_RESTRICT src, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i inv_alpha_lo = inv_alpha_lanes(_mm256_unpacklo_epi8(s, zero));
+        __m256i inv_alpha_hi = inv_alpha_lanes(_mm256_unpackhi_epi8(s, zero));
+
+        _mm256_storeu_si256((__m256i *)(dst + i), blend8(d, s, inv_alpha_lo, inv_alpha_hi));
+    }
+    for (; i < count; i++) {
+        dst[i] = autk_raster_blend_pixel(dst[i], src[i]);
+    }
+}
+
+AUTK_HIDDEN const autk_raster_kernels_t autk_raster_kernels_avx2 = {
+    .name = "avx2",
+    .is_supported = autk_raster_cpu_has_avx2,
+    .fill = fill_avx2,
+    .blend_solid = blend_solid_avx2,
+    .blend = blend_avx2,
+};
+
+#endif // AUTK_RASTER_AVX2
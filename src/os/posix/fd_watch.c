@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <core/types.h>
+
+#include "fd_watch.h"
+
+#if AUTK_POSIX_FD_WATCH_EPOLL
+# include <sys/epoll.h>
+#endif
+
+#define MIN_POLL_FD_CAPACITY 8
+#define MAX_EPOLL_EVENTS 64 // per dispatch; any others are still ready on the next pass
+
+//==============================================================================
+//
+// Helpers
+//
+//==============================================================================
+
+static autk_status_t
+errno_to_status(int error)
+{
+    switch (error) {
+        case ENOMEM:
+        case ENOSPC:
+            return AUTK_ERR_OUT_OF_MEMORY;
+        case EBADF:
+        case EEXIST:
+        case EINVAL:
+        case ENOENT:
+        case EPERM:
+            return AUTK_ERR_INVALID_ARGUMENT;
+        default:
+            return AUTK_ERR_IO_FAILURE;
+    }
+}
+
+static autk_status_t
+reserve_poll_fds(autk_posix_fd_watch_set_t *set, size_t min_capacity)
+{
+    size_t capacity;
+    struct pollfd *poll_fds;
+
+    if (set->poll_fd_capacity >= min_capacity) {
+        return AUTK_OK;
+    }
+
+    capacity = set->poll_fd_capacity ? set->poll_fd_capacity : MIN_POLL_FD_CAPACITY;
+    while (capacity < min_capacity) {
+        if (capacity > SIZE_MAX / sizeof(struct pollfd) / 2) {
+            return AUTK_ERR_ARITHMETIC_OVERFLOW;
+        }
+        capacity *= 2;
+    }
+
+    poll_fds = autk_instance_alloc(set->instance, set->poll_fds,
+                                   set->poll_fd_capacity * sizeof(struct pollfd),
+                                   capacity * sizeof(struct pollfd), AUTK_MEMORY_TAG_LIST);
+    if (!poll_fds) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    set->poll_fds = poll_fds;
+    set->poll_fd_capacity = capacity;
+    return AUTK_OK;
+}
+
+static void
+free_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch)
+{
+    if (watch->fini) {
+        watch->fini(watch->ctx);
+    }
+    autk_instance_alloc(set->instance, watch, sizeof(autk_posix_fd_watch_t), 0,
+                        AUTK_MEMORY_TAG_LIST);
+}
+
+// Finalizes a watch that has been taken out of the set. A running watch is freed once its callback
+// returns.
+static void
+retire_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch)
+{
+    if (watch->running) {
+        watch->removed = true;
+    } else {
+        free_watch(set, watch);
+    }
+}
+
+static void
+run_watch(autk_posix_fd_watch_set_t *set, autk_client_t *client, autk_posix_fd_watch_t *watch,
+          autk_fd_events_t revents)
+{
+    revents &= watch->events | AUTK_FD_EVENT_ERROR | AUTK_FD_EVENT_HANGUP;
+    if (!revents) {
+        return;
+    }
+
+    watch->running = true;
+    watch->callback(watch->ctx, client, watch->fd, revents);
+    watch->running = false;
+
+    if (watch->removed) {
+        free_watch(set, watch);
+    }
+}
+
+//==============================================================================
+//
+// Backends
+//
+//==============================================================================
+
+#if AUTK_POSIX_FD_WATCH_EPOLL
+
+static uint32_t
+to_epoll_events(autk_fd_events_t events)
+{
+    uint32_t epoll_events = 0; // EPOLLERR and EPOLLHUP are always reported
+
+    if (events & AUTK_FD_EVENT_READABLE) {
+        epoll_events |= EPOLLIN;
+    }
+    if (events & AUTK_FD_EVENT_WRITABLE) {
+        epoll_events |= EPOLLOUT;
+    }
+    return epoll_events;
+}
+
+static autk_fd_events_t
+from_epoll_events(uint32_t epoll_events)
+{
+    autk_fd_events_t events = 0;
+
+    if (epoll_events & EPOLLIN) {
+        events |= AUTK_FD_EVENT_READABLE;
+    }
+    if (epoll_events & EPOLLOUT) {
+        events |= AUTK_FD_EVENT_WRITABLE;
+    }
+    if (epoll_events & EPOLLERR) {
+        events |= AUTK_FD_EVENT_ERROR;
+    }
+    if (epoll_events & EPOLLHUP) {
+        events |= AUTK_FD_EVENT_HANGUP;
+    }
+    return events;
+}
+
+static autk_status_t
+open_epoll(autk_posix_fd_watch_set_t *set)
+{
+    int epoll_fd;
+
+    if (set->epoll_fd >= 0) {
+        return AUTK_OK;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        return errno_to_status(errno);
+    }
+
+    set->epoll_fd = epoll_fd;
+    set->poll_fds[set->reserved_count] = (struct pollfd){.fd = epoll_fd, .events = POLLIN};
+    return AUTK_OK;
+}
+
+// Registers the watch's descriptor with the epoll instance, or updates its registration if the
+// watch replaces another.
+static autk_status_t
+register_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch,
+               const autk_posix_fd_watch_t *replaced)
+{
+    struct epoll_event event = {
+        .events = to_epoll_events(watch->events),
+        .data.fd = watch->fd,
+    };
+
+    if (replaced) {
+        if (epoll_ctl(set->epoll_fd, EPOLL_CTL_MOD, watch->fd, &event) == 0) {
+            return AUTK_OK;
+        } else if (errno != ENOENT) {
+            return errno_to_status(errno);
+        }
+        // The descriptor was closed and reopened without being unwatched, which dropped it from
+        // the epoll instance. Add it again.
+    }
+
+    if (epoll_ctl(set->epoll_fd, EPOLL_CTL_ADD, watch->fd, &event) != 0) {
+        return errno_to_status(errno);
+    }
+    return AUTK_OK;
+}
+
+static void
+unregister_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch)
+{
+    // Fails harmlessly if the descriptor was already closed.
+    epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, watch->fd, NULL);
+}
+
+static void
+dispatch_ready(autk_posix_fd_watch_set_t *set, autk_client_t *client)
+{
+    struct pollfd *poll_fd = &set->poll_fds[set->reserved_count];
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    autk_posix_fd_watch_t **watch;
+    int event_count;
+
+    if (!(poll_fd->revents & POLLIN)) {
+        poll_fd->revents = 0;
+        return;
+    }
+    poll_fd->revents = 0;
+
+    event_count = epoll_wait(set->epoll_fd, events, MAX_EPOLL_EVENTS, 0);
+    for (int i = 0; i < event_count; i++) {
+        // Look the watch up by descriptor, since an earlier callback may have removed or replaced
+        // it.
+        watch = autk_posix_fd_watch_table_find(&set->by_fd, (uint32_t)events[i].data.fd);
+        if (watch) {
+            run_watch(set, client, *watch, from_epoll_events(events[i].events));
+        }
+    }
+}
+
+#else // !AUTK_POSIX_FD_WATCH_EPOLL
+
+static short
+to_poll_events(autk_fd_events_t events)
+{
+    short poll_events = 0; // POLLERR, POLLHUP and POLLNVAL are always reported
+
+    if (events & AUTK_FD_EVENT_READABLE) {
+        poll_events |= POLLIN;
+    }
+    if (events & AUTK_FD_EVENT_WRITABLE) {
+        poll_events |= POLLOUT;
+    }
+    return poll_events;
+}
+
+static autk_fd_events_t
+from_poll_events(short poll_events)
+{
+    autk_fd_events_t events = 0;
+
+    if (poll_events & POLLIN) {
+        events |= AUTK_FD_EVENT_READABLE;
+    }
+    if (poll_events & POLLOUT) {
+        events |= AUTK_FD_EVENT_WRITABLE;
+    }
+    if (poll_events & (POLLERR | POLLNVAL)) {
+        events |= AUTK_FD_EVENT_ERROR;
+    }
+    if (poll_events & POLLHUP) {
+        events |= AUTK_FD_EVENT_HANGUP;
+    }
+    return events;
+}
+
+// Gives the watch a slot in `poll_fds`, or takes over the slot of the watch it replaces. The slot
+// must already be reserved.
+static autk_status_t
+register_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch,
+               const autk_posix_fd_watch_t *replaced)
+{
+    watch->poll_index = replaced ? replaced->poll_index : set->poll_fd_count++;
+    set->poll_fds[watch->poll_index] = (struct pollfd){
+        .fd = watch->fd,
+        .events = to_poll_events(watch->events),
+    };
+    return AUTK_OK;
+}
+
+// Moves the last slot into the watch's slot. The watch must already be out of the table.
+static void
+unregister_watch(autk_posix_fd_watch_set_t *set, autk_posix_fd_watch_t *watch)
+{
+    size_t last = --set->poll_fd_count;
+    autk_posix_fd_watch_t **moved;
+
+    if (watch->poll_index < last) {
+        set->poll_fds[watch->poll_index] = set->poll_fds[last];
+        moved = autk_posix_fd_watch_table_find(&set->by_fd, (uint32_t)set->poll_fds[last].fd);
+        (*moved)->poll_index = watch->poll_index;
+    }
+}
+
+static void
+dispatch_ready(autk_posix_fd_watch_set_t *set, autk_client_t *client)
+{
+    size_t i = set->poll_fd_count;
+    autk_posix_fd_watch_t **watch;
+    short revents;
+
+    // Walk downward, so that a callback that removes a watch can only move an already-visited slot
+    // into the removed one's place. Watches added by callbacks are appended past the ones we visit.
+    while (i > set->reserved_count) {
+        i--;
+        if (i >= set->poll_fd_count || !set->poll_fds[i].revents) {
+            continue;
+        }
+        revents = set->poll_fds[i].revents;
+        set->poll_fds[i].revents = 0;
+
+        watch = autk_posix_fd_watch_table_find(&set->by_fd, (uint32_t)set->poll_fds[i].fd);
+        run_watch(set, client, *watch, from_poll_events(revents));
+    }
+}
+
+#endif // !AUTK_POSIX_FD_WATCH_EPOLL
+
+//==============================================================================
+//
+// Watch set
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_init(autk_posix_fd_watch_set_t *set, autk_instance_t *instance,
+                             size_t reserved_count)
+{
+    size_t count = reserved_count;
+
+    *set = (autk_posix_fd_watch_set_t){
+        .instance = instance,
+        .reserved_count = reserved_count,
+    };
+    autk_posix_fd_watch_table_init(instance, &set->by_fd);
+
+#if AUTK_POSIX_FD_WATCH_EPOLL
+    set->epoll_fd = -1;
+    count++; // for the epoll instance
+#endif
+
+    AUTK_TRY(reserve_poll_fds(set, count));
+    for (size_t i = 0; i < count; i++) {
+        set->poll_fds[i] = (struct pollfd){.fd = -1};
+    }
+    set->poll_fd_count = count;
+
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_posix_fd_watch_set_fini(autk_posix_fd_watch_set_t *set)
+{
+    autk_hash_iter_t iter;
+    autk_posix_fd_watch_table_entry_t *entry;
+
+    if (autk_hash_table_begin(&set->by_fd.ht, &iter)) {
+        do {
+            entry = autk_hash_table_get(&set->by_fd.ht, iter);
+            free_watch(set, entry->value);
+        } while (autk_hash_table_next(&set->by_fd.ht, &iter));
+    }
+    autk_posix_fd_watch_table_fini(&set->by_fd);
+
+#if AUTK_POSIX_FD_WATCH_EPOLL
+    if (set->epoll_fd >= 0) {
+        close(set->epoll_fd);
+    }
+#endif
+    if (set->poll_fds) {
+        autk_instance_alloc(set->instance, set->poll_fds,
+                            set->poll_fd_capacity * sizeof(struct pollfd), 0,
+                            AUTK_MEMORY_TAG_LIST);
+    }
+    *set = (autk_posix_fd_watch_set_t){0};
+}
+
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_add(autk_posix_fd_watch_set_t *set, const autk_fd_watch_params_t *params)
+{
+    autk_posix_fd_watch_t *watch;
+    autk_posix_fd_watch_t **slot;
+    autk_posix_fd_watch_t *replaced;
+    bool inserted;
+    autk_status_t status;
+
+    // Make room for the watch before committing to anything.
+#if AUTK_POSIX_FD_WATCH_EPOLL
+    AUTK_TRY(open_epoll(set));
+#else
+    AUTK_TRY(reserve_poll_fds(set, set->poll_fd_count + 1));
+#endif
+
+    watch = autk_instance_alloc(set->instance, NULL, 0, sizeof(autk_posix_fd_watch_t),
+                                AUTK_MEMORY_TAG_LIST);
+    if (!watch) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+    *watch = (autk_posix_fd_watch_t){
+        .fd = params->fd,
+        .events = params->events,
+        .ctx = params->ctx,
+        .callback = params->callback,
+        .fini = params->fini,
+    };
+
+    status = autk_posix_fd_watch_table_insert(&set->by_fd, (uint32_t)params->fd, watch, &slot,
+                                              &inserted);
+    if (status != AUTK_OK) {
+        autk_instance_alloc(set->instance, watch, sizeof(autk_posix_fd_watch_t), 0,
+                            AUTK_MEMORY_TAG_LIST);
+        return status;
+    }
+    replaced = inserted ? NULL : *slot;
+
+    status = register_watch(set, watch, replaced);
+    if (status != AUTK_OK) {
+        if (inserted) {
+            autk_posix_fd_watch_table_remove(&set->by_fd, (uint32_t)params->fd, NULL);
+        }
+        autk_instance_alloc(set->instance, watch, sizeof(autk_posix_fd_watch_t), 0,
+                            AUTK_MEMORY_TAG_LIST);
+        return status;
+    }
+
+    if (replaced) {
+        *slot = watch;
+        retire_watch(set, replaced);
+    }
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_remove(autk_posix_fd_watch_set_t *set, int fd)
+{
+    autk_posix_fd_watch_t *watch;
+
+    if (!autk_posix_fd_watch_table_remove(&set->by_fd, (uint32_t)fd, &watch)) {
+        return AUTK_ERR_NOT_FOUND;
+    }
+
+    unregister_watch(set, watch);
+    retire_watch(set, watch);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN int
+autk_posix_fd_watch_set_get_fd(const autk_posix_fd_watch_set_t *set)
+{
+#if AUTK_POSIX_FD_WATCH_EPOLL
+    return set->epoll_fd;
+#else
+    (void)set;
+    return -1;
+#endif
+}
+
+AUTK_HIDDEN void
+autk_posix_fd_watch_set_dispatch(autk_posix_fd_watch_set_t *set, autk_client_t *client)
+{
+    dispatch_ready(set, client);
+}
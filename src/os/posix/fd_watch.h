@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_OS_POSIX_FD_WATCH_H_
+#define AUTK_OS_POSIX_FD_WATCH_H_
+
+#include <poll.h>
+
+#include <utility/hash.h>
+
+#if defined(__linux__)
+# define AUTK_POSIX_FD_WATCH_EPOLL 1
+#endif
+
+typedef struct autk_posix_fd_watch autk_posix_fd_watch_t;
+typedef struct autk_posix_fd_watch_set autk_posix_fd_watch_set_t;
+
+struct autk_posix_fd_watch {
+    int fd;
+    autk_fd_events_t events;
+    void *ctx;
+    void (*callback)(void *ctx, autk_client_t *client, int fd, autk_fd_events_t revents);
+    void (*fini)(void *ctx);
+#if !AUTK_POSIX_FD_WATCH_EPOLL
+    size_t poll_index; // slot in the set's `poll_fds`
+#endif
+    bool running; // set while the callback is running
+    bool removed; // set if the watch is removed or replaced while running
+};
+
+AUTK_DEFINE_HASH_TABLE(autk_posix_fd_watch_table, uint32_t, autk_posix_fd_watch_t *,
+                       autk_hash_uint32, autk_hash_uint32_eq)
+
+// File descriptor watches that share a `poll()` call with the owner's own descriptors. The first
+// `reserved_count` entries of `poll_fds` belong to the owner. On Linux, the watched descriptors are
+// registered with an epoll instance, which takes a single extra slot, so the cost of a wait doesn't
+// grow with the number of watches. Elsewhere, each watch has its own slot.
+struct autk_posix_fd_watch_set {
+    autk_instance_t *instance; // for allocation
+    autk_posix_fd_watch_table_t by_fd;
+    struct pollfd *poll_fds;
+    size_t poll_fd_count;
+    size_t poll_fd_capacity;
+    size_t reserved_count;
+#if AUTK_POSIX_FD_WATCH_EPOLL
+    int epoll_fd; // created with the first watch
+#endif
+};
+
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_init(autk_posix_fd_watch_set_t *set, autk_instance_t *instance,
+                             size_t reserved_count);
+
+// Finalizes all remaining watches.
+AUTK_HIDDEN void
+autk_posix_fd_watch_set_fini(autk_posix_fd_watch_set_t *set);
+
+// Watches `params->fd`, replacing any existing watch on it. Does not finalize the watch on failure.
+// The caller is responsible for that.
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_add(autk_posix_fd_watch_set_t *set, const autk_fd_watch_params_t *params);
+
+AUTK_HIDDEN autk_status_t
+autk_posix_fd_watch_set_remove(autk_posix_fd_watch_set_t *set, int fd);
+
+// Returns the descriptor to wait on for all watches at once, or -1 if there isn't one.
+AUTK_HIDDEN int
+autk_posix_fd_watch_set_get_fd(const autk_posix_fd_watch_set_t *set);
+
+// Returns the array to pass to `poll()`, whose first `reserved_count` entries the caller must fill
+// in. The array is only valid until the set is modified.
+static inline struct pollfd *
+autk_posix_fd_watch_set_get_poll_fds(autk_posix_fd_watch_set_t *set, size_t *out_count)
+{
+    *out_count = set->poll_fd_count;
+    return set->poll_fds;
+}
+
+// Runs the callbacks of the watches that `poll()` reported ready, then clears their `revents`.
+AUTK_HIDDEN void
+autk_posix_fd_watch_set_dispatch(autk_posix_fd_watch_set_t *set, autk_client_t *client);
+
+#endif // AUTK_OS_POSIX_FD_WATCH_H_
@@ -19,6 +19,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <stdint.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -29,23 +30,17 @@
 
 #include "job_queue.h"
 
-AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_init(autk_posix_job_queue_t *queue)
+#if AUTK_POSIX_JOB_QUEUE_EVENTFD
+# include <sys/eventfd.h>
+#endif
+
+static autk_status_t
+open_wakeup_pipe(autk_posix_job_queue_t *queue)
 {
     int pipe_fds[2];
     int flags;
 
-    *queue = (autk_posix_job_queue_t){
-        .wakeup_read_fd = -1,
-        .wakeup_write_fd = -1,
-    };
-
-    // Initialize the underlying queue.
-    AUTK_TRY(autk_job_queue_init(&queue->queue));
-
-    // Initialize the wakeup pipe.
     if (pipe(pipe_fds) != 0) {
-        autk_posix_job_queue_fini(queue);
         return AUTK_ERR_IO_FAILURE;
     }
 
@@ -55,14 +50,12 @@ autk_posix_job_queue_init(autk_posix_job_queue_t *queue)
     for (int i = 0; i < 2; i++) {
         // Do not share the pipe with child processes.
         if (fcntl(pipe_fds[i], F_SETFD, FD_CLOEXEC) == -1) {
-            autk_posix_job_queue_fini(queue);
             return AUTK_ERR_IO_FAILURE;
         }
 
         // Make the pipe non-blocking.
         flags = fcntl(pipe_fds[i], F_GETFL, 0);
         if (flags == -1 || fcntl(pipe_fds[i], F_SETFL, flags | O_NONBLOCK) == -1) {
-            autk_posix_job_queue_fini(queue);
             return AUTK_ERR_IO_FAILURE;
         }
     }
@@ -70,93 +63,165 @@ autk_posix_job_queue_init(autk_posix_job_queue_t *queue)
     return AUTK_OK;
 }
 
+AUTK_HIDDEN autk_status_t
+autk_posix_job_queue_init(autk_posix_job_queue_t *queue, autk_instance_t *instance)
+{
+    autk_status_t status;
+
+    *queue = (autk_posix_job_queue_t){
+        .wakeup_read_fd = -1,
+        .wakeup_write_fd = -1,
+    };
+
+    // Initialize the underlying queue.
+    AUTK_TRY(autk_job_queue_init(&queue->queue, instance));
+
+    // Initialize the wakeup descriptor. Prefer an eventfd, since it needs one descriptor instead of
+    // two and never fills up, but fall back to a pipe if the kernel doesn't support it.
+#if AUTK_POSIX_JOB_QUEUE_EVENTFD
+    queue->wakeup_read_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (queue->wakeup_read_fd >= 0) {
+        queue->wakeup_write_fd = queue->wakeup_read_fd;
+        return AUTK_OK;
+    }
+#endif
+
+    status = open_wakeup_pipe(queue);
+    if (status != AUTK_OK) {
+        autk_posix_job_queue_fini(queue);
+        return status;
+    }
+
+    return AUTK_OK;
+}
+
 AUTK_HIDDEN void
 autk_posix_job_queue_fini(autk_posix_job_queue_t *queue)
 {
     autk_job_queue_fini(&queue->queue);
 
+    if (queue->wakeup_write_fd >= 0 && queue->wakeup_write_fd != queue->wakeup_read_fd) {
+        close(queue->wakeup_write_fd);
+    }
+    queue->wakeup_write_fd = -1;
     if (queue->wakeup_read_fd >= 0) {
         close(queue->wakeup_read_fd);
         queue->wakeup_read_fd = -1;
     }
-    if (queue->wakeup_write_fd >= 0) {
-        close(queue->wakeup_write_fd);
-        queue->wakeup_write_fd = -1;
+}
+
+// Pairs with the fence in `autk_posix_job_queue_poll()`: either the consumer sees our job before it
+// sleeps, or we see that it's sleeping. Only the first producer to see that wakes it up.
+static autk_status_t
+wake_consumer(autk_posix_job_queue_t *queue)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->sleeping, memory_order_relaxed)
+        && atomic_exchange_explicit(&queue->sleeping, false, memory_order_relaxed))
+    {
+        return autk_posix_job_queue_wakeup(queue);
     }
+
+    return AUTK_OK;
 }
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_try_push(autk_posix_job_queue_t *queue, autk_job_t job, bool *queued)
+autk_posix_job_queue_push(autk_posix_job_queue_t *queue, const autk_job_t *jobs, size_t job_count,
+                          size_t *out_pushed_count)
 {
-    *queued = false;
-    AUTK_TRY(autk_job_queue_try_push(&queue->queue, job));
-    *queued = true;
-    return autk_posix_job_queue_wakeup(queue);
+    autk_status_t status;
+
+    status = autk_job_queue_push(&queue->queue, jobs, job_count, out_pushed_count);
+    if (*out_pushed_count == 0) {
+        return status;
+    }
+
+    AUTK_TRY(wake_consumer(queue));
+    return status;
 }
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_push(autk_posix_job_queue_t *queue, autk_job_t job, bool *queued)
+autk_posix_job_queue_push_data(autk_posix_job_queue_t *queue, const autk_job_t *job,
+                               const void *data, size_t data_size, bool *out_pushed)
 {
-    *queued = false;
-    AUTK_TRY(autk_job_queue_push(&queue->queue, job));
-    *queued = true;
-    return autk_posix_job_queue_wakeup(queue);
+    *out_pushed = false;
+    AUTK_TRY(autk_job_queue_push_data(&queue->queue, job, data, data_size));
+    *out_pushed = true;
+    return wake_consumer(queue);
 }
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_try_pop(autk_posix_job_queue_t *queue, autk_job_t *out_job,
-                             autk_instance_t *message_instance)
+autk_posix_job_queue_try_pop(autk_posix_job_queue_t *queue, autk_job_queue_item_t *out_item)
+{
+    return autk_job_queue_try_pop(&queue->queue, out_item);
+}
+
+AUTK_HIDDEN void
+autk_posix_job_queue_release(autk_posix_job_queue_t *queue, autk_job_queue_item_t *item)
 {
-    return autk_job_queue_try_pop(&queue->queue, out_job, message_instance);
+    autk_job_queue_release(&queue->queue, item);
 }
 
 static autk_status_t
-drain_wakeup_pipe(autk_posix_job_queue_t *queue)
+drain_wakeup_fd(autk_posix_job_queue_t *queue)
 {
-    char buf[64]; // size is arbitrary
+    char buf[64]; // size is arbitrary, but must fit an eventfd counter
+    ssize_t read_result;
 
-    while (1) {
-        ssize_t read_result = read(queue->wakeup_read_fd, buf, sizeof(buf));
-        if (read_result == 0) {
-            if (read_result == sizeof(buf)) {
-                continue;
-            }
-            return AUTK_OK;
-        } else if (read_result < 0) {
-            switch (errno) {
-                case EAGAIN:
-                case EINTR:
+    // An eventfd is reset by a single read. A pipe may hold more than one wakeup byte, although
+    // that's rare now that wakeups are coalesced.
+    do {
+        read_result = read(queue->wakeup_read_fd, buf, sizeof(buf));
+    } while (read_result > 0 && queue->wakeup_read_fd != queue->wakeup_write_fd);
+
+    if (read_result < 0) {
+        switch (errno) {
+            case EAGAIN:
+            case EINTR:
 #if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
-                case EWOULDBLOCK:
+            case EWOULDBLOCK:
 #endif
-                    return AUTK_OK;
-                default:
-                    return AUTK_ERR_IO_FAILURE;
-            }
+                return AUTK_OK;
+            default:
+                return AUTK_ERR_IO_FAILURE;
         }
     }
+
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN bool
+autk_posix_job_queue_begin_wait(autk_posix_job_queue_t *queue)
+{
+    // Tell producers we're going to sleep, then make sure nothing was pushed before they could see
+    // it.
+    atomic_store_explicit(&queue->sleeping, true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    return !autk_job_queue_is_empty(&queue->queue);
 }
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, int display_fd, int timeout,
-                          int *queue_result, int *display_result)
+autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, struct pollfd *poll_fds,
+                          size_t poll_fd_count, int timeout, int *queue_result)
 {
-    struct pollfd poll_fds[2] = {
-        {.fd = queue->wakeup_read_fd, .events = POLLIN},
-        {.fd = display_fd, .events = POLLIN},
-    };
-    nfds_t nfds = 1;
     int poll_result;
 
     *queue_result = 0;
-    *display_result = 0;
+    poll_fds[0] = (struct pollfd){.fd = queue->wakeup_read_fd, .events = POLLIN};
+    for (size_t i = 1; i < poll_fd_count; i++) {
+        poll_fds[i].revents = 0;
+    }
 
-    if (display_fd >= 0) {
-        nfds++;
+    // If something was pushed already, there's no point in sleeping, but still check the other
+    // descriptors.
+    if (autk_posix_job_queue_begin_wait(queue)) {
+        *queue_result = 1;
+        timeout = 0;
     }
 
     // Wait for input.
-    poll_result = poll(poll_fds, nfds, timeout);
+    poll_result = poll(poll_fds, (nfds_t)poll_fd_count, timeout);
+    atomic_store_explicit(&queue->sleeping, false, memory_order_relaxed);
     if (poll_result < 0) {
         switch (errno) {
             case EINTR:
@@ -165,24 +230,15 @@ autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, int display_fd, int tim
                 return AUTK_ERR_IO_FAILURE;
         }
     } else if (poll_result == 0) {
-        return AUTK_ERR_TIMEOUT;
+        return *queue_result ? AUTK_OK : AUTK_ERR_TIMEOUT;
     }
 
-    // Check each fd for errors.
-    if (poll_fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-        *queue_result = -1;
-    }
-    if (display_fd >= 0 && (poll_fds[1].revents & (POLLERR | POLLHUP | POLLNVAL))) {
-        *display_result = -1;
-    }
-
-    // Check each fd for input. Overwrite error results.
+    // Check the wakeup descriptor. Input overrides errors.
     if (poll_fds[0].revents & POLLIN) {
         *queue_result = 1;
-        AUTK_TRY(drain_wakeup_pipe(queue));
-    }
-    if (display_fd >= 0 && poll_fds[1].revents & POLLIN) {
-        *display_result = 1;
+        AUTK_TRY(drain_wakeup_fd(queue));
+    } else if (poll_fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        *queue_result = -1;
     }
 
     return AUTK_OK;
@@ -191,8 +247,10 @@ autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, int display_fd, int tim
 AUTK_HIDDEN autk_status_t
 autk_posix_job_queue_wakeup(autk_posix_job_queue_t *queue)
 {
+    static const uint64_t one = 1; // an eventfd needs an 8-byte counter increment
+
     while (1) {
-        if (write(queue->wakeup_write_fd, "", 1) >= 0) {
+        if (write(queue->wakeup_write_fd, &one, sizeof(one)) >= 0) {
             return AUTK_OK;
         } else {
             switch (errno) {
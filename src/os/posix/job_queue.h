@@ -17,36 +17,68 @@
 #ifndef AUTK_OS_POSIX_JOB_QUEUE_H_
 #define AUTK_OS_POSIX_JOB_QUEUE_H_
 
+#include <poll.h>
+#include <stdatomic.h>
+
 #include <utility/job_queue.h>
 
+#if defined(__linux__)
+# define AUTK_POSIX_JOB_QUEUE_EVENTFD 1
+#endif
+
 typedef struct autk_posix_job_queue autk_posix_job_queue_t;
 
+// Job queue whose consumer can block in `poll()` alongside other file descriptors. Producers only
+// signal the wakeup descriptor when the consumer has announced that it's about to sleep, so a burst
+// of posts costs at most one system call. On Linux the wakeup descriptor is an eventfd, in which
+// case `wakeup_read_fd` and `wakeup_write_fd` are the same descriptor; elsewhere it's a pipe.
 struct autk_posix_job_queue {
     autk_job_queue_t queue;
     int wakeup_read_fd;
     int wakeup_write_fd;
+    _Atomic bool sleeping; // set by the consumer while it's blocked (or about to block) in poll()
 };
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_init(autk_posix_job_queue_t *queue);
+autk_posix_job_queue_init(autk_posix_job_queue_t *queue, autk_instance_t *instance);
 
 AUTK_HIDDEN void
 autk_posix_job_queue_fini(autk_posix_job_queue_t *queue);
 
+// Pushes jobs and wakes the consumer if it's sleeping. See `autk_job_queue_push()`.
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_try_push(autk_posix_job_queue_t *queue, autk_job_t job, bool *queued);
+autk_posix_job_queue_push(autk_posix_job_queue_t *queue, const autk_job_t *jobs, size_t job_count,
+                          size_t *out_pushed_count);
 
+// Pushes a job with a copy of `data` and wakes the consumer if it's sleeping. See
+// `autk_job_queue_push_data()`. `*out_pushed` tells whether the job was queued, since waking the
+// consumer can still fail afterward.
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_push(autk_posix_job_queue_t *queue, autk_job_t job, bool *queued);
+autk_posix_job_queue_push_data(autk_posix_job_queue_t *queue, const autk_job_t *job,
+                               const void *data, size_t data_size, bool *out_pushed);
 
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_try_pop(autk_posix_job_queue_t *queue, autk_job_t *out_job,
-                             autk_instance_t *message_instance);
+autk_posix_job_queue_try_pop(autk_posix_job_queue_t *queue, autk_job_queue_item_t *out_item);
+
+AUTK_HIDDEN void
+autk_posix_job_queue_release(autk_posix_job_queue_t *queue, autk_job_queue_item_t *item);
+
+// Must only be called from the consumer thread. Announces that the consumer is about to wait on
+// `wakeup_read_fd`, so producers will signal it from now on. Returns true if jobs were already
+// pushed, in which case the consumer shouldn't block. The flag is cleared by the next call to
+// `autk_posix_job_queue_poll()`.
+AUTK_HIDDEN bool
+autk_posix_job_queue_begin_wait(autk_posix_job_queue_t *queue);
 
+// Waits up to `timeout` milliseconds on the wakeup descriptor, which is stored in `poll_fds[0]`,
+// and the caller's other `poll_fd_count - 1` descriptors, whose `revents` the caller checks
+// afterward. Negative descriptors are ignored, as with `poll()`. `*queue_result` is 1 if jobs are
+// ready, -1 if the wakeup descriptor failed, or 0 otherwise.
 AUTK_HIDDEN autk_status_t
-autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, int display_fd, int timeout,
-                          int *queue_result, int *display_result);
+autk_posix_job_queue_poll(autk_posix_job_queue_t *queue, struct pollfd *poll_fds,
+                          size_t poll_fd_count, int timeout, int *queue_result);
 
+// Signals the wakeup descriptor unconditionally.
 AUTK_HIDDEN autk_status_t
 autk_posix_job_queue_wakeup(autk_posix_job_queue_t *queue);
 
@@ -14,12 +14,357 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#ifdef __linux__
+# define _GNU_SOURCE // for syscall()
+#endif
+
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <semaphore.h>
+#include <stdatomic.h>
+
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
 
 #include <os/sync.h>
 
+// Number of times to retry an uncontended fast path before going to sleep.
+#define SPIN_COUNT 64
+
+static inline void
+cpu_relax(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#ifdef AUTK_OS_FUTEX
+
+//==============================================================================
+//
+// Futex primitives
+//
+//==============================================================================
+
+// Sleeps as long as `*addr == expected`. May return early for any reason, so callers recheck.
+static void
+futex_wait(_Atomic uint32_t *addr, uint32_t expected)
+{
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void
+futex_wake(_Atomic uint32_t *addr, int count)
+{
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+//==============================================================================
+//
+// Semaphore
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_semaphore_init(autk_semaphore_t *sem, uint32_t value)
+{
+    atomic_init(&sem->value, value);
+    atomic_init(&sem->waiter_count, 0);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_semaphore_fini(autk_semaphore_t *sem)
+{
+    assert(atomic_load_explicit(&sem->waiter_count, memory_order_relaxed) == 0);
+    (void)sem;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_semaphore_try_acquire(autk_semaphore_t *sem)
+{
+    uint32_t value = atomic_load_explicit(&sem->value, memory_order_relaxed);
+
+    while (value > 0) {
+        if (atomic_compare_exchange_weak_explicit(&sem->value, &value, value - 1,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            return AUTK_OK;
+        }
+    }
+
+    return AUTK_ERR_WOULD_BLOCK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_semaphore_acquire(autk_semaphore_t *sem)
+{
+    for (int i = 0; i < SPIN_COUNT; i++) {
+        if (autk_semaphore_try_acquire(sem) == AUTK_OK) {
+            return AUTK_OK;
+        }
+        cpu_relax();
+    }
+
+    // Announce ourselves before the final check, so that a release either leaves a count for us to
+    // take or sees that it has to wake us. The kernel rechecks `value` before we actually sleep.
+    atomic_fetch_add_explicit(&sem->waiter_count, 1, memory_order_seq_cst);
+    while (autk_semaphore_try_acquire(sem) != AUTK_OK) {
+        futex_wait(&sem->value, 0);
+    }
+    atomic_fetch_sub_explicit(&sem->waiter_count, 1, memory_order_relaxed);
+
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_semaphore_release(autk_semaphore_t *sem)
+{
+    if (atomic_fetch_add_explicit(&sem->value, 1, memory_order_seq_cst) == UINT32_MAX) {
+        atomic_fetch_sub_explicit(&sem->value, 1, memory_order_relaxed);
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
+    }
+
+    if (atomic_load_explicit(&sem->waiter_count, memory_order_seq_cst) > 0) {
+        futex_wake(&sem->value, 1);
+    }
+
+    return AUTK_OK;
+}
+
+//==============================================================================
+//
+// Mutex
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_mutex_init(autk_mutex_t *mutex)
+{
+    atomic_init(&mutex->state, 0);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_mutex_fini(autk_mutex_t *mutex)
+{
+    assert(atomic_load_explicit(&mutex->state, memory_order_relaxed) == 0);
+    (void)mutex;
+}
+
+// Takes the lock, marking it as contended so the eventual unlock wakes the next waiter.
+static void
+lock_contended(autk_mutex_t *mutex)
+{
+    while (atomic_exchange_explicit(&mutex->state, 2, memory_order_acquire) != 0) {
+        futex_wait(&mutex->state, 2);
+    }
+}
+
+AUTK_HIDDEN void
+autk_mutex_lock(autk_mutex_t *mutex)
+{
+    uint32_t state;
+
+    for (int i = 0; i < SPIN_COUNT; i++) {
+        state = 0;
+        if (atomic_compare_exchange_weak_explicit(&mutex->state, &state, 1, memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            return;
+        } else if (state == 2) {
+            // Someone is already asleep; spinning won't get us ahead of them.
+            break;
+        }
+        cpu_relax();
+    }
+
+    lock_contended(mutex);
+}
+
+AUTK_HIDDEN bool
+autk_mutex_try_lock(autk_mutex_t *mutex)
+{
+    uint32_t state = 0;
+
+    return atomic_compare_exchange_strong_explicit(&mutex->state, &state, 1, memory_order_acquire,
+                                                   memory_order_relaxed);
+}
+
+AUTK_HIDDEN void
+autk_mutex_unlock(autk_mutex_t *mutex)
+{
+    if (atomic_exchange_explicit(&mutex->state, 0, memory_order_release) == 2) {
+        futex_wake(&mutex->state, 1);
+    }
+}
+
+//==============================================================================
+//
+// Condition variable
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_cond_init(autk_cond_t *cond)
+{
+    atomic_init(&cond->seq, 0);
+    atomic_init(&cond->waiter_count, 0);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_cond_fini(autk_cond_t *cond)
+{
+    (void)cond;
+}
+
+// Reading `seq` before unlocking means a signal sent after we unlock changes it, so the kernel
+// won't let us sleep through it.
+AUTK_HIDDEN void
+autk_cond_wait(autk_cond_t *cond, autk_mutex_t *mutex)
+{
+    uint32_t seq;
+
+    atomic_fetch_add_explicit(&cond->waiter_count, 1, memory_order_seq_cst);
+    seq = atomic_load_explicit(&cond->seq, memory_order_seq_cst);
+    autk_mutex_unlock(mutex);
+
+    futex_wait(&cond->seq, seq);
+
+    atomic_fetch_sub_explicit(&cond->waiter_count, 1, memory_order_relaxed);
+    lock_contended(mutex);
+}
+
+static void
+wake_cond(autk_cond_t *cond, int count)
+{
+    atomic_fetch_add_explicit(&cond->seq, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&cond->waiter_count, memory_order_seq_cst) > 0) {
+        futex_wake(&cond->seq, count);
+    }
+}
+
+AUTK_HIDDEN void
+autk_cond_signal(autk_cond_t *cond)
+{
+    wake_cond(cond, 1);
+}
+
+AUTK_HIDDEN void
+autk_cond_broadcast(autk_cond_t *cond)
+{
+    wake_cond(cond, INT_MAX);
+}
+
+//==============================================================================
+//
+// Event
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_event_init(autk_event_t *event)
+{
+    atomic_init(&event->state, 0);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_event_fini(autk_event_t *event)
+{
+    (void)event;
+}
+
+AUTK_HIDDEN void
+autk_event_set(autk_event_t *event)
+{
+    if (atomic_exchange_explicit(&event->state, 2, memory_order_release) == 1) {
+        futex_wake(&event->state, INT_MAX);
+    }
+}
+
+AUTK_HIDDEN bool
+autk_event_is_set(autk_event_t *event)
+{
+    return atomic_load_explicit(&event->state, memory_order_acquire) == 2;
+}
+
+AUTK_HIDDEN void
+autk_event_wait(autk_event_t *event)
+{
+    uint32_t state;
+
+    for (int i = 0; i < SPIN_COUNT; i++) {
+        if (autk_event_is_set(event)) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    for (;;) {
+        state = atomic_load_explicit(&event->state, memory_order_acquire);
+        if (state == 2) {
+            return;
+        } else if (state == 0
+                   && !atomic_compare_exchange_weak_explicit(&event->state, &state, 1,
+                                                             memory_order_acquire,
+                                                             memory_order_acquire)) {
+            continue;
+        }
+        futex_wait(&event->state, 1);
+    }
+}
+
+//==============================================================================
+//
+// Call-once
+//
+//==============================================================================
+
+AUTK_HIDDEN void
+autk_call_once(autk_once_t *once, void (*func)(void *arg), void *arg)
+{
+    uint32_t state = 0;
+
+    if (atomic_load_explicit(&once->state, memory_order_acquire) == 3) {
+        return;
+    }
+
+    if (atomic_compare_exchange_strong_explicit(&once->state, &state, 1, memory_order_acquire,
+                                                memory_order_acquire)) {
+        func(arg);
+        if (atomic_exchange_explicit(&once->state, 3, memory_order_release) == 2) {
+            futex_wake(&once->state, INT_MAX);
+        }
+        return;
+    }
+
+    // Someone else is running `func`. Wait for them to finish.
+    while (state != 3) {
+        if (state == 1
+            && !atomic_compare_exchange_weak_explicit(&once->state, &state, 2,
+                                                      memory_order_acquire, memory_order_acquire)) {
+            continue;
+        }
+        futex_wait(&once->state, 2);
+        state = atomic_load_explicit(&once->state, memory_order_acquire);
+    }
+}
+
+#else // !AUTK_OS_FUTEX
+
+//==============================================================================
+//
+// Semaphore
+//
+//==============================================================================
+
 AUTK_HIDDEN autk_status_t
 autk_semaphore_init(autk_semaphore_t *sem, uint32_t value)
 {
@@ -71,6 +416,13 @@ autk_semaphore_acquire(autk_semaphore_t *sem)
 {
     assert(sem->was_init);
 
+    for (int i = 0; i < SPIN_COUNT; i++) {
+        if (sem_trywait(&sem->handle) == 0) {
+            return AUTK_OK;
+        }
+        cpu_relax();
+    }
+
     if (sem_wait(&sem->handle) != 0) {
         switch (errno) {
             case EINTR:
@@ -96,3 +448,175 @@ autk_semaphore_release(autk_semaphore_t *sem)
 
     return AUTK_OK;
 }
+
+//==============================================================================
+//
+// Mutex
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_mutex_init(autk_mutex_t *mutex)
+{
+    switch (pthread_mutex_init(&mutex->handle, NULL)) {
+        case 0:
+            return AUTK_OK;
+        case ENOMEM:
+            return AUTK_ERR_OUT_OF_MEMORY;
+        default:
+            return AUTK_ERR_RUNTIME_FAILURE;
+    }
+}
+
+AUTK_HIDDEN void
+autk_mutex_fini(autk_mutex_t *mutex)
+{
+    pthread_mutex_destroy(&mutex->handle);
+}
+
+AUTK_HIDDEN void
+autk_mutex_lock(autk_mutex_t *mutex)
+{
+    for (int i = 0; i < SPIN_COUNT; i++) {
+        if (pthread_mutex_trylock(&mutex->handle) == 0) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    pthread_mutex_lock(&mutex->handle);
+}
+
+AUTK_HIDDEN bool
+autk_mutex_try_lock(autk_mutex_t *mutex)
+{
+    return pthread_mutex_trylock(&mutex->handle) == 0;
+}
+
+AUTK_HIDDEN void
+autk_mutex_unlock(autk_mutex_t *mutex)
+{
+    pthread_mutex_unlock(&mutex->handle);
+}
+
+//==============================================================================
+//
+// Condition variable
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_cond_init(autk_cond_t *cond)
+{
+    switch (pthread_cond_init(&cond->handle, NULL)) {
+        case 0:
+            return AUTK_OK;
+        case ENOMEM:
+            return AUTK_ERR_OUT_OF_MEMORY;
+        default:
+            return AUTK_ERR_RUNTIME_FAILURE;
+    }
+}
+
+AUTK_HIDDEN void
+autk_cond_fini(autk_cond_t *cond)
+{
+    pthread_cond_destroy(&cond->handle);
+}
+
+AUTK_HIDDEN void
+autk_cond_wait(autk_cond_t *cond, autk_mutex_t *mutex)
+{
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+}
+
+AUTK_HIDDEN void
+autk_cond_signal(autk_cond_t *cond)
+{
+    pthread_cond_signal(&cond->handle);
+}
+
+AUTK_HIDDEN void
+autk_cond_broadcast(autk_cond_t *cond)
+{
+    pthread_cond_broadcast(&cond->handle);
+}
+
+//==============================================================================
+//
+// Event
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_event_init(autk_event_t *event)
+{
+    if (pthread_mutex_init(&event->lock, NULL) != 0) {
+        return AUTK_ERR_RUNTIME_FAILURE;
+    } else if (pthread_cond_init(&event->cond, NULL) != 0) {
+        pthread_mutex_destroy(&event->lock);
+        return AUTK_ERR_RUNTIME_FAILURE;
+    }
+
+    atomic_init(&event->is_set, false);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_event_fini(autk_event_t *event)
+{
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->lock);
+}
+
+AUTK_HIDDEN void
+autk_event_set(autk_event_t *event)
+{
+    pthread_mutex_lock(&event->lock);
+    atomic_store_explicit(&event->is_set, true, memory_order_release);
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->lock);
+}
+
+AUTK_HIDDEN bool
+autk_event_is_set(autk_event_t *event)
+{
+    return atomic_load_explicit(&event->is_set, memory_order_acquire);
+}
+
+AUTK_HIDDEN void
+autk_event_wait(autk_event_t *event)
+{
+    if (autk_event_is_set(event)) {
+        return;
+    }
+
+    pthread_mutex_lock(&event->lock);
+    while (!atomic_load_explicit(&event->is_set, memory_order_relaxed)) {
+        pthread_cond_wait(&event->cond, &event->lock);
+    }
+    pthread_mutex_unlock(&event->lock);
+}
+
+//==============================================================================
+//
+// Call-once
+//
+//==============================================================================
+
+AUTK_HIDDEN void
+autk_call_once(autk_once_t *once, void (*func)(void *arg), void *arg)
+{
+    if (atomic_load_explicit(&once->done, memory_order_acquire)) {
+        return;
+    }
+
+    pthread_mutex_lock(&once->lock);
+    if (!atomic_load_explicit(&once->done, memory_order_relaxed)) {
+        func(arg);
+        atomic_store_explicit(&once->done, true, memory_order_release);
+    }
+    pthread_mutex_unlock(&once->lock);
+}
+
+#endif // !AUTK_OS_FUTEX
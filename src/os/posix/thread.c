@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <os/thread.h>
+
+static void *
+thread_main(void *opaque_thread)
+{
+    autk_thread_t *thread = opaque_thread;
+
+    thread->func(thread->arg);
+    return NULL;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_thread_create(autk_thread_t *thread, void (*func)(void *arg), void *arg)
+{
+    thread->func = func;
+    thread->arg = arg;
+
+    switch (pthread_create(&thread->handle, NULL, thread_main, thread)) {
+        case 0:
+            return AUTK_OK;
+        case EAGAIN:
+            return AUTK_ERR_OUT_OF_MEMORY;
+        default:
+            return AUTK_ERR_RUNTIME_FAILURE;
+    }
+}
+
+AUTK_HIDDEN void
+autk_thread_join(autk_thread_t *thread)
+{
+    pthread_join(thread->handle, NULL);
+}
+
+AUTK_HIDDEN uint32_t
+autk_cpu_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (count > 0) {
+        return count > UINT32_MAX ? UINT32_MAX : (uint32_t)count;
+    }
+#endif
+
+    return 1;
+}
@@ -19,6 +19,12 @@
 
 #include "types.h"
 
+//==============================================================================
+//
+// Semaphore
+//
+//==============================================================================
+
 AUTK_HIDDEN autk_status_t
 autk_semaphore_init(autk_semaphore_t *sem, uint32_t value);
 
@@ -28,10 +34,89 @@ autk_semaphore_fini(autk_semaphore_t *sem);
 AUTK_HIDDEN autk_status_t
 autk_semaphore_try_acquire(autk_semaphore_t *sem);
 
+// Spins briefly before going to sleep, since the count is usually released again soon.
 AUTK_HIDDEN autk_status_t
 autk_semaphore_acquire(autk_semaphore_t *sem);
 
 AUTK_HIDDEN autk_status_t
 autk_semaphore_release(autk_semaphore_t *sem);
 
+//==============================================================================
+//
+// Mutex
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_mutex_init(autk_mutex_t *mutex);
+
+AUTK_HIDDEN void
+autk_mutex_fini(autk_mutex_t *mutex);
+
+// Not recursive. Spins briefly before going to sleep.
+AUTK_HIDDEN void
+autk_mutex_lock(autk_mutex_t *mutex);
+
+AUTK_HIDDEN bool
+autk_mutex_try_lock(autk_mutex_t *mutex);
+
+AUTK_HIDDEN void
+autk_mutex_unlock(autk_mutex_t *mutex);
+
+//==============================================================================
+//
+// Condition variable
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_cond_init(autk_cond_t *cond);
+
+AUTK_HIDDEN void
+autk_cond_fini(autk_cond_t *cond);
+
+// `mutex` must be locked by the caller. May wake up spuriously.
+AUTK_HIDDEN void
+autk_cond_wait(autk_cond_t *cond, autk_mutex_t *mutex);
+
+AUTK_HIDDEN void
+autk_cond_signal(autk_cond_t *cond);
+
+AUTK_HIDDEN void
+autk_cond_broadcast(autk_cond_t *cond);
+
+//==============================================================================
+//
+// Event
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_event_init(autk_event_t *event);
+
+AUTK_HIDDEN void
+autk_event_fini(autk_event_t *event);
+
+// Sets the event and wakes all waiters. Setting an event more than once has no further effect.
+AUTK_HIDDEN void
+autk_event_set(autk_event_t *event);
+
+AUTK_HIDDEN bool
+autk_event_is_set(autk_event_t *event);
+
+// Blocks until the event is set.
+AUTK_HIDDEN void
+autk_event_wait(autk_event_t *event);
+
+//==============================================================================
+//
+// Call-once
+//
+//==============================================================================
+
+// Calls `func(arg)` exactly once per `once`, which must have been initialized with
+// `AUTK_ONCE_INIT`. Concurrent callers block until the first call has returned.
+AUTK_HIDDEN void
+autk_call_once(autk_once_t *once, void (*func)(void *arg), void *arg);
+
 #endif // AUTK_OS_SYNC_H_
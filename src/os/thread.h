@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_OS_THREAD_H_
+#define AUTK_OS_THREAD_H_
+
+#include "types.h"
+
+// Starts a thread that calls `func(arg)`. `thread` must stay valid until the thread is joined.
+AUTK_HIDDEN autk_status_t
+autk_thread_create(autk_thread_t *thread, void (*func)(void *arg), void *arg);
+
+AUTK_HIDDEN void
+autk_thread_join(autk_thread_t *thread);
+
+// Returns the number of CPUs available to the process, or 1 if it can't be determined.
+AUTK_HIDDEN uint32_t
+autk_cpu_count(void);
+
+#endif // AUTK_OS_THREAD_H_
@@ -17,21 +17,100 @@
 #ifndef AUTK_OS_TYPES_H_
 #define AUTK_OS_TYPES_H_
 
+#if defined(__linux__)
+# define AUTK_OS_FUTEX 1
+#endif
+
 #ifdef _WIN32
 # include <windows.h>
 #elif defined(__unix__)
+# include <pthread.h>
 # include <semaphore.h>
 #endif
 
+#include <stdatomic.h>
+
 #include <autk/types.h>
 
+// On Linux, the synchronization primitives below are built directly on futexes, so they only enter
+// the kernel when a thread actually has to sleep or be woken. Elsewhere they wrap pthreads or
+// Win32 objects.
+
 typedef struct autk_semaphore {
 #ifdef _WIN32
     HANDLE handle;
+#elif defined(AUTK_OS_FUTEX)
+    _Atomic uint32_t value;
+    _Atomic uint32_t waiter_count;
 #elif defined(__unix__)
     sem_t handle;
     bool was_init;
 #endif
 } autk_semaphore_t;
 
+typedef struct autk_mutex {
+#ifdef _WIN32
+    SRWLOCK lock;
+#elif defined(AUTK_OS_FUTEX)
+    _Atomic uint32_t state; // 0: unlocked, 1: locked, 2: locked with possible waiters
+#elif defined(__unix__)
+    pthread_mutex_t handle;
+#endif
+} autk_mutex_t;
+
+typedef struct autk_cond {
+#ifdef _WIN32
+    CONDITION_VARIABLE cond;
+#elif defined(AUTK_OS_FUTEX)
+    _Atomic uint32_t seq; // bumped on every signal
+    _Atomic uint32_t waiter_count;
+#elif defined(__unix__)
+    pthread_cond_t handle;
+#endif
+} autk_cond_t;
+
+// One-shot event: once set, it stays set and every wait returns immediately.
+typedef struct autk_event {
+#ifdef _WIN32
+    SRWLOCK lock;
+    CONDITION_VARIABLE cond;
+    _Atomic bool is_set;
+#elif defined(AUTK_OS_FUTEX)
+    _Atomic uint32_t state; // 0: unset, 1: unset with waiters, 2: set
+#elif defined(__unix__)
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    _Atomic bool is_set;
+#endif
+} autk_event_t;
+
+typedef struct autk_once {
+#ifdef _WIN32
+    INIT_ONCE handle;
+#elif defined(AUTK_OS_FUTEX)
+    _Atomic uint32_t state; // 0: not run, 1: running, 2: running with waiters, 3: done
+#elif defined(__unix__)
+    _Atomic bool done;
+    pthread_mutex_t lock;
+#endif
+} autk_once_t;
+
+#ifdef _WIN32
+# define AUTK_ONCE_INIT {INIT_ONCE_STATIC_INIT}
+#elif defined(AUTK_OS_FUTEX)
+# define AUTK_ONCE_INIT {0}
+#elif defined(__unix__)
+# define AUTK_ONCE_INIT {false, PTHREAD_MUTEX_INITIALIZER}
+#endif
+
+typedef struct autk_thread {
+#ifdef _WIN32
+    HANDLE handle;
+#elif defined(__unix__)
+    pthread_t handle;
+#endif
+    void (*func)(void *arg);
+    void *arg;
+} autk_thread_t;
+
 #endif // AUTK_OS_TYPES_H_
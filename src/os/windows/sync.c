@@ -14,6 +14,7 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <stdatomic.h>
 #include <windows.h>
 
 #include <os/sync.h>
@@ -75,3 +76,158 @@ autk_semaphore_release(autk_semaphore_t *sem)
 
     return AUTK_OK;
 }
+
+//==============================================================================
+//
+// Mutex
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_mutex_init(autk_mutex_t *mutex)
+{
+    InitializeSRWLock(&mutex->lock);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_mutex_fini(autk_mutex_t *mutex)
+{
+    (void)mutex;
+}
+
+AUTK_HIDDEN void
+autk_mutex_lock(autk_mutex_t *mutex)
+{
+    AcquireSRWLockExclusive(&mutex->lock);
+}
+
+AUTK_HIDDEN bool
+autk_mutex_try_lock(autk_mutex_t *mutex)
+{
+    return TryAcquireSRWLockExclusive(&mutex->lock) != 0;
+}
+
+AUTK_HIDDEN void
+autk_mutex_unlock(autk_mutex_t *mutex)
+{
+    ReleaseSRWLockExclusive(&mutex->lock);
+}
+
+//==============================================================================
+//
+// Condition variable
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_cond_init(autk_cond_t *cond)
+{
+    InitializeConditionVariable(&cond->cond);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_cond_fini(autk_cond_t *cond)
+{
+    (void)cond;
+}
+
+AUTK_HIDDEN void
+autk_cond_wait(autk_cond_t *cond, autk_mutex_t *mutex)
+{
+    SleepConditionVariableSRW(&cond->cond, &mutex->lock, INFINITE, 0);
+}
+
+AUTK_HIDDEN void
+autk_cond_signal(autk_cond_t *cond)
+{
+    WakeConditionVariable(&cond->cond);
+}
+
+AUTK_HIDDEN void
+autk_cond_broadcast(autk_cond_t *cond)
+{
+    WakeAllConditionVariable(&cond->cond);
+}
+
+//==============================================================================
+//
+// Event
+//
+//==============================================================================
+
+AUTK_HIDDEN autk_status_t
+autk_event_init(autk_event_t *event)
+{
+    InitializeSRWLock(&event->lock);
+    InitializeConditionVariable(&event->cond);
+    atomic_init(&event->is_set, false);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_event_fini(autk_event_t *event)
+{
+    (void)event;
+}
+
+AUTK_HIDDEN void
+autk_event_set(autk_event_t *event)
+{
+    AcquireSRWLockExclusive(&event->lock);
+    atomic_store_explicit(&event->is_set, true, memory_order_release);
+    ReleaseSRWLockExclusive(&event->lock);
+    WakeAllConditionVariable(&event->cond);
+}
+
+AUTK_HIDDEN bool
+autk_event_is_set(autk_event_t *event)
+{
+    return atomic_load_explicit(&event->is_set, memory_order_acquire);
+}
+
+AUTK_HIDDEN void
+autk_event_wait(autk_event_t *event)
+{
+    if (autk_event_is_set(event)) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&event->lock);
+    while (!atomic_load_explicit(&event->is_set, memory_order_relaxed)) {
+        SleepConditionVariableSRW(&event->cond, &event->lock, INFINITE, 0);
+    }
+    ReleaseSRWLockExclusive(&event->lock);
+}
+
+//==============================================================================
+//
+// Call-once
+//
+//==============================================================================
+
+typedef struct once_call {
+    void (*func)(void *arg);
+    void *arg;
+} once_call_t;
+
+static BOOL CALLBACK
+run_once(PINIT_ONCE once, PVOID opaque_call, PVOID *unused)
+{
+    once_call_t *call = opaque_call;
+
+    (void)once;
+    (void)unused;
+
+    call->func(call->arg);
+    return TRUE;
+}
+
+AUTK_HIDDEN void
+autk_call_once(autk_once_t *once, void (*func)(void *arg), void *arg)
+{
+    once_call_t call = {func, arg};
+
+    InitOnceExecuteOnce(&once->handle, run_once, &call, NULL);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <windows.h>
+
+#include <os/thread.h>
+
+static DWORD WINAPI
+thread_main(LPVOID opaque_thread)
+{
+    autk_thread_t *thread = opaque_thread;
+
+    thread->func(thread->arg);
+    return 0;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_thread_create(autk_thread_t *thread, void (*func)(void *arg), void *arg)
+{
+    thread->func = func;
+    thread->arg = arg;
+
+    thread->handle = CreateThread(NULL, 0, thread_main, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        return AUTK_ERR_RUNTIME_FAILURE;
+    }
+
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_thread_join(autk_thread_t *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    thread->handle = NULL;
+}
+
+AUTK_HIDDEN uint32_t
+autk_cpu_count(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+}
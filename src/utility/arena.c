@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <autk/instance.h>
+
+#include "arena.h"
+
+// Links a new chunk with room for at least `size` bytes after the current one.
+static autk_arena_chunk_t *
+add_chunk(autk_arena_t *arena, size_t size)
+{
+    size_t header_size = autk_align_up(sizeof(autk_arena_chunk_t));
+    size_t chunk_size = AUTK_ARENA_MIN_CHUNK_SIZE;
+    autk_arena_chunk_t *chunk;
+
+    // Grow chunks along with the arena, so a big list doesn't take many small chunks.
+    if (arena->current) {
+        chunk_size = autk_size_min(arena->current->size * 2, AUTK_ARENA_MAX_CHUNK_SIZE);
+    }
+    if (size > chunk_size) {
+        chunk_size = size;
+    }
+    if (chunk_size > SIZE_MAX - header_size) {
+        return NULL;
+    }
+
+    chunk = autk_instance_alloc(arena->instance, NULL, 0, header_size + chunk_size, arena->tag);
+    if (!chunk) {
+        return NULL;
+    }
+
+    *chunk = (autk_arena_chunk_t){.size = chunk_size};
+    if (arena->current) {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    } else {
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+    return chunk;
+}
+
+AUTK_HIDDEN void
+autk_arena_init(autk_arena_t *arena, autk_instance_t *instance, autk_memory_tag_t tag)
+{
+    *arena = (autk_arena_t){
+        .instance = instance,
+        .tag = tag,
+    };
+}
+
+AUTK_HIDDEN void
+autk_arena_fini(autk_arena_t *arena)
+{
+    size_t header_size = autk_align_up(sizeof(autk_arena_chunk_t));
+    autk_arena_chunk_t *next;
+
+    for (autk_arena_chunk_t *chunk = arena->head; chunk; chunk = next) {
+        next = chunk->next;
+        autk_instance_alloc(arena->instance, chunk, header_size + chunk->size, 0, arena->tag);
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+AUTK_HIDDEN void *
+autk_arena_alloc(autk_arena_t *arena, size_t size)
+{
+    autk_arena_chunk_t *chunk = arena->current;
+    void *mem;
+
+    if (!size || size > SIZE_MAX - AUTK_ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    size = autk_arena_round_size(size);
+
+    // Move on to the next chunk if this one's full. Chunks after the current one are only there
+    // after a reset, and are empty. One that's too small stays in the list, empty, until it's
+    // reached again.
+    if (!chunk || chunk->size - chunk->used < size) {
+        chunk = chunk ? chunk->next : arena->head;
+        if (!chunk || chunk->size < size) {
+            chunk = add_chunk(arena, size);
+            if (!chunk) {
+                return NULL;
+            }
+        }
+        arena->current = chunk;
+    }
+
+    mem = (char *)autk_arena_chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+    return mem;
+}
+
+AUTK_HIDDEN void
+autk_arena_reset(autk_arena_t *arena)
+{
+    for (autk_arena_chunk_t *chunk = arena->head; chunk; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    arena->current = NULL;
+}
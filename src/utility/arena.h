@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_ARENA_H_
+#define AUTK_UTILITY_ARENA_H_
+
+#include <autk/types.h>
+
+#include "math.h"
+
+// Allocations are aligned for pointers and anything smaller.
+#define AUTK_ARENA_ALIGNMENT AUTK_ALIGNOF(void *)
+
+// Chunks start at this many usable bytes and double up to the maximum, unless an allocation needs
+// more.
+#define AUTK_ARENA_MIN_CHUNK_SIZE 1024
+#define AUTK_ARENA_MAX_CHUNK_SIZE (64 * 1024)
+
+typedef struct autk_arena autk_arena_t;
+typedef struct autk_arena_chunk autk_arena_chunk_t;
+
+struct autk_arena_chunk {
+    autk_arena_chunk_t *next;
+    size_t size; // usable bytes following the header
+    size_t used; // bytes allocated from the start of the chunk's data
+};
+
+// Bump allocator over a list of chunks. Allocations can't be freed one at a time, but resetting the
+// arena keeps its chunks for reuse. Allocations are laid out in order through the chunk list, so
+// they can be walked back in the order they were made.
+struct autk_arena {
+    autk_instance_t *instance;
+    autk_memory_tag_t tag;
+    autk_arena_chunk_t *head;
+    autk_arena_chunk_t *current; // chunk being allocated from, or NULL if there are none
+};
+
+AUTK_HIDDEN void
+autk_arena_init(autk_arena_t *arena, autk_instance_t *instance, autk_memory_tag_t tag);
+
+AUTK_HIDDEN void
+autk_arena_fini(autk_arena_t *arena);
+
+// Returns `size` bytes aligned to `AUTK_ARENA_ALIGNMENT`, or `NULL` on failure.
+AUTK_HIDDEN void *
+autk_arena_alloc(autk_arena_t *arena, size_t size);
+
+// Forgets all allocations, keeping the chunks.
+AUTK_HIDDEN void
+autk_arena_reset(autk_arena_t *arena);
+
+// Returns how many bytes an allocation of `size` bytes takes up in its chunk. The next one starts
+// right after it.
+static inline size_t
+autk_arena_round_size(size_t size)
+{
+    return ((size - 1) | (AUTK_ARENA_ALIGNMENT - 1)) + 1;
+}
+
+// Returns the start of a chunk's allocations, which run for `chunk->used` bytes.
+static inline void *
+autk_arena_chunk_data(autk_arena_chunk_t *chunk)
+{
+    return (char *)chunk + autk_align_up(sizeof(autk_arena_chunk_t));
+}
+
+#endif // AUTK_UTILITY_ARENA_H_
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <autk/math.h>
+
+#include "damage.h"
+
+// Two rectangles are merged if the area their bounding box covers beyond them is at most
+// 1/2^MERGE_WASTE_SHIFT of the box.
+#define MERGE_WASTE_SHIFT 2
+
+static uint64_t
+bbox_area(autk_bbox_t bbox)
+{
+    if (!autk_bbox_is_positive(&bbox)) {
+        return 0;
+    }
+    return (uint64_t)((int64_t)bbox.x1 - bbox.x0) * (uint64_t)((int64_t)bbox.y1 - bbox.y0);
+}
+
+static autk_bbox_t
+bbox_union(autk_bbox_t a, autk_bbox_t b)
+{
+    autk_bbox_extend(&a, b);
+    return a;
+}
+
+// Returns the area of the bounding box of `a` and `b` that neither of them covers.
+static uint64_t
+merge_waste(autk_bbox_t a, autk_bbox_t b, uint64_t *out_union_area)
+{
+    uint64_t union_area = bbox_area(bbox_union(a, b));
+    autk_bbox_t overlap = a;
+    uint64_t covered;
+
+    autk_bbox_intersect(&overlap, &b);
+    covered = bbox_area(a) + bbox_area(b) - bbox_area(overlap);
+
+    *out_union_area = union_area;
+    return union_area - covered;
+}
+
+// Returns the index of the rectangle that merges with `bbox` at the least waste, or `rect_count`
+// if there's none. Unless `force` is set, only merges within the waste threshold are considered.
+static uint32_t
+find_merge(const autk_damage_t *damage, autk_bbox_t bbox, bool force)
+{
+    uint32_t best = damage->rect_count;
+    uint64_t best_waste = UINT64_MAX;
+    uint64_t waste;
+    uint64_t union_area;
+
+    for (uint32_t i = 0; i < damage->rect_count; i++) {
+        waste = merge_waste(damage->rects[i], bbox, &union_area);
+        if (waste < best_waste && (force || waste <= union_area >> MERGE_WASTE_SHIFT)) {
+            best = i;
+            best_waste = waste;
+        }
+    }
+
+    return best;
+}
+
+AUTK_HIDDEN void
+autk_damage_add(autk_damage_t *damage, autk_bbox_t bbox)
+{
+    uint32_t index;
+
+    if (!autk_bbox_is_positive(&bbox)) {
+        return;
+    }
+    autk_bbox_extend(&damage->bounds, bbox);
+
+    for (uint32_t i = 0; i < damage->rect_count; i++) {
+        if (autk_bbox_contains(&damage->rects[i], &bbox)) {
+            return;
+        }
+    }
+
+    // Keep merging, since each merge grows the rectangle and may make it worth merging with
+    // another. Take merged rectangles out of the list, so there's room for the result at the end.
+    for (;;) {
+        index = find_merge(damage, bbox, damage->rect_count == AUTK_DAMAGE_MAX_RECTS);
+        if (index == damage->rect_count) {
+            break;
+        }
+        bbox = bbox_union(bbox, damage->rects[index]);
+        damage->rects[index] = damage->rects[--damage->rect_count];
+    }
+
+    damage->rects[damage->rect_count++] = bbox;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_DAMAGE_H_
+#define AUTK_UTILITY_DAMAGE_H_
+
+#include <autk/types.h>
+
+// Most rectangles a damage region keeps apart before it starts merging them regardless of cost.
+#define AUTK_DAMAGE_MAX_RECTS 8
+
+typedef struct autk_damage autk_damage_t;
+
+// Approximate damage region: a short list of rectangles whose union covers everything that was
+// added. A new rectangle is merged with an existing one when the merged box wastes little area, so
+// nearby exposures collapse into one rectangle while distant ones stay apart. The rectangles may
+// overlap. Zero-initialized means empty.
+struct autk_damage {
+    autk_bbox_t bounds; // bounding box of `rects`
+    uint32_t rect_count;
+    autk_bbox_t rects[AUTK_DAMAGE_MAX_RECTS];
+};
+
+static inline bool
+autk_damage_is_empty(const autk_damage_t *damage)
+{
+    return damage->rect_count == 0;
+}
+
+static inline void
+autk_damage_clear(autk_damage_t *damage)
+{
+    damage->bounds = (autk_bbox_t){0};
+    damage->rect_count = 0;
+}
+
+// Adds a rectangle to the region. Empty rectangles are ignored.
+AUTK_HIDDEN void
+autk_damage_add(autk_damage_t *damage, autk_bbox_t bbox);
+
+#endif // AUTK_UTILITY_DAMAGE_H_
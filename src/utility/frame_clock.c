@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <limits.h>
+
+#include "frame_clock.h"
+
+// Returns when the next frame may start. If a refresh notification is on its way, give it up to one
+// more interval before going ahead without it.
+static uint64_t
+deadline(const autk_frame_clock_t *clock)
+{
+    if (clock->vsync_pending && clock->next_frame <= UINT64_MAX - clock->interval) {
+        return clock->next_frame + clock->interval;
+    }
+    return clock->next_frame;
+}
+
+AUTK_HIDDEN void
+autk_frame_clock_init(autk_frame_clock_t *clock)
+{
+    *clock = (autk_frame_clock_t){
+        .interval = AUTK_FRAME_CLOCK_DEFAULT_INTERVAL_NS,
+        .display_interval = AUTK_FRAME_CLOCK_DEFAULT_INTERVAL_NS,
+    };
+}
+
+AUTK_HIDDEN void
+autk_frame_clock_set_display_interval(autk_frame_clock_t *clock, uint64_t interval)
+{
+    if (clock->interval == clock->display_interval) {
+        clock->interval = interval;
+    }
+    clock->display_interval = interval;
+}
+
+AUTK_HIDDEN void
+autk_frame_clock_set_interval(autk_frame_clock_t *clock, uint64_t interval)
+{
+    clock->interval = interval ? interval : clock->display_interval;
+}
+
+AUTK_HIDDEN bool
+autk_frame_clock_is_due(const autk_frame_clock_t *clock, uint64_t now)
+{
+    return now >= deadline(clock);
+}
+
+AUTK_HIDDEN int
+autk_frame_clock_timeout_ms(const autk_frame_clock_t *clock, uint64_t now)
+{
+    uint64_t frame_time = deadline(clock);
+    uint64_t timeout_ms;
+
+    if (frame_time <= now) {
+        return 0;
+    }
+
+    timeout_ms = (frame_time - now + 999999) / 1000000;
+    return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+
+AUTK_HIDDEN void
+autk_frame_clock_tick(autk_frame_clock_t *clock, uint64_t now)
+{
+    // Keep frames on a steady beat while they're continuous, but start a new beat after an idle
+    // period, so the first frame after it isn't delayed.
+    clock->vsync_pending = false;
+    if (clock->next_frame <= UINT64_MAX - clock->interval) {
+        clock->next_frame += clock->interval;
+    }
+    if (clock->next_frame <= now) {
+        clock->next_frame = now <= UINT64_MAX - clock->interval ? now + clock->interval : now;
+    }
+}
+
+AUTK_HIDDEN void
+autk_frame_clock_vsync(autk_frame_clock_t *clock, uint64_t now)
+{
+    if (!clock->vsync_pending) {
+        return;
+    }
+    clock->vsync_pending = false;
+
+    // Snap to the refresh that comes last before the deadline. Earlier ones are only passed over,
+    // so a frame interval slower than the display's still holds; the next frame asks again.
+    if (now >= clock->next_frame || clock->next_frame - now <= clock->display_interval) {
+        clock->next_frame = now;
+    }
+}
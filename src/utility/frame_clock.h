@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_FRAME_CLOCK_H_
+#define AUTK_UTILITY_FRAME_CLOCK_H_
+
+#include <autk/types.h>
+
+// Frame interval used until a driver finds out the display's refresh rate.
+#define AUTK_FRAME_CLOCK_DEFAULT_INTERVAL_NS (1000000000u / 60)
+
+typedef struct autk_frame_clock autk_frame_clock_t;
+
+// Limits redraws to one per frame interval. Damage accumulates until the next frame is due, at
+// which point it's all delivered at once. A driver that can be told when the display refreshes
+// calls `autk_frame_clock_vsync()` from that notification, so frames line up with the display.
+// Until a notification arrives, the clock waits for one extra interval before falling back to its
+// own timing.
+struct autk_frame_clock {
+    uint64_t interval; // time between frames, in nanoseconds
+    uint64_t display_interval; // the display's refresh interval, used when no rate is set
+    uint64_t next_frame; // earliest time the next frame may start
+    bool vsync_pending; // set while waiting on a refresh notification
+};
+
+AUTK_HIDDEN void
+autk_frame_clock_init(autk_frame_clock_t *clock);
+
+// Sets the interval used when the application doesn't choose one.
+AUTK_HIDDEN void
+autk_frame_clock_set_display_interval(autk_frame_clock_t *clock, uint64_t interval);
+
+// Sets the time between frames, or follows the display if `interval` is zero.
+AUTK_HIDDEN void
+autk_frame_clock_set_interval(autk_frame_clock_t *clock, uint64_t interval);
+
+// Returns true if a frame may start now.
+AUTK_HIDDEN bool
+autk_frame_clock_is_due(const autk_frame_clock_t *clock, uint64_t now);
+
+// Returns the number of milliseconds until the next frame may start, rounded up, for use as a
+// `poll()` timeout.
+AUTK_HIDDEN int
+autk_frame_clock_timeout_ms(const autk_frame_clock_t *clock, uint64_t now);
+
+// Records that a frame started at `now`, and schedules the next one.
+AUTK_HIDDEN void
+autk_frame_clock_tick(autk_frame_clock_t *clock, uint64_t now);
+
+// Records that a refresh notification was requested.
+static inline void
+autk_frame_clock_begin_vsync(autk_frame_clock_t *clock)
+{
+    clock->vsync_pending = true;
+}
+
+// Records that the display refreshed at `now`. The next frame starts then if its deadline is less
+// than one refresh away.
+AUTK_HIDDEN void
+autk_frame_clock_vsync(autk_frame_clock_t *clock, uint64_t now);
+
+#endif // AUTK_UTILITY_FRAME_CLOCK_H_
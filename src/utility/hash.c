@@ -17,19 +17,25 @@
 #include <assert.h>
 #include <string.h>
 
+#include <autk/diagnostics.h>
 #include <autk/instance.h>
+#include <utility/math.h>
 
 #include "hash.h"
 
-#define HASH_EMPTY 0
-#define HASH_TOMBSTONE 1
-#define HASH_MAX ((autk_hash_t) - 1ll)
-#define HASH_MAX_BIT (HASH_MAX ^ (HASH_MAX >> 1))
-#define HASH_OCCUPIED_BIT HASH_MAX_BIT
-#define HASH_VALUE_MASK (HASH_MAX ^ HASH_OCCUPIED_BIT)
-#define HASH_ALIGNMENT 8 // for bucket headers and for element data
-#define BUCKET_OVERHEAD HASH_ALIGNMENT
-#define MIN_BUFFER_BYTES 256
+#define HASH_ALIGNMENT 8 // for element data
+#define GROUP_SIZE AUTK_HASH_GROUP_SIZE
+#define MIN_BUCKET_COUNT GROUP_SIZE
+// Hard cap on resize work per insert or remove. Finds don't migrate: they take a const table, and
+// may run while the table is being iterated. A table that's only read after a resize keeps probing
+// both buffers until the next insert or remove.
+#define MIGRATE_BUCKETS_PER_OP (2 * GROUP_SIZE)
+
+static_assert(MIN_BUCKET_COUNT % HASH_ALIGNMENT == 0,
+              "Element array must be aligned when following the control bytes");
+static_assert(MIGRATE_BUCKETS_PER_OP >= 8,
+              "An old buffer must drain before the current one fills up; see "
+              "autk_hash_table_prepare_insert()");
 
 static size_t
 align_up(size_t n)
@@ -55,258 +61,280 @@ next_pow_2(size_t n)
     return n + 1;
 }
 
-AUTK_HIDDEN void
-autk_hash_table_init(autk_instance_t *instance, autk_hash_table_t *ht, size_t element_size,
-                     autk_hash_func_t hash_func, autk_hash_eq_func_t eq_func)
+//==============================================================================
+//
+// Hash table internals
+//
+//==============================================================================
+
+static inline void *
+element_at(const autk_hash_table_t *ht, const autk_hash_buffer_t *buf, size_t index)
 {
-    *ht = (autk_hash_table_t){
-        .instance = instance,
-        .element_size = element_size,
-        .hash_func = hash_func,
-        .eq_func = eq_func,
-        .bucket_size = BUCKET_OVERHEAD + align_up(element_size),
-    };
+    return buf->elements + index * ht->element_stride;
 }
 
-AUTK_HIDDEN void
-autk_hash_table_fini(autk_hash_table_t *ht)
+static size_t
+bitmap_word_count(size_t bucket_count)
+{
+    return (bucket_count + 63) / 64;
+}
+
+static inline void
+set_occupied(autk_hash_buffer_t *buf, size_t index)
+{
+    buf->occupied[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+static inline void
+clear_occupied(autk_hash_buffer_t *buf, size_t index)
+{
+    buf->occupied[index / 64] &= ~((uint64_t)1 << (index % 64));
+}
+
+// The control bytes, element array, and occupancy bitmap share one allocation, in that order.
+static size_t
+buffer_size(const autk_hash_table_t *ht, const autk_hash_buffer_t *buf)
 {
-    if (ht->data) {
-        autk_instance_alloc(ht->instance, ht->data, ht->bucket_size * ht->bucket_count, 0,
+    return buf->bucket_count + buf->bucket_count * ht->element_stride
+           + bitmap_word_count(buf->bucket_count) * sizeof(uint64_t);
+}
+
+static void
+free_buffer(autk_hash_table_t *ht, autk_hash_buffer_t *buf)
+{
+    if (buf->ctrl) {
+        autk_instance_alloc(ht->instance, buf->ctrl, buffer_size(ht, buf), 0,
                             AUTK_MEMORY_TAG_HASH);
-        ht->bucket_count = 0;
-        ht->used_count = 0;
-        ht->worst_miss = 0;
-        ht->data = NULL;
     }
+    *buf = (autk_hash_buffer_t){0};
 }
 
-AUTK_HIDDEN bool
-autk_hash_table_find(const autk_hash_table_t *ht, const void *key, autk_hash_iter_t *out_iter)
+// Claims the first empty bucket or tombstone along the probe sequence for `hash` and tags it. The
+// caller must have already checked that the key isn't present, and is responsible for filling in the
+// element and updating `used_count`.
+static size_t
+claim_bucket(autk_hash_table_t *ht, autk_hash_t hash)
 {
-    autk_hash_t hash;
+    autk_hash_buffer_t *buf = &ht->buf;
+    size_t group = autk_hash_home_group(buf, hash);
+    autk_hash_group_mask_t mask;
     size_t index;
-    autk_hash_t *bucket;
-    const void *element;
 
-    if (ht->used_count == 0) {
-        return false;
+    for (size_t miss = 0;; miss++) {
+        mask = autk_hash_group_match_free(buf->ctrl + group * GROUP_SIZE);
+        if (mask) {
+            index = group * GROUP_SIZE + autk_hash_mask_first(mask);
+            if (buf->ctrl[index] == AUTK_HASH_CTRL_TOMBSTONE) {
+                buf->tombstone_count--;
+            }
+            buf->ctrl[index] = autk_hash_tag(hash);
+            set_occupied(buf, index);
+            if (miss > buf->worst_miss) {
+                buf->worst_miss = miss;
+            }
+            return index;
+        }
+
+        // The load factor guarantees that this terminates.
+        group = autk_hash_next_group(buf, group, miss);
     }
+}
 
-    // Determine where to begin the search.
-    hash = ht->hash_func(key);
-    index = hash % ht->bucket_count;
-    hash |= HASH_OCCUPIED_BIT;
+// Moves up to `max_buckets` buckets from the old buffer into the current one, and frees the old
+// buffer once it has been drained.
+static void
+migrate(autk_hash_table_t *ht, size_t max_buckets)
+{
+    autk_hash_buffer_t *old_buf = &ht->old_buf;
+    size_t end, index;
+    const void *element;
 
-    // Perform the search.
-    for (size_t i = 0; i <= ht->worst_miss; i++) {
-        bucket = (autk_hash_t *)(ht->data + index * ht->bucket_size);
-        if (*bucket == HASH_EMPTY) {
-            // Stop the search early if we reach an empty bucket.
-            return false;
-        } else if (*bucket == hash) {
-            // Cached hash matches. Check if the keys match.
-            element = (char *)bucket + BUCKET_OVERHEAD;
-            if (ht->eq_func(key, element)) {
-                // We have a match.
-                out_iter->index = index;
-                return true;
-            }
-        }
+    if (!old_buf->ctrl) {
+        return;
+    }
+
+    end = ht->migrate_index + autk_size_min(max_buckets, old_buf->bucket_count - ht->migrate_index);
+    for (size_t i = ht->migrate_index; i < end; i++) {
+        if (!(old_buf->ctrl[i] & AUTK_HASH_CTRL_FREE_BIT)) {
+            element = element_at(ht, old_buf, i);
+            index = claim_bucket(ht, autk_hash_mix(ht->hash_func(element)));
+            memcpy(element_at(ht, &ht->buf, index), element, ht->element_size);
 
-        // Increment and possibly wrap the search.
-        if (++index == ht->bucket_count) {
-            index = 0;
+            // Keep the old probe sequences intact for the buckets we haven't moved yet.
+            old_buf->ctrl[i] = AUTK_HASH_CTRL_TOMBSTONE;
+            clear_occupied(old_buf, i);
         }
     }
+    ht->migrate_index = end;
 
-    return false;
+    if (ht->migrate_index == old_buf->bucket_count) {
+        free_buffer(ht, old_buf);
+        ht->migrate_index = 0;
+    }
 }
 
-AUTK_HIDDEN void *
-autk_hash_table_get(autk_hash_table_t *ht, autk_hash_iter_t iter)
+// Returns the bucket count needed to hold `count` elements under the load factor.
+static autk_status_t
+bucket_count_for(const autk_hash_table_t *ht, size_t count, size_t *out_bucket_count)
 {
-    autk_hash_t *bucket;
+    size_t bucket_count;
 
-    if (iter.index >= ht->bucket_count) {
-        return NULL;
+    if (count > SIZE_MAX / 4) {
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
+    }
+    bucket_count = autk_size_max((count * 4 + 2) / 3, MIN_BUCKET_COUNT);
+    bucket_count = next_pow_2(bucket_count);
+    if (bucket_count == 0 || bucket_count > SIZE_MAX / (ht->element_stride + 1)) {
+        return AUTK_ERR_ARITHMETIC_OVERFLOW;
     }
 
-    bucket = (autk_hash_t *)(ht->data + iter.index * ht->bucket_size);
-    if (!(*bucket & HASH_OCCUPIED_BIT)) {
-        return NULL;
+    *out_bucket_count = bucket_count;
+    return AUTK_OK;
+}
+
+static size_t
+max_load(size_t bucket_count)
+{
+    return bucket_count / 4 * 3;
+}
+
+// Makes a fresh buffer with `bucket_count` buckets current, and leaves the live elements in
+// `old_buf` for `migrate()` to move over. The new buffer starts with no tombstones and a
+// `worst_miss` of zero.
+static autk_status_t
+begin_resize(autk_hash_table_t *ht, size_t bucket_count)
+{
+    autk_hash_buffer_t new_buf = {.bucket_count = bucket_count};
+    size_t new_buf_size = buffer_size(ht, &new_buf);
+
+    // Allocate the new buffer. All control bytes start out empty.
+    new_buf.ctrl = autk_instance_alloc(ht->instance, NULL, 0, new_buf_size, AUTK_MEMORY_TAG_HASH);
+    if (!new_buf.ctrl) {
+        return AUTK_ERR_OUT_OF_MEMORY;
     }
+    memset(new_buf.ctrl, AUTK_HASH_CTRL_EMPTY, new_buf.bucket_count);
+    new_buf.elements = (char *)new_buf.ctrl + new_buf.bucket_count;
+    new_buf.occupied = (uint64_t *)(new_buf.elements + new_buf.bucket_count * ht->element_stride);
+    memset(new_buf.occupied, 0, bitmap_word_count(new_buf.bucket_count) * sizeof(uint64_t));
+
+    // A previous resize normally finishes long before the next one is needed, but an explicit
+    // reserve can come sooner. Only one old buffer can be draining at a time.
+    migrate(ht, SIZE_MAX);
+
+    // Make the new buffer current. Elements are moved over by later calls to `migrate()`.
+    if (ht->buf.ctrl && ht->used_count > 0) {
+        ht->old_buf = ht->buf;
+        ht->migrate_index = 0;
+    } else {
+        free_buffer(ht, &ht->buf);
+    }
+    ht->buf = new_buf;
 
-    return (char *)bucket + BUCKET_OVERHEAD;
+    return AUTK_OK;
 }
 
-static bool
-do_insert(autk_hash_table_t *ht, const void *key, autk_hash_t hash, autk_hash_iter_t *out_iter)
+//==============================================================================
+//
+// Internal API
+//
+//==============================================================================
+
+AUTK_HIDDEN void
+autk_hash_table_init(autk_instance_t *instance, autk_hash_table_t *ht, size_t element_size,
+                     autk_hash_func_t hash_func, autk_hash_eq_func_t eq_func)
 {
-    size_t index;
-    autk_hash_t *bucket;
-    autk_hash_t *first_tombstone = NULL;
-    size_t first_tombstone_index = 0;
-    void *element;
-    size_t i;
-
-    // Determine where to begin the search.
-    hash |= HASH_OCCUPIED_BIT;
-    index = (hash & HASH_VALUE_MASK) % ht->bucket_count;
-
-    // Perform the search.
-    for (i = 0; i <= ht->worst_miss; i++) {
-        bucket = (autk_hash_t *)(ht->data + index * ht->bucket_size);
-        if (*bucket == HASH_EMPTY) {
-            // Empty bucket found. Insert here.
-            *bucket = hash;
-            element = (char *)bucket + BUCKET_OVERHEAD;
-            memcpy(element, key, ht->element_size);
-            if (out_iter) {
-                out_iter->index = index;
-            }
-            ht->used_count++;
-            return true;
-        } else if (*bucket == HASH_TOMBSTONE) {
-            // We can use this bucket if the key is not found, but we first have to keep searching
-            // until `worst_miss` is reached.
-            if (!first_tombstone) {
-                first_tombstone = bucket;
-                first_tombstone_index = index;
-            }
-        } else if (*bucket == hash) {
-            // Cached hash matches. Check if the keys match.
-            element = (char *)bucket + BUCKET_OVERHEAD;
-            if (ht->eq_func(key, element)) {
-                // We have a match.
-                if (out_iter) {
-                    out_iter->index = index;
-                }
-                return false;
-            }
-        }
+    *ht = (autk_hash_table_t){
+        .instance = instance,
+        .element_size = element_size,
+        .hash_func = hash_func,
+        .eq_func = eq_func,
+        .element_stride = align_up(element_size),
+    };
+}
+
+AUTK_HIDDEN void
+autk_hash_table_fini(autk_hash_table_t *ht)
+{
+    free_buffer(ht, &ht->buf);
+    free_buffer(ht, &ht->old_buf);
+    ht->used_count = 0;
+    ht->migrate_index = 0;
+}
+
+AUTK_HIDDEN bool
+autk_hash_table_find(const autk_hash_table_t *ht, const void *key, autk_hash_iter_t *out_iter)
+{
+    return autk_hash_table_lookup(ht, key, autk_hash_mix(ht->hash_func(key)), ht->eq_func, out_iter)
+           != NULL;
+}
 
-        // Increment and possibly wrap the search.
-        if (++index == ht->bucket_count) {
-            index = 0;
+static autk_hash_buffer_t *
+resolve_iter(autk_hash_table_t *ht, autk_hash_iter_t iter, size_t *out_index)
+{
+    autk_hash_buffer_t *buf = &ht->buf;
+    size_t index = iter.index;
+
+    if (index >= buf->bucket_count) {
+        index -= buf->bucket_count;
+        buf = &ht->old_buf;
+        if (index >= buf->bucket_count) {
+            return NULL;
         }
     }
 
-    // If we reach here, we've reached `worst_miss`.
-    // If we've encountered any tombstone, we can use it.
-    if (first_tombstone) {
-        *first_tombstone = hash;
-        element = (char *)first_tombstone + BUCKET_OVERHEAD;
-        memcpy(element, key, ht->element_size);
-        if (out_iter) {
-            out_iter->index = first_tombstone_index;
-        }
-        ht->used_count++;
-        return true;
+    if (buf->ctrl[index] & AUTK_HASH_CTRL_FREE_BIT) {
+        return NULL;
     }
 
-    // If we reach here, we have to keep looking for any unoccupied bucket and update `worst_miss`.
-    for (;; i++) {
-        bucket = (autk_hash_t *)(ht->data + index * ht->bucket_size);
-        if (!(*bucket & HASH_OCCUPIED_BIT)) {
-            // We finally found an unoccupied bucket!
-            *bucket = hash;
-            element = (char *)bucket + BUCKET_OVERHEAD;
-            memcpy(element, key, ht->element_size);
-            if (out_iter) {
-                out_iter->index = index;
-            }
-            ht->used_count++;
-            ht->worst_miss = i;
-            return true;
-        }
+    *out_index = index;
+    return buf;
+}
 
-        // Increment and possibly wrap the search.
-        if (++index == ht->bucket_count) {
-            index = 0;
-        }
-    }
+AUTK_HIDDEN void *
+autk_hash_table_get(autk_hash_table_t *ht, autk_hash_iter_t iter)
+{
+    autk_hash_buffer_t *buf;
+    size_t index;
+
+    buf = resolve_iter(ht, iter, &index);
+    return buf ? element_at(ht, buf, index) : NULL;
 }
 
 AUTK_HIDDEN autk_status_t
 autk_hash_table_reserve(autk_hash_table_t *ht, size_t min_count)
 {
-    size_t min_bucket_count;
-    autk_hash_table_t old_ht;
-    size_t min_buf_size;
-    size_t new_buf_size;
-    size_t new_bucket_count;
-    char *new_buf;
-    autk_hash_t *bucket;
-    const void *element;
+    size_t bucket_count;
 
     // Skip if the buffer is already large enough.
-    if (min_count > SIZE_MAX / 4) {
-        return AUTK_ERR_ARITHMETIC_OVERFLOW;
-    }
-    min_bucket_count = min_count * 4 / 3;
-    if (ht->bucket_count >= min_bucket_count) {
+    if (max_load(ht->buf.bucket_count) >= min_count && ht->buf.ctrl) {
         return AUTK_OK;
     }
 
-    // Determine the actual size of the new buffer.
-    if (min_bucket_count > SIZE_MAX / ht->bucket_size) {
-        return AUTK_ERR_ARITHMETIC_OVERFLOW;
-    }
-    min_buf_size = min_bucket_count * ht->bucket_size;
-    new_buf_size = next_pow_2(min_buf_size);
-    if (new_buf_size == 0) {
-        return AUTK_ERR_ARITHMETIC_OVERFLOW;
-    } else if (new_buf_size < MIN_BUFFER_BYTES) {
-        new_buf_size = MIN_BUFFER_BYTES;
-    }
-    new_bucket_count = new_buf_size / ht->bucket_size;
+    AUTK_TRY(bucket_count_for(ht, min_count, &bucket_count));
+    return begin_resize(ht, bucket_count);
+}
 
-    // Don't request any excess bytes, or else we'd have to track a separate `alloc_size` field for
-    // the allocator.
-    new_buf_size = new_bucket_count * ht->bucket_size;
+AUTK_HIDDEN autk_status_t
+autk_hash_table_shrink_to_fit(autk_hash_table_t *ht)
+{
+    size_t bucket_count;
 
-    // Allocate the new buffer.
-    new_buf = autk_instance_alloc(ht->instance, NULL, 0, new_buf_size, AUTK_MEMORY_TAG_HASH);
-    if (!new_buf) {
-        return AUTK_ERR_OUT_OF_MEMORY;
+    // Release everything if the table is empty.
+    if (ht->used_count == 0) {
+        free_buffer(ht, &ht->buf);
+        free_buffer(ht, &ht->old_buf);
+        ht->migrate_index = 0;
+        return AUTK_OK;
     }
-    memset(new_buf, 0, new_buf_size);
-
-    // Move the old table to a temporary location and update the main struct to the new one.
-    old_ht = *ht;
-    ht->bucket_count = new_bucket_count;
-    ht->used_count = 0;
-    ht->worst_miss = 0;
-    ht->data = new_buf;
-
-    // Reinsert all elements into the new table.
-    bucket = (autk_hash_t *)ht->data;
-    for (size_t i = 0; i < old_ht.bucket_count; i++) {
-        // We can stop early if we know there are no valid elements left.
-        if (ht->used_count == old_ht.used_count) {
-            break;
-        }
-
-        // Reinsert the element if this bucket is occupied.
-        if (*bucket & HASH_OCCUPIED_BIT) {
-            element = (char *)bucket + BUCKET_OVERHEAD;
-            if (!do_insert(ht, element, *bucket, NULL)) {
-                // The table should never contain multiple copies of the same key.
-                // If this happens, revert the table to its prior state.
-                autk_instance_alloc(ht->instance, new_buf, new_buf_size, 0, AUTK_MEMORY_TAG_HASH);
-                *ht = old_ht;
-                return AUTK_ERR_DATA_CORRUPTION;
-            }
-        }
 
-        // Advance to the next bucket.
-        bucket = (autk_hash_t *)((char *)bucket + old_ht.bucket_size);
+    // Rebuild into the smallest buffer that fits, unless the current one is already that size and
+    // has no tombstones. This is the only time the caller waits for a whole rehash.
+    AUTK_TRY(bucket_count_for(ht, ht->used_count, &bucket_count));
+    if (bucket_count < ht->buf.bucket_count || ht->buf.tombstone_count > 0 || ht->old_buf.ctrl) {
+        AUTK_TRY(begin_resize(ht, bucket_count));
+        migrate(ht, SIZE_MAX);
     }
 
-    // Success!
-    autk_instance_alloc(ht->instance, old_ht.data, old_ht.bucket_size * old_ht.bucket_count, 0,
-                        AUTK_MEMORY_TAG_HASH);
     return AUTK_OK;
 }
 
@@ -314,21 +342,25 @@ AUTK_HIDDEN autk_status_t
 autk_hash_table_insert(autk_hash_table_t *ht, const void *key, autk_hash_iter_t *out_iter,
                        bool *out_inserted)
 {
-    autk_status_t status;
-    bool inserted;
+    autk_hash_t hash;
+    autk_hash_iter_t iter;
+    void *element;
 
-    // Make sure the buffer is large enough for a new element, even if we don't end up inserting a
-    // new one. This is the most convenient place to put this check while only having it in one
-    // place.
-    status = autk_hash_table_reserve(ht, ht->used_count + 1);
-    if (status != AUTK_OK) {
-        return status;
-    }
+    AUTK_TRY(autk_hash_table_prepare_insert(ht));
 
-    // Insert the element.
-    inserted = do_insert(ht, key, ht->hash_func(key), out_iter);
+    // Insert the element unless the key already exists.
+    hash = autk_hash_mix(ht->hash_func(key));
+    element = autk_hash_table_lookup(ht, key, hash, ht->eq_func, &iter);
     if (out_inserted) {
-        *out_inserted = inserted;
+        *out_inserted = !element;
+    }
+    if (!element) {
+        element = autk_hash_table_claim(ht, hash, &iter);
+        memcpy(element, key, ht->element_size);
+    }
+
+    if (out_iter) {
+        *out_iter = iter;
     }
     return AUTK_OK;
 }
@@ -338,6 +370,8 @@ autk_hash_table_remove(autk_hash_table_t *ht, const void *key)
 {
     autk_hash_iter_t iter;
 
+    autk_hash_table_prepare_remove(ht);
+
     if (!autk_hash_table_find(ht, key, &iter)) {
         return NULL;
     }
@@ -347,57 +381,146 @@ autk_hash_table_remove(autk_hash_table_t *ht, const void *key)
 AUTK_HIDDEN void *
 autk_hash_table_remove_iter(autk_hash_table_t *ht, autk_hash_iter_t iter)
 {
-    autk_hash_t *bucket;
-    void *element;
+    autk_hash_buffer_t *buf;
+    size_t index;
 
-    if (iter.index >= ht->bucket_count) {
+    buf = resolve_iter(ht, iter, &index);
+    if (!buf) {
         return NULL;
     }
 
-    bucket = (autk_hash_t *)(ht->data + iter.index * ht->bucket_size);
-    element = (char *)bucket + BUCKET_OVERHEAD;
-    if (!(*bucket & HASH_OCCUPIED_BIT)) {
-        return NULL;
+    // Finds stop at the first group with an empty bucket, and a group never gains an empty bucket
+    // after losing its last one. So if this group still has one, no probe sequence ever passed
+    // through it, and the bucket can go straight back to empty instead of becoming a tombstone.
+    if (autk_hash_group_match(buf->ctrl + (index & ~(size_t)(GROUP_SIZE - 1)),
+                              AUTK_HASH_CTRL_EMPTY))
+    {
+        buf->ctrl[index] = AUTK_HASH_CTRL_EMPTY;
+    } else {
+        buf->ctrl[index] = AUTK_HASH_CTRL_TOMBSTONE;
+        buf->tombstone_count++;
     }
-
-    *bucket = HASH_TOMBSTONE;
+    clear_occupied(buf, index);
     ht->used_count--;
-    return element;
+
+    // Start over with clean probe sequences once the table is empty. The element data isn't
+    // touched, so the returned pointer stays valid.
+    if (ht->used_count == 0 && !ht->old_buf.ctrl
+        && (ht->buf.tombstone_count > 0 || ht->buf.worst_miss > 0))
+    {
+        memset(ht->buf.ctrl, AUTK_HASH_CTRL_EMPTY, ht->buf.bucket_count);
+        ht->buf.tombstone_count = 0;
+        ht->buf.worst_miss = 0;
+    }
+
+    return element_at(ht, buf, index);
 }
 
-AUTK_HIDDEN bool
-autk_hash_table_begin(const autk_hash_table_t *ht, autk_hash_iter_t *iter)
+// Finds the first occupied bucket at or after `index` in one buffer.
+static bool
+seek_occupied_in(const autk_hash_buffer_t *buf, size_t index, size_t *out_index)
 {
-    autk_hash_t *bucket;
+    size_t word_index = index / 64;
+    size_t word_count = bitmap_word_count(buf->bucket_count);
+    uint64_t word;
 
-    if (ht->used_count == 0) {
+    if (index >= buf->bucket_count) {
         return false;
     }
 
-    for (size_t i = 0; i < ht->bucket_count; i++) {
-        bucket = (autk_hash_t *)(ht->data + i * ht->bucket_size);
-        if (*bucket & HASH_OCCUPIED_BIT) {
-            iter->index = i;
-            return true;
+    // Ignore the bits before `index` in the first word.
+    word = buf->occupied[word_index] & (~(uint64_t)0 << (index % 64));
+    while (!word) {
+        if (++word_index == word_count) {
+            return false;
         }
+        word = buf->occupied[word_index];
+    }
+
+    *out_index = word_index * 64 + autk_uint64_ctz(word);
+    return true;
+}
+
+// Finds the first occupied bucket at or after `index`, counting the old buffer after the current
+// one.
+static bool
+seek_occupied(const autk_hash_table_t *ht, size_t index, autk_hash_iter_t *iter)
+{
+    size_t found;
+
+    if (index < ht->buf.bucket_count && seek_occupied_in(&ht->buf, index, &found)) {
+        iter->index = found;
+        return true;
+    }
+
+    // Buckets before `migrate_index` have all been moved already, and have their bits cleared.
+    index = autk_size_max(index, ht->buf.bucket_count) - ht->buf.bucket_count;
+    if (ht->old_buf.ctrl && seek_occupied_in(&ht->old_buf, index, &found)) {
+        iter->index = ht->buf.bucket_count + found;
+        return true;
     }
 
-    // Should never be reached unless the table is corrupted.
     return false;
 }
 
+AUTK_HIDDEN bool
+autk_hash_table_begin(const autk_hash_table_t *ht, autk_hash_iter_t *iter)
+{
+    if (ht->used_count == 0) {
+        return false;
+    }
+
+    return seek_occupied(ht, 0, iter);
+}
+
 AUTK_HIDDEN bool
 autk_hash_table_next(const autk_hash_table_t *ht, autk_hash_iter_t *iter)
 {
-    autk_hash_t *bucket;
+    return seek_occupied(ht, iter->index + 1, iter);
+}
 
-    for (size_t i = iter->index + 1; i < ht->bucket_count; i++) {
-        bucket = (autk_hash_t *)(ht->data + i * ht->bucket_size);
-        if (*bucket & HASH_OCCUPIED_BIT) {
-            iter->index = i;
-            return true;
-        }
+AUTK_HIDDEN autk_status_t
+autk_hash_table_prepare_insert(autk_hash_table_t *ht)
+{
+    // While an old buffer is draining, leave any growth or rebuild until it's empty, since starting
+    // another resize would have to finish this one in a single call. The current buffer can't fill
+    // up in the meantime: it starts out no more than 3/4 full, every insert moves
+    // `MIGRATE_BUCKETS_PER_OP` old buckets, and the old buffer has at most as many buckets as the
+    // current one, so it drains before another 1/`MIGRATE_BUCKETS_PER_OP` of the buckets are used.
+    if (ht->old_buf.ctrl) {
+        migrate(ht, MIGRATE_BUCKETS_PER_OP);
+        return AUTK_OK;
     }
 
-    return false;
+    // Make sure the buffer is large enough for a new element, even if we don't end up inserting a
+    // new one. This is the most convenient place to put this check while only having it in one
+    // place.
+    AUTK_TRY(autk_hash_table_reserve(ht, ht->used_count + 1));
+
+    // If it's tombstones rather than live elements that are filling up the buffer, rebuild it at the
+    // same size without them.
+    if (ht->used_count + ht->buf.tombstone_count + 1 > max_load(ht->buf.bucket_count)) {
+        AUTK_TRY(begin_resize(ht, ht->buf.bucket_count));
+    }
+
+    // Spread any pending resize over many inserts instead of stalling on one.
+    migrate(ht, MIGRATE_BUCKETS_PER_OP);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_hash_table_prepare_remove(autk_hash_table_t *ht)
+{
+    // Migrate before the lookup so that the removed element can't be overwritten by the move.
+    migrate(ht, MIGRATE_BUCKETS_PER_OP);
+}
+
+AUTK_HIDDEN void *
+autk_hash_table_claim(autk_hash_table_t *ht, autk_hash_t hash, autk_hash_iter_t *out_iter)
+{
+    size_t index = claim_bucket(ht, hash);
+
+    ht->used_count++;
+    out_iter->index = index;
+    return element_at(ht, &ht->buf, index);
 }
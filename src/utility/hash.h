@@ -18,26 +18,72 @@
 #define AUTK_UTILITY_HASH_H_
 
 #include <autk/types.h>
+#include <utility/math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define AUTK_HASH_GROUP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define AUTK_HASH_GROUP_NEON 1
+#endif
+
+#define AUTK_HASH_CTRL_EMPTY 0x80
+#define AUTK_HASH_CTRL_TOMBSTONE 0xFE
+#define AUTK_HASH_CTRL_FREE_BIT 0x80 // set for empty buckets and tombstones
+#define AUTK_HASH_TAG_BITS 7
+#define AUTK_HASH_GROUP_SIZE 16
+
+// A group mask has one bit per matching bucket in the group, except on NEON, where each bucket
+// gets a nibble and only the top bit of the nibble is kept.
+#if AUTK_HASH_GROUP_NEON
+# define AUTK_HASH_GROUP_MASK_SHIFT 2
+#else
+# define AUTK_HASH_GROUP_MASK_SHIFT 0
+#endif
 
 typedef uintptr_t autk_hash_t;
 typedef autk_hash_t (*autk_hash_func_t)(const void *key);
 typedef bool (*autk_hash_eq_func_t)(const void *key0, const void *key1);
+typedef uint64_t autk_hash_group_mask_t;
 
+typedef struct autk_hash_buffer autk_hash_buffer_t;
 typedef struct autk_hash_iter autk_hash_iter_t;
 typedef struct autk_hash_table autk_hash_table_t;
 
+// One bucket array. Each bucket has a one-byte control tag in `ctrl` (empty, tombstone, or 7 bits
+// of the element's hash), and the element payloads live in a separate array. Lookups compare a
+// whole group of control bytes at once and only touch the payload array when a tag matches.
+// Iteration uses the `occupied` bitmap instead, so it can skip 64 unused buckets at a time.
+struct autk_hash_buffer {
+    size_t bucket_count; // always a power of two and a multiple of the group size
+    size_t worst_miss; // most extra groups any element is away from its home group
+    size_t tombstone_count;
+    uint8_t *ctrl;
+    char *elements;
+    uint64_t *occupied; // one bit per bucket that holds a live element
+};
+
+// Open-addressing table in the style of a Swiss table.
+//
+// Growing is incremental: the table allocates a larger buffer but keeps the old one alive, and each
+// insert or remove moves a bounded number of old buckets over until the old buffer is drained.
+// Lookups check both buffers in the meantime.
 struct autk_hash_table {
     autk_instance_t *instance; // for allocation
     size_t element_size;
     autk_hash_func_t hash_func;
     autk_hash_eq_func_t eq_func;
-    size_t bucket_size;
-    size_t bucket_count;
-    size_t used_count;
-    size_t worst_miss;
-    char *data;
+    size_t element_stride;
+    size_t used_count; // across both buffers
+    autk_hash_buffer_t buf;
+    autk_hash_buffer_t old_buf; // only allocated while a resize is in progress
+    size_t migrate_index; // next bucket in `old_buf` to move
 };
 
+// Indices at or past `buf.bucket_count` refer to `old_buf`. Iterators are invalidated by
+// `autk_hash_table_insert()`, `autk_hash_table_remove()`, and anything that resizes the table, but
+// not by `autk_hash_table_remove_iter()`.
 struct autk_hash_iter {
     size_t index;
 };
@@ -58,6 +104,12 @@ autk_hash_table_get(autk_hash_table_t *ht, autk_hash_iter_t iter);
 AUTK_HIDDEN autk_status_t
 autk_hash_table_reserve(autk_hash_table_t *ht, size_t min_count);
 
+// Rebuilds the table into the smallest buffer that fits its elements, dropping all tombstones, or
+// frees the buffer if the table is empty. Unlike growing, this finishes the rehash before
+// returning.
+AUTK_HIDDEN autk_status_t
+autk_hash_table_shrink_to_fit(autk_hash_table_t *ht);
+
 // Does not motify the existing element if the key was found (*inserted == false). If the caller
 // needs to update the data, it should use `autk_hash_table_get()` to get a pointer to the existing
 // data.
@@ -77,4 +129,295 @@ autk_hash_table_begin(const autk_hash_table_t *ht, autk_hash_iter_t *iter);
 AUTK_HIDDEN bool
 autk_hash_table_next(const autk_hash_table_t *ht, autk_hash_iter_t *iter);
 
+// The following are the building blocks of `autk_hash_table_insert()` and
+// `autk_hash_table_remove()`, for callers that inline their own lookups. See
+// `AUTK_DEFINE_HASH_TABLE`.
+
+// Makes room for one more element and does a bounded step of any pending resize.
+AUTK_HIDDEN autk_status_t
+autk_hash_table_prepare_insert(autk_hash_table_t *ht);
+
+// Does a bounded step of any pending resize.
+AUTK_HIDDEN void
+autk_hash_table_prepare_remove(autk_hash_table_t *ht);
+
+// Claims a bucket for a new element with the given mixed hash and returns a pointer to its
+// uninitialized payload. The caller must have called `autk_hash_table_prepare_insert()` and checked
+// that the key isn't already present.
+AUTK_HIDDEN void *
+autk_hash_table_claim(autk_hash_table_t *ht, autk_hash_t hash, autk_hash_iter_t *out_iter);
+
+//==============================================================================
+//
+// Inline lookup
+//
+//==============================================================================
+
+// Returns a mask of buckets in the group whose control byte equals `value`.
+static inline autk_hash_group_mask_t
+autk_hash_group_match(const uint8_t *ctrl, uint8_t value)
+{
+#if AUTK_HASH_GROUP_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#elif AUTK_HASH_GROUP_NEON
+    uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+#else
+    autk_hash_group_mask_t mask = 0;
+
+    for (unsigned i = 0; i < AUTK_HASH_GROUP_SIZE; i++) {
+        if (ctrl[i] == value) {
+            mask |= (autk_hash_group_mask_t)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// Returns a mask of buckets in the group that are either empty or tombstones.
+static inline autk_hash_group_mask_t
+autk_hash_group_match_free(const uint8_t *ctrl)
+{
+#if AUTK_HASH_GROUP_SSE2
+    return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif AUTK_HASH_GROUP_NEON
+    uint8x16_t free = vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(free), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+#else
+    autk_hash_group_mask_t mask = 0;
+
+    for (unsigned i = 0; i < AUTK_HASH_GROUP_SIZE; i++) {
+        if (ctrl[i] & AUTK_HASH_CTRL_FREE_BIT) {
+            mask |= (autk_hash_group_mask_t)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static inline size_t
+autk_hash_mask_first(autk_hash_group_mask_t mask)
+{
+    return autk_uint64_ctz(mask) >> AUTK_HASH_GROUP_MASK_SHIFT;
+}
+
+static inline autk_hash_group_mask_t
+autk_hash_mask_clear_first(autk_hash_group_mask_t mask)
+{
+    return mask & (mask - 1);
+}
+
+// Spreads the caller's hash across all bits, since callers tend to provide weak hashes (such as
+// small sequential resource IDs) and we take the tag and the home group from different bits.
+static inline autk_hash_t
+autk_hash_mix(autk_hash_t hash)
+{
+#if UINTPTR_MAX > 0xFFFFFFFFu
+    hash *= (autk_hash_t)0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 32;
+#else
+    hash *= (autk_hash_t)0x9E3779B9ul;
+    hash ^= hash >> 16;
+#endif
+    return hash;
+}
+
+static inline uint8_t
+autk_hash_tag(autk_hash_t hash)
+{
+    return (uint8_t)(hash & ((1u << AUTK_HASH_TAG_BITS) - 1));
+}
+
+static inline size_t
+autk_hash_home_group(const autk_hash_buffer_t *buf, autk_hash_t hash)
+{
+    return (size_t)(hash >> AUTK_HASH_TAG_BITS) & (buf->bucket_count / AUTK_HASH_GROUP_SIZE - 1);
+}
+
+// Groups are probed in triangular order, which visits every group when the group count is a power
+// of two.
+static inline size_t
+autk_hash_next_group(const autk_hash_buffer_t *buf, size_t group, size_t miss)
+{
+    return (group + miss + 1) & (buf->bucket_count / AUTK_HASH_GROUP_SIZE - 1);
+}
+
+// Looks up a key in one buffer given its mixed hash. When `eq_func` is a compile-time constant, the
+// comparison is inlined along with the probe loop.
+static AUTK_ALWAYS_INLINE bool
+autk_hash_buffer_find(const autk_hash_table_t *ht, const autk_hash_buffer_t *buf, const void *key,
+                      autk_hash_t hash, autk_hash_eq_func_t eq_func, size_t *out_index)
+{
+    uint8_t tag = autk_hash_tag(hash);
+    size_t group = autk_hash_home_group(buf, hash);
+    const uint8_t *ctrl;
+    size_t index;
+    autk_hash_group_mask_t mask;
+
+    for (size_t miss = 0; miss <= buf->worst_miss; miss++) {
+        ctrl = buf->ctrl + group * AUTK_HASH_GROUP_SIZE;
+
+        // Only compare keys whose tags match.
+        for (mask = autk_hash_group_match(ctrl, tag); mask; mask = autk_hash_mask_clear_first(mask)) {
+            index = group * AUTK_HASH_GROUP_SIZE + autk_hash_mask_first(mask);
+            if (eq_func(key, buf->elements + index * ht->element_stride)) {
+                *out_index = index;
+                return true;
+            }
+        }
+
+        // An empty bucket means no element was ever pushed past this group.
+        if (autk_hash_group_match(ctrl, AUTK_HASH_CTRL_EMPTY)) {
+            return false;
+        }
+
+        group = autk_hash_next_group(buf, group, miss);
+    }
+
+    return false;
+}
+
+// Looks up a key in both buffers given its mixed hash, and returns a pointer to the element or
+// `NULL` if it isn't found.
+static AUTK_ALWAYS_INLINE void *
+autk_hash_table_lookup(const autk_hash_table_t *ht, const void *key, autk_hash_t hash,
+                       autk_hash_eq_func_t eq_func, autk_hash_iter_t *out_iter)
+{
+    size_t index;
+
+    if (ht->used_count == 0) {
+        return NULL;
+    } else if (autk_hash_buffer_find(ht, &ht->buf, key, hash, eq_func, &index)) {
+        out_iter->index = index;
+        return ht->buf.elements + index * ht->element_stride;
+    } else if (ht->old_buf.ctrl
+               && autk_hash_buffer_find(ht, &ht->old_buf, key, hash, eq_func, &index))
+    {
+        out_iter->index = ht->buf.bucket_count + index;
+        return ht->old_buf.elements + index * ht->element_stride;
+    }
+
+    return NULL;
+}
+
+//==============================================================================
+//
+// Typed hash tables
+//
+//==============================================================================
+
+// Hash and equality functions for tables keyed by a `uint32_t` at the start of each element.
+static inline autk_hash_t
+autk_hash_uint32(const void *key)
+{
+    return *(const uint32_t *)key;
+}
+
+static inline bool
+autk_hash_uint32_eq(const void *key0, const void *key1)
+{
+    return *(const uint32_t *)key0 == *(const uint32_t *)key1;
+}
+
+// Hash and equality functions for tables keyed by a `uint64_t` at the start of each element.
+static inline autk_hash_t
+autk_hash_uint64(const void *key)
+{
+    uint64_t n = *(const uint64_t *)key;
+
+    return (autk_hash_t)(n ^ (n >> 32));
+}
+
+static inline bool
+autk_hash_uint64_eq(const void *key0, const void *key1)
+{
+    return *(const uint64_t *)key0 == *(const uint64_t *)key1;
+}
+
+// Defines `name_t`, a map from `key_type` to `value_type` built on `autk_hash_table_t`, and the
+// `name_init()`, `name_fini()`, `name_find()`, `name_insert()`, and `name_remove()` functions.
+//
+// `hash_func` and `eq_func` must be static inline functions with the `autk_hash_func_t` and
+// `autk_hash_eq_func_t` signatures that read the key from the start of an element. The hot paths
+// call them directly so that they are inlined, and keys and values are stored by assignment rather
+// than a runtime-sized copy. Resizing is shared with the generic table.
+#define AUTK_DEFINE_HASH_TABLE(name, key_type, value_type, hash_func, eq_func)                     \
+    typedef struct name##_entry {                                                                  \
+        key_type key;                                                                              \
+        value_type value;                                                                          \
+    } name##_entry_t;                                                                              \
+                                                                                                   \
+    typedef struct name {                                                                          \
+        autk_hash_table_t ht;                                                                      \
+    } name##_t;                                                                                    \
+                                                                                                   \
+    static inline void name##_init(autk_instance_t *instance, name##_t *map)                       \
+    {                                                                                              \
+        autk_hash_table_init(instance, &map->ht, sizeof(name##_entry_t), hash_func, eq_func);      \
+    }                                                                                              \
+                                                                                                   \
+    static inline void name##_fini(name##_t *map)                                                  \
+    {                                                                                              \
+        autk_hash_table_fini(&map->ht);                                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline value_type *name##_find(const name##_t *map, key_type key)                       \
+    {                                                                                              \
+        autk_hash_iter_t iter;                                                                     \
+        name##_entry_t *entry;                                                                     \
+                                                                                                   \
+        entry = autk_hash_table_lookup(&map->ht, &key, autk_hash_mix(hash_func(&key)), eq_func,    \
+                                       &iter);                                                     \
+        return entry ? &entry->value : NULL;                                                       \
+    }                                                                                              \
+                                                                                                   \
+    static inline autk_status_t name##_insert(name##_t *map, key_type key, value_type value,       \
+                                              value_type **out_value, bool *out_inserted)          \
+    {                                                                                              \
+        autk_hash_t hash = autk_hash_mix(hash_func(&key));                                         \
+        autk_hash_iter_t iter;                                                                     \
+        name##_entry_t *entry;                                                                     \
+        autk_status_t status;                                                                      \
+                                                                                                   \
+        status = autk_hash_table_prepare_insert(&map->ht);                                         \
+        if (status != AUTK_OK) {                                                                   \
+            return status;                                                                         \
+        }                                                                                          \
+                                                                                                   \
+        entry = autk_hash_table_lookup(&map->ht, &key, hash, eq_func, &iter);                      \
+        if (out_inserted) {                                                                        \
+            *out_inserted = !entry;                                                                \
+        }                                                                                          \
+        if (!entry) {                                                                              \
+            entry = autk_hash_table_claim(&map->ht, hash, &iter);                                  \
+            entry->key = key;                                                                      \
+            entry->value = value;                                                                  \
+        }                                                                                          \
+        if (out_value) {                                                                           \
+            *out_value = &entry->value;                                                            \
+        }                                                                                          \
+        return AUTK_OK;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool name##_remove(name##_t *map, key_type key, value_type *out_value)           \
+    {                                                                                              \
+        autk_hash_iter_t iter;                                                                     \
+        name##_entry_t *entry;                                                                     \
+                                                                                                   \
+        autk_hash_table_prepare_remove(&map->ht);                                                  \
+        entry = autk_hash_table_lookup(&map->ht, &key, autk_hash_mix(hash_func(&key)), eq_func,    \
+                                       &iter);                                                     \
+        if (!entry) {                                                                              \
+            return false;                                                                          \
+        }                                                                                          \
+        if (out_value) {                                                                           \
+            *out_value = entry->value;                                                             \
+        }                                                                                          \
+        autk_hash_table_remove_iter(&map->ht, iter);                                               \
+        return true;                                                                               \
+    }
+
 #endif // AUTK_UTILITY_HASH_H_
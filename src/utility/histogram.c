@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <utility/math.h>
+
+#include "histogram.h"
+
+// Values below `AUTK_HISTOGRAM_SUB_BUCKET_COUNT` get a bucket each. Above that, a value's bucket is
+// chosen by its highest set bit and the `AUTK_HISTOGRAM_SUB_BUCKET_BITS` bits below it.
+static uint32_t
+bucket_index(uint64_t value)
+{
+    uint32_t shift;
+
+    if (value < AUTK_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return (uint32_t)value;
+    }
+
+    shift = autk_uint64_log2(value) - AUTK_HISTOGRAM_SUB_BUCKET_BITS;
+    return (shift + 1) * AUTK_HISTOGRAM_SUB_BUCKET_COUNT
+           + (uint32_t)((value >> shift) & (AUTK_HISTOGRAM_SUB_BUCKET_COUNT - 1));
+}
+
+// Returns the largest value that maps to the bucket.
+static uint64_t
+bucket_upper_bound(uint32_t index)
+{
+    uint32_t shift;
+    uint64_t base;
+
+    if (index < AUTK_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    shift = index / AUTK_HISTOGRAM_SUB_BUCKET_COUNT - 1;
+    base = (uint64_t)(AUTK_HISTOGRAM_SUB_BUCKET_COUNT + index % AUTK_HISTOGRAM_SUB_BUCKET_COUNT)
+           << shift;
+    return base + (((uint64_t)1 << shift) - 1);
+}
+
+AUTK_HIDDEN void
+autk_histogram_init(autk_histogram_t *histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+}
+
+AUTK_HIDDEN void
+autk_histogram_record(autk_histogram_t *histogram, uint64_t value)
+{
+    uint32_t *bucket = &histogram->buckets[bucket_index(value)];
+
+    // Saturate rather than wrap, so a very long run only skews the percentiles.
+    if (*bucket != UINT32_MAX) {
+        ++*bucket;
+    }
+    histogram->count++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+AUTK_HIDDEN uint64_t
+autk_histogram_percentile(const autk_histogram_t *histogram, uint32_t permille)
+{
+    uint64_t total = 0;
+    uint64_t target;
+    uint64_t seen = 0;
+
+    for (uint32_t i = 0; i < AUTK_HISTOGRAM_BUCKET_COUNT; i++) {
+        total += histogram->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the requested value, rounded up so that p100 is the last value.
+    target = (total * permille + 999) / 1000;
+    if (target == 0) {
+        target = 1;
+    }
+
+    for (uint32_t i = 0; i < AUTK_HISTOGRAM_BUCKET_COUNT; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            uint64_t bound = bucket_upper_bound(i);
+
+            return bound < histogram->max ? bound : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
+
+AUTK_HIDDEN void
+autk_histogram_summarize(const autk_histogram_t *histogram, autk_latency_stats_t *out_stats)
+{
+    out_stats->count = histogram->count;
+    out_stats->p50_ns = autk_histogram_percentile(histogram, 500);
+    out_stats->p99_ns = autk_histogram_percentile(histogram, 990);
+    out_stats->max_ns = histogram->max;
+}
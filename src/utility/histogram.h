@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_HISTOGRAM_H_
+#define AUTK_UTILITY_HISTOGRAM_H_
+
+#include <autk/types.h>
+
+// Each power of two is split into this many linear sub-buckets, so percentiles are accurate to
+// within 1/8 of the value.
+#define AUTK_HISTOGRAM_SUB_BUCKET_BITS 3
+#define AUTK_HISTOGRAM_SUB_BUCKET_COUNT (1 << AUTK_HISTOGRAM_SUB_BUCKET_BITS)
+#define AUTK_HISTOGRAM_BUCKET_COUNT                                                                \
+    ((64 - AUTK_HISTOGRAM_SUB_BUCKET_BITS + 1) * AUTK_HISTOGRAM_SUB_BUCKET_COUNT)
+
+typedef struct autk_histogram autk_histogram_t;
+
+// Log-linear histogram of 64-bit values. Recording is a handful of integer operations, so it can
+// sit on hot paths. Not thread-safe.
+struct autk_histogram {
+    uint64_t count;
+    uint64_t max;
+    uint32_t buckets[AUTK_HISTOGRAM_BUCKET_COUNT];
+};
+
+AUTK_HIDDEN void
+autk_histogram_init(autk_histogram_t *histogram);
+
+AUTK_HIDDEN void
+autk_histogram_record(autk_histogram_t *histogram, uint64_t value);
+
+// Returns an upper bound of the value below which `permille` thousandths of the recorded values
+// fall, or 0 if nothing has been recorded.
+AUTK_HIDDEN uint64_t
+autk_histogram_percentile(const autk_histogram_t *histogram, uint32_t permille);
+
+// Fills in the count, p50, p99 and maximum.
+AUTK_HIDDEN void
+autk_histogram_summarize(const autk_histogram_t *histogram, autk_latency_stats_t *out_stats);
+
+#endif // AUTK_UTILITY_HISTOGRAM_H_
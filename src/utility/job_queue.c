@@ -16,90 +16,391 @@
 
 #include <assert.h>
 #include <stdatomic.h>
+#include <string.h>
 
 #include <autk/diagnostics.h>
-#include <os/sync.h>
+#include <autk/instance.h>
+#include <core/types.h>
+#include <os/time.h>
 
 #include "job_queue.h"
 
-static_assert((AUTK_JOB_QUEUE_MAX & (AUTK_JOB_QUEUE_MAX - 1)) == 0,
-              "AUTK_JOB_QUEUE_MAX must be a power of two");
+static_assert(AUTK_JOB_QUEUE_POOL_SIZE < UINT32_MAX, "Pool indices must fit in the free list");
+static_assert(AUTK_JOB_INLINE_DATA_SIZE <= UINT8_MAX, "Inline data size must fit in a node");
 
-AUTK_HIDDEN autk_status_t
-autk_job_queue_init(autk_job_queue_t *queue)
+//==============================================================================
+//
+// Statistics
+//
+//==============================================================================
+
+// These compile to nothing unless AUTK_JOB_STATS is enabled.
+
+static inline uint64_t
+stats_now(void)
 {
-    *queue = (autk_job_queue_t){0};
-    AUTK_TRY(autk_semaphore_init(&queue->n_free_nodes_sem, AUTK_JOB_QUEUE_MAX));
-    return AUTK_OK;
+#if AUTK_JOB_STATS
+    return autk_monotonic_time_ns();
+#else
+    return 0;
+#endif
 }
 
+static inline void
+stats_note_pushed(autk_job_queue_t *queue, size_t pushed_count, size_t failed_count)
+{
+#if AUTK_JOB_STATS
+    uint64_t queued_count;
+    uint64_t peak;
+
+    if (failed_count) {
+        atomic_fetch_add_explicit(&queue->push_failure_count, failed_count, memory_order_relaxed);
+    }
+    if (!pushed_count) {
+        return;
+    }
+
+    queued_count = atomic_fetch_add_explicit(&queue->queued_count, pushed_count,
+                                             memory_order_relaxed)
+                   + pushed_count;
+    peak = atomic_load_explicit(&queue->peak_queued_count, memory_order_relaxed);
+    while (queued_count > peak
+           && !atomic_compare_exchange_weak_explicit(&queue->peak_queued_count, &peak,
+                                                     queued_count, memory_order_relaxed,
+                                                     memory_order_relaxed)) {
+    }
+#else
+    (void)queue;
+    (void)pushed_count;
+    (void)failed_count;
+#endif
+}
+
+static inline void
+stats_note_popped(autk_job_queue_t *queue, autk_job_queue_node_t *node,
+                  autk_job_queue_item_t *item)
+{
+#if AUTK_JOB_STATS
+    atomic_fetch_sub_explicit(&queue->queued_count, 1, memory_order_relaxed);
+    item->post_time_ns = node->post_time_ns;
+#else
+    (void)queue;
+    (void)node;
+    (void)item;
+#endif
+}
+
+static inline void
+stats_stamp_node(autk_job_queue_node_t *node, uint64_t now)
+{
+#if AUTK_JOB_STATS
+    node->post_time_ns = now;
+#else
+    (void)node;
+    (void)now;
+#endif
+}
+
+#if AUTK_JOB_STATS
 AUTK_HIDDEN void
-autk_job_queue_fini(autk_job_queue_t *queue)
+autk_job_queue_get_stats(autk_job_queue_t *queue, autk_client_stats_t *out_stats)
 {
-    autk_semaphore_fini(&queue->n_free_nodes_sem);
+    out_stats->peak_queued_jobs =
+        atomic_load_explicit(&queue->peak_queued_count, memory_order_relaxed);
+    out_stats->node_pool_miss_count =
+        atomic_load_explicit(&queue->pool_miss_count, memory_order_relaxed);
+    out_stats->post_failure_count =
+        atomic_load_explicit(&queue->push_failure_count, memory_order_relaxed);
+}
+#endif
+
+//==============================================================================
+//
+// Node allocation
+//
+//==============================================================================
+
+// Pops a node off the pool's free list. Any producer may call this concurrently, so the list head
+// carries a tag that changes on every update to keep a stale head from being swapped back in.
+static autk_job_queue_node_t *
+pop_pooled_node(autk_job_queue_t *queue)
+{
+    uint64_t top = atomic_load_explicit(&queue->free_top, memory_order_acquire);
+    uint64_t new_top;
+    uint32_t index;
+
+    do {
+        index = (uint32_t)top;
+        if (index == 0) {
+            return NULL;
+        }
+        new_top = ((top >> 32) + 1) << 32
+                  | atomic_load_explicit(&queue->node_pool[index - 1].free_next,
+                                         memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&queue->free_top, &top, new_top,
+                                                    memory_order_acquire, memory_order_acquire));
+
+    return &queue->node_pool[index - 1];
 }
 
 static void
-do_push(autk_job_queue_t *queue, autk_job_t job)
+push_pooled_node(autk_job_queue_t *queue, autk_job_queue_node_t *node)
 {
-    size_t node_index;
-    autk_job_queue_node_t *node;
+    uint64_t top = atomic_load_explicit(&queue->free_top, memory_order_relaxed);
+    uint64_t new_top;
+    uint32_t index = (uint32_t)(node - queue->node_pool) + 1;
 
-    node_index =
-        atomic_fetch_add_explicit(&queue->nodes_back, 1, memory_order_relaxed) % AUTK_JOB_QUEUE_MAX;
-    node = &queue->node_pool[node_index];
-    node->job = job;
-    atomic_store_explicit(&node->ready, true, memory_order_release);
-    atomic_fetch_add_explicit(&queue->n_queued_jobs, 1, memory_order_release);
+    do {
+        atomic_store_explicit(&node->free_next, (uint32_t)top, memory_order_relaxed);
+        new_top = ((top >> 32) + 1) << 32 | index;
+    } while (!atomic_compare_exchange_weak_explicit(&queue->free_top, &top, new_top,
+                                                    memory_order_release, memory_order_relaxed));
 }
 
-AUTK_HIDDEN autk_status_t
-autk_job_queue_try_push(autk_job_queue_t *queue, autk_job_t job)
+static autk_status_t
+alloc_node(autk_job_queue_t *queue, autk_job_queue_node_t **out_node)
 {
-    AUTK_TRY(autk_semaphore_try_acquire(&queue->n_free_nodes_sem));
-    do_push(queue, job);
+    autk_job_queue_node_t *node = pop_pooled_node(queue);
+
+    if (!node) {
+#if AUTK_JOB_STATS
+        atomic_fetch_add_explicit(&queue->pool_miss_count, 1, memory_order_relaxed);
+#endif
+        // Producers run on arbitrary threads, so they can only fall back to the instance's
+        // allocator if it says that's safe.
+        if (!(queue->instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC)) {
+            return AUTK_ERR_QUEUE_FULL;
+        }
+        node = autk_instance_alloc(queue->instance, NULL, 0, sizeof(autk_job_queue_node_t),
+                                   AUTK_MEMORY_TAG_QUEUE);
+        if (!node) {
+            return AUTK_ERR_OUT_OF_MEMORY;
+        }
+        node->pooled = false;
+    }
+
+    node->data_storage = AUTK_JOB_QUEUE_DATA_NONE;
+    *out_node = node;
     return AUTK_OK;
 }
 
+static void
+free_node(autk_job_queue_t *queue, autk_job_queue_node_t *node)
+{
+    if (node->pooled) {
+        push_pooled_node(queue, node);
+    } else {
+        autk_instance_alloc(queue->instance, node, sizeof(autk_job_queue_node_t), 0,
+                            AUTK_MEMORY_TAG_QUEUE);
+    }
+}
+
+//==============================================================================
+//
+// Queue
+//
+//==============================================================================
+
+// Appends a chain of nodes from `first` to `last` to the list. A producer preempted between the
+// exchange and the store leaves the list briefly cut at `prev`, which the consumer reports as
+// `AUTK_ERR_TRY_AGAIN`.
+static void
+link_nodes(autk_job_queue_t *queue, autk_job_queue_node_t *first, autk_job_queue_node_t *last)
+{
+    autk_job_queue_node_t *prev;
+
+    atomic_store_explicit(&last->next, NULL, memory_order_relaxed);
+    prev = atomic_exchange_explicit(&queue->head, last, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, first, memory_order_release);
+}
+
 AUTK_HIDDEN autk_status_t
-autk_job_queue_push(autk_job_queue_t *queue, autk_job_t job)
+autk_job_queue_init(autk_job_queue_t *queue, autk_instance_t *instance)
 {
-    AUTK_TRY(autk_semaphore_acquire(&queue->n_free_nodes_sem));
-    do_push(queue, job);
-    return AUTK_OK;
+    *queue = (autk_job_queue_t){.instance = instance};
+
+    atomic_init(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+
+    for (uint32_t i = 0; i < AUTK_JOB_QUEUE_POOL_SIZE; i++) {
+        queue->node_pool[i].pooled = true;
+        atomic_init(&queue->node_pool[i].free_next, i + 2 <= AUTK_JOB_QUEUE_POOL_SIZE ? i + 2 : 0);
+    }
+    atomic_init(&queue->free_top, 1);
+
+    return autk_slab_init(&queue->data_slab, instance);
+}
+
+AUTK_HIDDEN void
+autk_job_queue_fini(autk_job_queue_t *queue)
+{
+    autk_job_queue_item_t item;
+
+    while (autk_job_queue_try_pop(queue, &item) == AUTK_OK) {
+        autk_job_queue_release(queue, &item);
+    }
+
+    autk_slab_fini(&queue->data_slab);
 }
 
 AUTK_HIDDEN autk_status_t
-autk_job_queue_try_pop(autk_job_queue_t *queue, autk_job_t *out_job,
-                       autk_instance_t *message_instance)
+autk_job_queue_push(autk_job_queue_t *queue, const autk_job_t *jobs, size_t job_count,
+                    size_t *out_pushed_count)
 {
+    autk_job_queue_node_t *first = NULL;
+    autk_job_queue_node_t *last = NULL;
     autk_job_queue_node_t *node;
+    autk_status_t status = AUTK_OK;
+    uint64_t now = stats_now();
+    size_t count;
+
+    // Build the chain privately, then publish it all at once.
+    for (count = 0; count < job_count; count++) {
+        status = alloc_node(queue, &node);
+        if (status != AUTK_OK) {
+            break;
+        }
+        node->job = jobs[count];
+        stats_stamp_node(node, now);
+        if (last) {
+            atomic_store_explicit(&last->next, node, memory_order_relaxed);
+        } else {
+            first = node;
+        }
+        last = node;
+    }
+
+    // Count the jobs before publishing them, so the consumer can't pop them first.
+    stats_note_pushed(queue, count, job_count - count);
+    if (first) {
+        link_nodes(queue, first, last);
+    }
+    *out_pushed_count = count;
+    return status;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_job_queue_push_data(autk_job_queue_t *queue, const autk_job_t *job, const void *data,
+                         size_t data_size)
+{
+    autk_job_queue_node_t *node;
+    void *data_block = NULL;
     autk_status_t status;
 
-    // Check if any jobs are queued.
-    if (atomic_load_explicit(&queue->n_queued_jobs, memory_order_acquire) == 0) {
-        return AUTK_ERR_QUEUE_EMPTY;
+    assert(data || !data_size);
+
+    if (data_size > AUTK_JOB_INLINE_DATA_SIZE) {
+        // The slab follows the same rule as the node pool: it only allocates if it's safe to, and
+        // otherwise hands out blocks set aside by the consumer.
+        data_block = autk_slab_alloc(&queue->data_slab, data_size);
+        if (!data_block) {
+            stats_note_pushed(queue, 0, 1);
+            if (queue->instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC) {
+                return AUTK_ERR_OUT_OF_MEMORY;
+            } else if (data_size > AUTK_SLAB_MAX_BLOCK_SIZE) {
+                // Too big for any block the consumer sets aside, so waiting won't help.
+                return AUTK_ERR_INVALID_CONFIGURATION;
+            }
+            return AUTK_ERR_QUEUE_FULL;
+        }
+        memcpy(data_block, data, data_size);
     }
 
-    // Check if the job is ready.
-    node = &queue->node_pool[queue->nodes_front];
-    if (!atomic_load_explicit(&node->ready, memory_order_acquire)) {
-        return AUTK_ERR_TRY_AGAIN;
+    status = alloc_node(queue, &node);
+    if (status != AUTK_OK) {
+        autk_slab_free(&queue->data_slab, data_block);
+        stats_note_pushed(queue, 0, 1);
+        return status;
     }
 
-    // Consume the job.
-    *out_job = node->job;
-    atomic_store_explicit(&node->ready, false, memory_order_relaxed);
-    queue->nodes_front = (queue->nodes_front + 1) % AUTK_JOB_QUEUE_MAX;
-    atomic_fetch_sub_explicit(&queue->n_queued_jobs, 1, memory_order_relaxed);
+    node->job = *job;
+    stats_stamp_node(node, stats_now());
+    if (data_block) {
+        node->job.ctx = data_block;
+        node->data_storage = AUTK_JOB_QUEUE_DATA_SLAB;
+    } else {
+        node->data_storage = AUTK_JOB_QUEUE_DATA_INLINE;
+        node->data_size = (uint8_t)data_size;
+        if (data_size) {
+            memcpy(node->data.bytes, data, data_size);
+        }
+    }
+
+    stats_note_pushed(queue, 1, 0);
+    link_nodes(queue, node, node);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_job_queue_try_pop(autk_job_queue_t *queue, autk_job_queue_item_t *out_item)
+{
+    autk_job_queue_node_t *tail = queue->tail;
+    autk_job_queue_node_t *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    // Skip over the stub.
+    if (tail == &queue->stub) {
+        if (!next) {
+            if (atomic_load_explicit(&queue->head, memory_order_acquire) == tail) {
+                return AUTK_ERR_QUEUE_EMPTY;
+            }
+            return AUTK_ERR_TRY_AGAIN;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
 
-    // Notify producers that a free node is available.
-    status = autk_semaphore_release(&queue->n_free_nodes_sem);
-    if (status != AUTK_OK && message_instance) {
-        AUTK_ERROR(message_instance,
-                   "autk_semaphore_release() failed: %s -- Message producers may freeze",
-                   autk_status_to_string(status));
+    // The tail node can only be consumed once it has a successor, so that producers always have a
+    // node to link onto. If it's the last node, put the stub back behind it.
+    if (!next) {
+        if (atomic_load_explicit(&queue->head, memory_order_acquire) != tail) {
+            return AUTK_ERR_TRY_AGAIN;
+        }
+        link_nodes(queue, &queue->stub, &queue->stub);
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+        if (!next) {
+            return AUTK_ERR_TRY_AGAIN;
+        }
     }
 
+    queue->tail = next;
+    out_item->job = tail->job;
+    out_item->data_block = NULL;
+    switch (tail->data_storage) {
+        case AUTK_JOB_QUEUE_DATA_INLINE:
+            // Copy the data out so the node can be recycled before the job runs.
+            memcpy(out_item->data.bytes, tail->data.bytes, tail->data_size);
+            out_item->job.ctx = out_item->data.bytes;
+            break;
+        case AUTK_JOB_QUEUE_DATA_SLAB:
+            out_item->data_block = tail->job.ctx;
+            break;
+        default:
+            break;
+    }
+    stats_note_popped(queue, tail, out_item);
+    free_node(queue, tail);
     return AUTK_OK;
 }
+
+AUTK_HIDDEN void
+autk_job_queue_release(autk_job_queue_t *queue, autk_job_queue_item_t *item)
+{
+    if (item->data_block) {
+        // Put the block back, then set aside more for producers if they've been using them up.
+        // Failing to isn't an error here; a producer that finds none left gets
+        // `AUTK_ERR_QUEUE_FULL`.
+        autk_slab_free(&queue->data_slab, item->data_block);
+        item->data_block = NULL;
+        autk_slab_refill(&queue->data_slab);
+    }
+}
+
+AUTK_HIDDEN bool
+autk_job_queue_is_empty(autk_job_queue_t *queue)
+{
+    // A producer moves `head` off the stub before anything else, so this also catches pushes that
+    // haven't been linked yet.
+    return queue->tail == &queue->stub
+           && atomic_load_explicit(&queue->head, memory_order_relaxed) == &queue->stub;
+}
@@ -18,41 +18,120 @@
 #define AUTK_UTILITY_JOB_QUEUE_H_
 
 #include <stdatomic.h>
+#include <stddef.h>
 
-#include <os/types.h>
+#include <autk/types.h>
 
-#define AUTK_JOB_QUEUE_MAX 32
+#include "slab.h"
+
+// Number of nodes embedded in the queue itself. Once these are all in use, further nodes are
+// allocated from the instance if its allocator is thread-safe.
+#define AUTK_JOB_QUEUE_POOL_SIZE 32
 
 typedef struct autk_job_queue autk_job_queue_t;
+typedef struct autk_job_queue_item autk_job_queue_item_t;
 typedef struct autk_job_queue_node autk_job_queue_node_t;
 
+typedef enum autk_job_queue_data_storage {
+    AUTK_JOB_QUEUE_DATA_NONE, // plain job; `ctx` belongs to the poster
+    AUTK_JOB_QUEUE_DATA_INLINE, // data is stored in the node
+    AUTK_JOB_QUEUE_DATA_SLAB, // `ctx` is a block from the queue's slab
+} autk_job_queue_data_storage_t;
+
+typedef union autk_job_queue_data {
+    max_align_t align;
+    unsigned char bytes[AUTK_JOB_INLINE_DATA_SIZE];
+} autk_job_queue_data_t;
+
 struct autk_job_queue_node {
     autk_job_t job;
-    _Atomic bool ready;
+    _Atomic(autk_job_queue_node_t *) next;
+    _Atomic uint32_t free_next; // pool index + 1 of the next free node, or 0
+    bool pooled; // false for nodes allocated from the instance
+    uint8_t data_storage; // autk_job_queue_data_storage_t
+    uint8_t data_size; // size of inline data
+#if AUTK_JOB_STATS
+    uint64_t post_time_ns;
+#endif
+    autk_job_queue_data_t data;
+};
+
+// A job popped from the queue. Data jobs have their `ctx` pointed at `data` or `data_block`, so
+// the item must stay put until it's passed to `autk_job_queue_release()`.
+struct autk_job_queue_item {
+    autk_job_t job;
+    void *data_block; // slab block to free once the job is finalized, or NULL
+#if AUTK_JOB_STATS
+    uint64_t post_time_ns;
+#endif
+    autk_job_queue_data_t data;
 };
 
+// Unbounded multi-producer, single-consumer queue. Producers link nodes onto `head` with a single
+// atomic exchange, and the consumer unlinks them from `tail`, so pushing never blocks or makes a
+// system call unless the node pool runs dry and the allocator does.
 struct autk_job_queue {
-    autk_job_queue_node_t node_pool[AUTK_JOB_QUEUE_MAX];
-    size_t nodes_front;
-    _Atomic size_t nodes_back;
-    autk_semaphore_t n_free_nodes_sem;
-    _Atomic size_t n_queued_jobs;
+    autk_instance_t *instance; // for allocation
+    _Atomic(autk_job_queue_node_t *) head; // most recently pushed node
+    autk_job_queue_node_t *tail; // owned by the consumer
+    autk_job_queue_node_t stub; // keeps the list non-empty; never carries a job
+    _Atomic uint64_t free_top; // ABA tag in the upper 32 bits, pool index + 1 in the lower
+    autk_slab_t data_slab; // data too large to store inline
+#if AUTK_JOB_STATS
+    _Atomic uint64_t queued_count;
+    _Atomic uint64_t peak_queued_count;
+    _Atomic uint64_t pool_miss_count;
+    _Atomic uint64_t push_failure_count;
+#endif
+    autk_job_queue_node_t node_pool[AUTK_JOB_QUEUE_POOL_SIZE];
 };
 
 AUTK_HIDDEN autk_status_t
-autk_job_queue_init(autk_job_queue_t *queue);
+autk_job_queue_init(autk_job_queue_t *queue, autk_instance_t *instance);
 
+// Must only be called once no producer can push anymore. Pending jobs are discarded without being
+// executed or finalized.
 AUTK_HIDDEN void
 autk_job_queue_fini(autk_job_queue_t *queue);
 
+// May be called from any thread. Never blocks. The jobs are linked in with one atomic operation, so
+// the consumer sees either none or all of them. Fails with `AUTK_ERR_QUEUE_FULL` only if the node
+// pool is exhausted and the instance's allocator isn't thread-safe, or `AUTK_ERR_OUT_OF_MEMORY` if
+// it is but allocation failed. In that case, the first `*out_pushed_count` jobs are still queued.
 AUTK_HIDDEN autk_status_t
-autk_job_queue_try_push(autk_job_queue_t *queue, autk_job_t job);
+autk_job_queue_push(autk_job_queue_t *queue, const autk_job_t *jobs, size_t job_count,
+                    size_t *out_pushed_count);
 
+// May be called from any thread. Like `autk_job_queue_push()`, but the job's context is a copy of
+// `data`. Data up to `AUTK_JOB_INLINE_DATA_SIZE` bytes is stored in the queue node itself; anything
+// larger is copied into a block from the queue's slab. If the instance's allocator isn't
+// thread-safe, that block must come from the few the consumer keeps set aside: this fails with
+// `AUTK_ERR_QUEUE_FULL` when none are left, or `AUTK_ERR_INVALID_CONFIGURATION` if `data_size` is
+// larger than `AUTK_SLAB_MAX_BLOCK_SIZE`.
 AUTK_HIDDEN autk_status_t
-autk_job_queue_push(autk_job_queue_t *queue, autk_job_t job);
+autk_job_queue_push_data(autk_job_queue_t *queue, const autk_job_t *job, const void *data,
+                         size_t data_size);
 
+// Must only be called from the consumer thread. Returns `AUTK_ERR_QUEUE_EMPTY` if no jobs are
+// queued, or `AUTK_ERR_TRY_AGAIN` if a producer is partway through pushing the next job. Once the
+// job has been executed and finalized, the item must be passed to `autk_job_queue_release()`.
 AUTK_HIDDEN autk_status_t
-autk_job_queue_try_pop(autk_job_queue_t *queue, autk_job_t *out_job,
-                       autk_instance_t *message_instance);
+autk_job_queue_try_pop(autk_job_queue_t *queue, autk_job_queue_item_t *out_item);
+
+// Must only be called from the consumer thread. Frees any storage held by a popped item, and
+// refills the slab if the item held one of its blocks.
+AUTK_HIDDEN void
+autk_job_queue_release(autk_job_queue_t *queue, autk_job_queue_item_t *item);
+
+// Must only be called from the consumer thread. Returns false if a job is queued or a producer is
+// partway through pushing one.
+AUTK_HIDDEN bool
+autk_job_queue_is_empty(autk_job_queue_t *queue);
+
+#if AUTK_JOB_STATS
+// May be called from any thread. Fills in the queue depth and node pool fields of `out_stats`.
+AUTK_HIDDEN void
+autk_job_queue_get_stats(autk_job_queue_t *queue, autk_client_stats_t *out_stats);
+#endif
 
 #endif // AUTK_UTILITY_JOB_QUEUE_H_
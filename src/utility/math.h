@@ -38,7 +38,42 @@ AUTK_BEGIN_DECLS
     }
 
 AUTK_DEFINE_INT_MATH(int32_t, int32)
+AUTK_DEFINE_INT_MATH(int64_t, int64)
 AUTK_DEFINE_INT_MATH(uint32_t, uint32)
+AUTK_DEFINE_INT_MATH(size_t, size)
+
+// Returns the number of trailing zero bits in `n`, which must not be zero.
+static inline unsigned
+autk_uint64_ctz(uint64_t n)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_ctzll(n);
+#else
+    unsigned count = 0;
+
+    while (!(n & 1)) {
+        n >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// Returns the index of the highest set bit in `n`, which must not be zero.
+static inline unsigned
+autk_uint64_log2(uint64_t n)
+{
+#ifdef __GNUC__
+    return 63 - (unsigned)__builtin_clzll(n);
+#else
+    unsigned index = 0;
+
+    while (n >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
 
 static inline size_t
 autk_align_up(size_t n)
@@ -0,0 +1,621 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <autk/math.h>
+#include <utility/math.h>
+
+#include "region.h"
+
+typedef enum region_op {
+    REGION_OP_UNION,
+    REGION_OP_INTERSECT,
+    REGION_OP_SUBTRACT,
+} region_op_t;
+
+//==============================================================================
+//
+// Storage
+//
+//==============================================================================
+
+static inline autk_bbox_t *
+mutable_rects(autk_region_t *region)
+{
+    return region->capacity > AUTK_REGION_INLINE_CAPACITY ? region->storage.heap_rects
+                                                          : region->storage.inline_rects;
+}
+
+// Grows the region's storage to hold at least `min_capacity` rectangles, keeping its contents.
+static autk_status_t
+reserve(autk_region_t *region, uint32_t min_capacity)
+{
+    uint32_t capacity = region->capacity;
+    autk_bbox_t *rects;
+
+    if (capacity >= min_capacity) {
+        return AUTK_OK;
+    }
+
+    do {
+        if (capacity > UINT32_MAX / 2 || (size_t)capacity * 2 > SIZE_MAX / sizeof(autk_bbox_t)) {
+            return AUTK_ERR_ARITHMETIC_OVERFLOW;
+        }
+        capacity *= 2;
+    } while (capacity < min_capacity);
+
+    if (region->capacity > AUTK_REGION_INLINE_CAPACITY) {
+        rects = autk_instance_alloc(region->instance, region->storage.heap_rects,
+                                    region->capacity * sizeof(autk_bbox_t),
+                                    capacity * sizeof(autk_bbox_t), AUTK_MEMORY_TAG_REGION);
+    } else {
+        rects = autk_instance_alloc(region->instance, NULL, 0, capacity * sizeof(autk_bbox_t),
+                                    AUTK_MEMORY_TAG_REGION);
+        if (rects) {
+            memcpy(rects, region->storage.inline_rects, region->rect_count * sizeof(autk_bbox_t));
+        }
+    }
+    if (!rects) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    region->storage.heap_rects = rects;
+    region->capacity = capacity;
+    return AUTK_OK;
+}
+
+static void
+update_extents(autk_region_t *region)
+{
+    const autk_bbox_t *rects = autk_region_rects(region);
+
+    if (region->rect_count == 0) {
+        region->extents = (autk_bbox_t){0};
+        return;
+    }
+
+    // Bands are sorted, so only the horizontal extents need a scan.
+    region->extents = (autk_bbox_t){
+        .x0 = rects[0].x0,
+        .y0 = rects[0].y0,
+        .x1 = rects[0].x1,
+        .y1 = rects[region->rect_count - 1].y1,
+    };
+    for (uint32_t i = 1; i < region->rect_count; i++) {
+        region->extents.x0 = autk_int32_min(region->extents.x0, rects[i].x0);
+        region->extents.x1 = autk_int32_max(region->extents.x1, rects[i].x1);
+    }
+}
+
+// Makes the region a single rectangle. Never allocates, since there's always room for one.
+static void
+set_bbox(autk_region_t *region, autk_bbox_t bbox)
+{
+    if (!autk_bbox_is_positive(&bbox)) {
+        autk_region_clear(region);
+        return;
+    }
+
+    mutable_rects(region)[0] = bbox;
+    region->rect_count = 1;
+    region->extents = bbox;
+}
+
+// Frees `dst`'s rectangles and moves `src`'s into it.
+static void
+replace(autk_region_t *dst, autk_region_t *src)
+{
+    autk_region_fini(dst);
+    *dst = *src;
+}
+
+//==============================================================================
+//
+// Band sweep
+//
+//==============================================================================
+
+// Returns the index just past the band that starts at `index`.
+static uint32_t
+band_end(const autk_bbox_t *rects, uint32_t index, uint32_t count)
+{
+    int32_t y0 = rects[index].y0;
+
+    while (++index < count && rects[index].y0 == y0) {
+    }
+    return index;
+}
+
+// Appends the spans of a band with new vertical bounds. Room must already be reserved.
+static void
+append_band(autk_region_t *out, const autk_bbox_t *spans, uint32_t span_count, int32_t y0,
+            int32_t y1)
+{
+    autk_bbox_t *rects = mutable_rects(out) + out->rect_count;
+
+    for (uint32_t i = 0; i < span_count; i++) {
+        rects[i] = (autk_bbox_t){spans[i].x0, y0, spans[i].x1, y1};
+    }
+    out->rect_count += span_count;
+}
+
+static void
+union_spans(autk_region_t *out, const autk_bbox_t *a, uint32_t a_count, const autk_bbox_t *b,
+            uint32_t b_count, int32_t y0, int32_t y1)
+{
+    autk_bbox_t *rects = mutable_rects(out);
+    uint32_t band = out->rect_count;
+    uint32_t n = band;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    const autk_bbox_t *span;
+
+    // Merge the two sorted span lists, joining spans that overlap or touch.
+    while (i < a_count || j < b_count) {
+        if (j == b_count || (i < a_count && a[i].x0 <= b[j].x0)) {
+            span = &a[i++];
+        } else {
+            span = &b[j++];
+        }
+
+        if (n > band && span->x0 <= rects[n - 1].x1) {
+            rects[n - 1].x1 = autk_int32_max(rects[n - 1].x1, span->x1);
+        } else {
+            rects[n++] = (autk_bbox_t){span->x0, y0, span->x1, y1};
+        }
+    }
+
+    out->rect_count = n;
+}
+
+static void
+intersect_spans(autk_region_t *out, const autk_bbox_t *a, uint32_t a_count, const autk_bbox_t *b,
+                uint32_t b_count, int32_t y0, int32_t y1)
+{
+    autk_bbox_t *rects = mutable_rects(out);
+    uint32_t n = out->rect_count;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    int32_t x0, x1;
+
+    while (i < a_count && j < b_count) {
+        x0 = autk_int32_max(a[i].x0, b[j].x0);
+        x1 = autk_int32_min(a[i].x1, b[j].x1);
+        if (x0 < x1) {
+            rects[n++] = (autk_bbox_t){x0, y0, x1, y1};
+        }
+
+        // Whichever span ends first can't overlap anything else.
+        if (a[i].x1 < b[j].x1) {
+            i++;
+        } else if (b[j].x1 < a[i].x1) {
+            j++;
+        } else {
+            i++;
+            j++;
+        }
+    }
+
+    out->rect_count = n;
+}
+
+static void
+subtract_spans(autk_region_t *out, const autk_bbox_t *a, uint32_t a_count, const autk_bbox_t *b,
+               uint32_t b_count, int32_t y0, int32_t y1)
+{
+    autk_bbox_t *rects = mutable_rects(out);
+    uint32_t n = out->rect_count;
+    uint32_t j = 0;
+    int32_t left;
+
+    for (uint32_t i = 0; i < a_count; i++) {
+        // Skip spans of `b` that end before this span starts. Spans of `a` are sorted, so they
+        // can't overlap any later span either.
+        left = a[i].x0;
+        while (j < b_count && b[j].x1 <= left) {
+            j++;
+        }
+
+        // Cut out each span of `b` that overlaps this one, keeping the pieces in between.
+        for (uint32_t k = j; k < b_count && b[k].x0 < a[i].x1; k++) {
+            if (b[k].x0 > left) {
+                rects[n++] = (autk_bbox_t){left, y0, b[k].x0, y1};
+            }
+            left = autk_int32_max(left, b[k].x1);
+            if (left >= a[i].x1) {
+                break;
+            }
+        }
+        if (left < a[i].x1) {
+            rects[n++] = (autk_bbox_t){left, y0, a[i].x1, y1};
+        }
+    }
+
+    out->rect_count = n;
+}
+
+// Merges the band starting at `band` into the previous band if they touch and have the same spans,
+// so the result stays canonical. Returns the start of the last band in `out`.
+static uint32_t
+coalesce(autk_region_t *out, uint32_t prev_band, uint32_t band)
+{
+    autk_bbox_t *rects = mutable_rects(out);
+    uint32_t count = out->rect_count - band;
+
+    if (count == 0) {
+        return prev_band;
+    } else if (prev_band == band || band - prev_band != count
+               || rects[prev_band].y1 != rects[band].y0) {
+        return band;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (rects[prev_band + i].x0 != rects[band + i].x0
+            || rects[prev_band + i].x1 != rects[band + i].x1) {
+            return band;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        rects[prev_band + i].y1 = rects[band + i].y1;
+    }
+    out->rect_count = band;
+    return prev_band;
+}
+
+// Sweeps down both regions one band at a time. Where only one region has a band, its spans are kept
+// or dropped depending on the operation. Where both do, the operation combines their spans.
+static autk_status_t
+region_op(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b, region_op_t op)
+{
+    const autk_bbox_t *a_rects = autk_region_rects(a);
+    const autk_bbox_t *b_rects = autk_region_rects(b);
+    uint32_t a_count = a->rect_count;
+    uint32_t b_count = b->rect_count;
+    bool keep_a = op != REGION_OP_INTERSECT;
+    bool keep_b = op == REGION_OP_UNION;
+    uint32_t a_index = 0;
+    uint32_t b_index = 0;
+    uint32_t a_end = a_count ? band_end(a_rects, 0, a_count) : 0;
+    uint32_t b_end = b_count ? band_end(b_rects, 0, b_count) : 0;
+    uint32_t prev_band = 0;
+    uint32_t band;
+    int32_t y = INT32_MIN; // everything above this has been swept
+    int32_t a_top, b_top, bottom;
+    autk_region_t out;
+    autk_status_t status;
+
+    // Size the result for the common case up front, rather than growing it a band at a time.
+    autk_region_init(dst->instance, &out);
+    status = reserve(&out, a_count + b_count);
+    if (status != AUTK_OK) {
+        return status;
+    }
+
+#define SWEEP_BAND(keep, rects, index, end, top)                                                   \
+    do {                                                                                           \
+        if (keep) {                                                                                \
+            status = reserve(&out, out.rect_count + (end - index));                                \
+            if (status != AUTK_OK) {                                                               \
+                goto fail;                                                                         \
+            }                                                                                      \
+            band = out.rect_count;                                                                 \
+            append_band(&out, &rects[index], end - index, top, bottom);                            \
+            prev_band = coalesce(&out, prev_band, band);                                           \
+        }                                                                                          \
+    } while (0)
+
+    while (a_index < a_count && b_index < b_count) {
+        a_top = autk_int32_max(a_rects[a_index].y0, y);
+        b_top = autk_int32_max(b_rects[b_index].y0, y);
+
+        if (a_top < b_top) {
+            // Only `a` covers the rows above `b`'s band.
+            bottom = autk_int32_min(a_rects[a_index].y1, b_top);
+            SWEEP_BAND(keep_a, a_rects, a_index, a_end, a_top);
+        } else if (b_top < a_top) {
+            bottom = autk_int32_min(b_rects[b_index].y1, a_top);
+            SWEEP_BAND(keep_b, b_rects, b_index, b_end, b_top);
+        } else {
+            // Both bands cover these rows.
+            bottom = autk_int32_min(a_rects[a_index].y1, b_rects[b_index].y1);
+            status = reserve(&out, out.rect_count + (a_end - a_index) + (b_end - b_index));
+            if (status != AUTK_OK) {
+                goto fail;
+            }
+            band = out.rect_count;
+            switch (op) {
+                case REGION_OP_UNION:
+                    union_spans(&out, &a_rects[a_index], a_end - a_index, &b_rects[b_index],
+                                b_end - b_index, a_top, bottom);
+                    break;
+                case REGION_OP_INTERSECT:
+                    intersect_spans(&out, &a_rects[a_index], a_end - a_index, &b_rects[b_index],
+                                    b_end - b_index, a_top, bottom);
+                    break;
+                case REGION_OP_SUBTRACT:
+                    subtract_spans(&out, &a_rects[a_index], a_end - a_index, &b_rects[b_index],
+                                   b_end - b_index, a_top, bottom);
+                    break;
+            }
+            prev_band = coalesce(&out, prev_band, band);
+        }
+
+        // Move past any band we've finished with.
+        y = bottom;
+        if (a_rects[a_index].y1 == y) {
+            a_index = a_end;
+            a_end = a_index < a_count ? band_end(a_rects, a_index, a_count) : a_index;
+        }
+        if (b_rects[b_index].y1 == y) {
+            b_index = b_end;
+            b_end = b_index < b_count ? band_end(b_rects, b_index, b_count) : b_index;
+        }
+    }
+
+    // Whatever is left of either region has nothing to combine with.
+    while (a_index < a_count) {
+        a_top = autk_int32_max(a_rects[a_index].y0, y);
+        bottom = a_rects[a_index].y1;
+        SWEEP_BAND(keep_a, a_rects, a_index, a_end, a_top);
+        a_index = a_end;
+        a_end = a_index < a_count ? band_end(a_rects, a_index, a_count) : a_index;
+    }
+    while (b_index < b_count) {
+        b_top = autk_int32_max(b_rects[b_index].y0, y);
+        bottom = b_rects[b_index].y1;
+        SWEEP_BAND(keep_b, b_rects, b_index, b_end, b_top);
+        b_index = b_end;
+        b_end = b_index < b_count ? band_end(b_rects, b_index, b_count) : b_index;
+    }
+
+#undef SWEEP_BAND
+
+    update_extents(&out);
+    replace(dst, &out);
+    return AUTK_OK;
+
+fail:
+    autk_region_fini(&out);
+    return status;
+}
+
+//==============================================================================
+//
+// Regions
+//
+//==============================================================================
+
+AUTK_HIDDEN void
+autk_region_init(autk_instance_t *instance, autk_region_t *region)
+{
+    *region = (autk_region_t){
+        .instance = instance,
+        .capacity = AUTK_REGION_INLINE_CAPACITY,
+    };
+}
+
+AUTK_HIDDEN void
+autk_region_init_bbox(autk_instance_t *instance, autk_region_t *region, autk_bbox_t bbox)
+{
+    autk_region_init(instance, region);
+    set_bbox(region, bbox);
+}
+
+AUTK_HIDDEN void
+autk_region_fini(autk_region_t *region)
+{
+    if (region->capacity > AUTK_REGION_INLINE_CAPACITY) {
+        autk_instance_alloc(region->instance, region->storage.heap_rects,
+                            region->capacity * sizeof(autk_bbox_t), 0, AUTK_MEMORY_TAG_REGION);
+    }
+    autk_region_init(region->instance, region);
+}
+
+AUTK_HIDDEN void
+autk_region_clear(autk_region_t *region)
+{
+    region->rect_count = 0;
+    region->extents = (autk_bbox_t){0};
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_copy(autk_region_t *dst, const autk_region_t *src)
+{
+    if (dst == src) {
+        return AUTK_OK;
+    }
+
+    AUTK_TRY(reserve(dst, src->rect_count));
+    memcpy(mutable_rects(dst), autk_region_rects(src), src->rect_count * sizeof(autk_bbox_t));
+    dst->rect_count = src->rect_count;
+    dst->extents = src->extents;
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_union(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b)
+{
+    // Skip the sweep if one side is empty or covers the other with a single rectangle.
+    if (b->rect_count == 0
+        || (a->rect_count == 1 && autk_bbox_contains(&a->extents, &b->extents)))
+    {
+        return autk_region_copy(dst, a);
+    } else if (a->rect_count == 0
+               || (b->rect_count == 1 && autk_bbox_contains(&b->extents, &a->extents)))
+    {
+        return autk_region_copy(dst, b);
+    }
+
+    return region_op(dst, a, b, REGION_OP_UNION);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_union_bbox(autk_region_t *dst, const autk_region_t *src, autk_bbox_t bbox)
+{
+    autk_region_t region;
+
+    autk_region_init_bbox(src->instance, &region, bbox);
+    return autk_region_union(dst, src, &region);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_intersect(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b)
+{
+    autk_bbox_t bbox;
+
+    if (a->rect_count == 0 || b->rect_count == 0 || !autk_bbox_overlaps(&a->extents, &b->extents)) {
+        autk_region_clear(dst);
+        return AUTK_OK;
+    } else if (a->rect_count == 1 && b->rect_count == 1) {
+        bbox = a->extents;
+        autk_bbox_intersect(&bbox, &b->extents);
+        set_bbox(dst, bbox);
+        return AUTK_OK;
+    } else if (a->rect_count == 1 && autk_bbox_contains(&a->extents, &b->extents)) {
+        return autk_region_copy(dst, b);
+    } else if (b->rect_count == 1 && autk_bbox_contains(&b->extents, &a->extents)) {
+        return autk_region_copy(dst, a);
+    }
+
+    return region_op(dst, a, b, REGION_OP_INTERSECT);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_intersect_bbox(autk_region_t *dst, const autk_region_t *src, autk_bbox_t bbox)
+{
+    autk_region_t region;
+
+    autk_region_init_bbox(src->instance, &region, bbox);
+    return autk_region_intersect(dst, src, &region);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_region_subtract(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b)
+{
+    if (a->rect_count == 0 || b->rect_count == 0 || !autk_bbox_overlaps(&a->extents, &b->extents)) {
+        return autk_region_copy(dst, a);
+    } else if (b->rect_count == 1 && autk_bbox_contains(&b->extents, &a->extents)) {
+        autk_region_clear(dst);
+        return AUTK_OK;
+    }
+
+    return region_op(dst, a, b, REGION_OP_SUBTRACT);
+}
+
+AUTK_HIDDEN void
+autk_region_translate(autk_region_t *region, int32_t dx, int32_t dy)
+{
+    autk_bbox_t *rects = mutable_rects(region);
+
+    if (region->rect_count == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < region->rect_count; i++) {
+        rects[i] = (autk_bbox_t){rects[i].x0 + dx, rects[i].y0 + dy, rects[i].x1 + dx,
+                                 rects[i].y1 + dy};
+    }
+    region->extents = (autk_bbox_t){region->extents.x0 + dx, region->extents.y0 + dy,
+                                    region->extents.x1 + dx, region->extents.y1 + dy};
+}
+
+// Returns the index of the first rectangle that ends below row `y`. Since bands don't overlap, this
+// is the start of the band containing `y` or the first band below it.
+static uint32_t
+find_band(const autk_region_t *region, int32_t y)
+{
+    const autk_bbox_t *rects = autk_region_rects(region);
+    uint32_t low = 0;
+    uint32_t high = region->rect_count;
+    uint32_t mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (rects[mid].y1 <= y) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+AUTK_HIDDEN bool
+autk_region_contains_point(const autk_region_t *region, int32_t x, int32_t y)
+{
+    const autk_bbox_t *rects = autk_region_rects(region);
+    uint32_t index;
+
+    if (x < region->extents.x0 || x >= region->extents.x1 || y < region->extents.y0
+        || y >= region->extents.y1) {
+        return false;
+    }
+
+    index = find_band(region, y);
+    if (index == region->rect_count || rects[index].y0 > y) {
+        return false;
+    }
+
+    for (int32_t band_y0 = rects[index].y0;
+         index < region->rect_count && rects[index].y0 == band_y0 && rects[index].x0 <= x;
+         index++) {
+        if (x < rects[index].x1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AUTK_HIDDEN bool
+autk_region_contains_bbox(const autk_region_t *region, autk_bbox_t bbox)
+{
+    const autk_bbox_t *rects = autk_region_rects(region);
+    uint32_t index;
+    int32_t y = bbox.y0;
+    bool covered;
+
+    if (!autk_bbox_is_positive(&bbox)) {
+        return true;
+    } else if (!autk_bbox_contains(&region->extents, &bbox)) {
+        return false;
+    }
+
+    // Each band the box crosses must continue the previous one without a gap, and a single span in
+    // it must cover the box's width, since spans in a band never touch.
+    index = find_band(region, y);
+    while (y < bbox.y1) {
+        if (index == region->rect_count || rects[index].y0 > y) {
+            return false;
+        }
+
+        covered = false;
+        for (int32_t band_y0 = rects[index].y0;
+             index < region->rect_count && rects[index].y0 == band_y0; index++) {
+            if (rects[index].x0 <= bbox.x0 && rects[index].x1 >= bbox.x1) {
+                covered = true;
+            }
+        }
+        if (!covered) {
+            return false;
+        }
+        y = rects[index - 1].y1;
+    }
+    return true;
+}
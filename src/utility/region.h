@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_REGION_H_
+#define AUTK_UTILITY_REGION_H_
+
+#include <autk/types.h>
+
+// Regions of up to this many rectangles don't allocate.
+#define AUTK_REGION_INLINE_CAPACITY 4
+
+typedef struct autk_region autk_region_t;
+
+// Set of pixels stored as y-banded rectangles, in the style of X11 and pixman regions. The
+// rectangles are sorted by `y0`, then `x0`. They're grouped into bands that share the same `y0` and
+// `y1`, and rectangles in a band neither overlap nor touch. Vertically adjacent bands with the same
+// horizontal spans are merged, so each region has exactly one representation.
+//
+// Operations that produce a region write a new rectangle list and then replace the destination's,
+// so the destination may also be one of the operands, and it's left unchanged on failure.
+struct autk_region {
+    autk_instance_t *instance; // for allocation
+    autk_bbox_t extents; // bounding box of the region, or all zeroes if it's empty
+    uint32_t rect_count;
+    uint32_t capacity; // `AUTK_REGION_INLINE_CAPACITY` while `inline_rects` is in use
+    union {
+        autk_bbox_t inline_rects[AUTK_REGION_INLINE_CAPACITY];
+        autk_bbox_t *heap_rects;
+    } storage;
+};
+
+static inline const autk_bbox_t *
+autk_region_rects(const autk_region_t *region)
+{
+    return region->capacity > AUTK_REGION_INLINE_CAPACITY ? region->storage.heap_rects
+                                                          : region->storage.inline_rects;
+}
+
+static inline bool
+autk_region_is_empty(const autk_region_t *region)
+{
+    return region->rect_count == 0;
+}
+
+// Initializes an empty region.
+AUTK_HIDDEN void
+autk_region_init(autk_instance_t *instance, autk_region_t *region);
+
+// Initializes a region covering `bbox`, or an empty one if `bbox` is empty.
+AUTK_HIDDEN void
+autk_region_init_bbox(autk_instance_t *instance, autk_region_t *region, autk_bbox_t bbox);
+
+AUTK_HIDDEN void
+autk_region_fini(autk_region_t *region);
+
+// Empties the region without freeing its storage.
+AUTK_HIDDEN void
+autk_region_clear(autk_region_t *region);
+
+AUTK_HIDDEN autk_status_t
+autk_region_copy(autk_region_t *dst, const autk_region_t *src);
+
+AUTK_HIDDEN autk_status_t
+autk_region_union(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b);
+
+AUTK_HIDDEN autk_status_t
+autk_region_union_bbox(autk_region_t *dst, const autk_region_t *src, autk_bbox_t bbox);
+
+AUTK_HIDDEN autk_status_t
+autk_region_intersect(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b);
+
+AUTK_HIDDEN autk_status_t
+autk_region_intersect_bbox(autk_region_t *dst, const autk_region_t *src, autk_bbox_t bbox);
+
+// Computes the pixels of `a` that aren't in `b`.
+AUTK_HIDDEN autk_status_t
+autk_region_subtract(autk_region_t *dst, const autk_region_t *a, const autk_region_t *b);
+
+AUTK_HIDDEN void
+autk_region_translate(autk_region_t *region, int32_t dx, int32_t dy);
+
+AUTK_HIDDEN bool
+autk_region_contains_point(const autk_region_t *region, int32_t x, int32_t y);
+
+// Returns true if every pixel of `bbox` is in the region. An empty `bbox` is always contained.
+AUTK_HIDDEN bool
+autk_region_contains_bbox(const autk_region_t *region, autk_bbox_t bbox);
+
+#endif // AUTK_UTILITY_REGION_H_
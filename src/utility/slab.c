@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+
+#include <autk/instance.h>
+#include <core/types.h>
+#include <os/sync.h>
+#include <utility/math.h>
+
+#include "slab.h"
+
+#define HEADER_SIZE autk_align_up(sizeof(autk_slab_block_t))
+
+// Returns the index of the smallest class that fits `size`, or `AUTK_SLAB_CLASS_COUNT` if none do.
+static uint32_t
+class_index(size_t size)
+{
+    uint32_t index = 0;
+    size_t class_size = AUTK_SLAB_MIN_BLOCK_SIZE;
+
+    while (index < AUTK_SLAB_CLASS_COUNT && class_size < size) {
+        index++;
+        class_size <<= 1;
+    }
+
+    return index;
+}
+
+static void
+free_block(autk_slab_t *slab, autk_slab_block_t *block)
+{
+    autk_instance_alloc(slab->instance, block, HEADER_SIZE + block->size, 0,
+                        AUTK_MEMORY_TAG_QUEUE);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_slab_init(autk_slab_t *slab, autk_instance_t *instance)
+{
+    autk_status_t status;
+
+    slab->instance = instance;
+
+    for (uint32_t i = 0; i < AUTK_SLAB_CLASS_COUNT; i++) {
+        status = autk_mutex_init(&slab->classes[i].lock);
+        if (status != AUTK_OK) {
+            while (i--) {
+                autk_mutex_fini(&slab->classes[i].lock);
+            }
+            return status;
+        }
+        slab->classes[i].free_count = 0;
+        slab->classes[i].free_list = NULL;
+    }
+
+    // Without a thread-safe allocator, `autk_slab_alloc()` can only hand out cached blocks, so
+    // start with some.
+    status = autk_slab_refill(slab);
+    if (status != AUTK_OK) {
+        autk_slab_fini(slab);
+        return status;
+    }
+
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_slab_fini(autk_slab_t *slab)
+{
+    for (uint32_t i = 0; i < AUTK_SLAB_CLASS_COUNT; i++) {
+        autk_slab_block_t *block = slab->classes[i].free_list;
+
+        while (block) {
+            autk_slab_block_t *next = block->next;
+
+            free_block(slab, block);
+            block = next;
+        }
+
+        slab->classes[i].free_count = 0;
+        slab->classes[i].free_list = NULL;
+        autk_mutex_fini(&slab->classes[i].lock);
+    }
+}
+
+AUTK_HIDDEN void *
+autk_slab_alloc(autk_slab_t *slab, size_t size)
+{
+    uint32_t index = class_index(size);
+    autk_slab_block_t *block = NULL;
+
+    if (index < AUTK_SLAB_CLASS_COUNT) {
+        autk_slab_class_t *size_class = &slab->classes[index];
+
+        autk_mutex_lock(&size_class->lock);
+        block = size_class->free_list;
+        if (block) {
+            size_class->free_list = block->next;
+            size_class->free_count--;
+        }
+        autk_mutex_unlock(&size_class->lock);
+
+        if (block) {
+            return (char *)block + HEADER_SIZE;
+        }
+
+        size = (size_t)AUTK_SLAB_MIN_BLOCK_SIZE << index;
+    } else if (size > SIZE_MAX - HEADER_SIZE) {
+        return NULL;
+    }
+
+    if (!(slab->instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC)) {
+        return NULL;
+    }
+
+    block = autk_instance_alloc(slab->instance, NULL, 0, HEADER_SIZE + size, AUTK_MEMORY_TAG_QUEUE);
+    if (!block) {
+        return NULL;
+    }
+
+    block->next = NULL;
+    block->size = size;
+    return (char *)block + HEADER_SIZE;
+}
+
+AUTK_HIDDEN void
+autk_slab_free(autk_slab_t *slab, void *mem)
+{
+    autk_slab_block_t *block;
+    uint32_t index;
+
+    if (!mem) {
+        return;
+    }
+
+    block = (autk_slab_block_t *)((char *)mem - HEADER_SIZE);
+    index = class_index(block->size);
+
+    if (block->size <= AUTK_SLAB_MAX_BLOCK_SIZE) {
+        autk_slab_class_t *size_class = &slab->classes[index];
+        bool cached = false;
+
+        assert(block->size == (size_t)AUTK_SLAB_MIN_BLOCK_SIZE << index);
+
+        autk_mutex_lock(&size_class->lock);
+        if (size_class->free_count < AUTK_SLAB_CACHE_LIMIT) {
+            block->next = size_class->free_list;
+            size_class->free_list = block;
+            size_class->free_count++;
+            cached = true;
+        }
+        autk_mutex_unlock(&size_class->lock);
+
+        if (cached) {
+            return;
+        }
+    }
+
+    free_block(slab, block);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_slab_refill(autk_slab_t *slab)
+{
+    autk_slab_class_t *size_class;
+    autk_slab_block_t *block;
+    size_t size;
+    bool full;
+
+    if (slab->instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC) {
+        return AUTK_OK;
+    }
+
+    for (uint32_t i = 0; i < AUTK_SLAB_CLASS_COUNT; i++) {
+        size_class = &slab->classes[i];
+        size = (size_t)AUTK_SLAB_MIN_BLOCK_SIZE << i;
+
+        // Producers may take blocks while we allocate, so check again before each one.
+        for (;;) {
+            autk_mutex_lock(&size_class->lock);
+            full = size_class->free_count >= AUTK_SLAB_REFILL_COUNT;
+            autk_mutex_unlock(&size_class->lock);
+            if (full) {
+                break;
+            }
+
+            block = autk_instance_alloc(slab->instance, NULL, 0, HEADER_SIZE + size,
+                                        AUTK_MEMORY_TAG_QUEUE);
+            if (!block) {
+                return AUTK_ERR_OUT_OF_MEMORY;
+            }
+            block->size = size;
+
+            autk_mutex_lock(&size_class->lock);
+            block->next = size_class->free_list;
+            size_class->free_list = block;
+            size_class->free_count++;
+            autk_mutex_unlock(&size_class->lock);
+        }
+    }
+
+    return AUTK_OK;
+}
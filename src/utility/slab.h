@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_SLAB_H_
+#define AUTK_UTILITY_SLAB_H_
+
+#include <autk/types.h>
+#include <os/types.h>
+
+// Block sizes are powers of two from `AUTK_SLAB_MIN_BLOCK_SIZE` up to `AUTK_SLAB_MAX_BLOCK_SIZE`.
+// Larger requests bypass the cache.
+#define AUTK_SLAB_MIN_BLOCK_SIZE 128
+#define AUTK_SLAB_CLASS_COUNT 6
+#define AUTK_SLAB_MAX_BLOCK_SIZE ((size_t)AUTK_SLAB_MIN_BLOCK_SIZE << (AUTK_SLAB_CLASS_COUNT - 1))
+
+// Freed blocks kept per size class. Beyond this, blocks go back to the instance.
+#define AUTK_SLAB_CACHE_LIMIT 16
+
+// Blocks kept ready per size class by `autk_slab_refill()` when the instance's allocator isn't
+// thread-safe, since other threads can't allocate more.
+#define AUTK_SLAB_REFILL_COUNT 4
+
+typedef struct autk_slab autk_slab_t;
+typedef struct autk_slab_block autk_slab_block_t;
+typedef struct autk_slab_class autk_slab_class_t;
+
+struct autk_slab_block {
+    autk_slab_block_t *next; // free list link
+    size_t size; // usable size following the header
+};
+
+struct autk_slab_class {
+    autk_mutex_t lock;
+    uint32_t free_count;
+    autk_slab_block_t *free_list;
+};
+
+// Thread-safe cache of variable-sized blocks, for data that's allocated on one thread and freed on
+// another often enough that going to the instance's allocator every time would show up.
+struct autk_slab {
+    autk_instance_t *instance; // for allocation
+    autk_slab_class_t classes[AUTK_SLAB_CLASS_COUNT];
+};
+
+// Calls `autk_slab_refill()`, so it must be called on a thread that may use the instance's
+// allocator.
+AUTK_HIDDEN autk_status_t
+autk_slab_init(autk_slab_t *slab, autk_instance_t *instance);
+
+// Frees all cached blocks. Blocks still in use must have been freed first.
+AUTK_HIDDEN void
+autk_slab_fini(autk_slab_t *slab);
+
+// May be called from any thread. Reuses a cached block if one is available, otherwise allocates
+// from the instance, which is only done if its allocator is thread-safe. Returns `NULL` on failure.
+// The returned memory is aligned for any type.
+AUTK_HIDDEN void *
+autk_slab_alloc(autk_slab_t *slab, size_t size);
+
+// May be called from any thread. `mem` must have come from `autk_slab_alloc()` on the same slab.
+AUTK_HIDDEN void
+autk_slab_free(autk_slab_t *slab, void *mem);
+
+// Tops each size class up to `AUTK_SLAB_REFILL_COUNT` cached blocks if the instance's allocator
+// isn't thread-safe, and does nothing otherwise. Must be called on a thread that may use the
+// allocator. On failure, the slab is still usable, just with fewer blocks cached.
+AUTK_HIDDEN autk_status_t
+autk_slab_refill(autk_slab_t *slab);
+
+#endif // AUTK_UTILITY_SLAB_H_
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdatomic.h>
+
+#include <autk/client.h>
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+#include <core/types.h>
+#include <os/sync.h>
+#include <os/thread.h>
+#include <utility/math.h>
+
+#include "thread_pool.h"
+
+#ifdef AUTK_THREAD_LOCAL
+// Worker running on the current thread, so nested submissions can skip the injection queue.
+static AUTK_THREAD_LOCAL autk_thread_pool_worker_t *current_worker;
+#endif
+
+//==============================================================================
+//
+// Task storage
+//
+//==============================================================================
+
+static void
+free_task(autk_thread_pool_t *pool, autk_task_t *task)
+{
+    autk_instance_alloc(pool->instance, task, sizeof(autk_task_t), 0, AUTK_MEMORY_TAG_TASK);
+}
+
+// Runs a task on the current worker and hands its continuation, if any, to the client.
+static void
+run_task(autk_thread_pool_t *pool, autk_task_t *task)
+{
+    task->exec(task->ctx);
+
+    if (task->client && task->complete) {
+        // Finalizes the context itself if the job can't be posted.
+        autk_client_post_job(task->client, (autk_job_t){
+                                               .ctx = task->ctx,
+                                               .exec = task->complete,
+                                               .fini = task->fini,
+                                           });
+    } else if (task->fini) {
+        task->fini(task->ctx);
+    }
+
+    free_task(pool, task);
+}
+
+//==============================================================================
+//
+// Injection queue
+//
+//==============================================================================
+
+static void
+inject_task(autk_thread_pool_t *pool, autk_task_t *task)
+{
+    task->next = NULL;
+
+    autk_mutex_lock(&pool->inject_lock);
+    if (pool->inject_tail) {
+        pool->inject_tail->next = task;
+    } else {
+        pool->inject_head = task;
+    }
+    pool->inject_tail = task;
+    atomic_fetch_add_explicit(&pool->inject_count, 1, memory_order_relaxed);
+    autk_mutex_unlock(&pool->inject_lock);
+}
+
+static autk_task_t *
+pop_injected_task(autk_thread_pool_t *pool)
+{
+    autk_task_t *task;
+
+    // Skip the lock when there's obviously nothing there.
+    if (atomic_load_explicit(&pool->inject_count, memory_order_relaxed) == 0) {
+        return NULL;
+    }
+
+    autk_mutex_lock(&pool->inject_lock);
+    task = pool->inject_head;
+    if (task) {
+        pool->inject_head = task->next;
+        if (!pool->inject_head) {
+            pool->inject_tail = NULL;
+        }
+        atomic_fetch_sub_explicit(&pool->inject_count, 1, memory_order_relaxed);
+    }
+    autk_mutex_unlock(&pool->inject_lock);
+
+    return task;
+}
+
+//==============================================================================
+//
+// Parking
+//
+//==============================================================================
+
+static bool
+has_queued_tasks(autk_thread_pool_t *pool)
+{
+    if (atomic_load_explicit(&pool->inject_count, memory_order_relaxed) != 0) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        if (!autk_work_deque_is_empty(&pool->workers[i].deque)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Claims one parked worker, if any, and posts its wakeup. The fence pairs with the one in
+// `park_worker`: either the submitter sees the sleeper or the sleeper sees the new task.
+static void
+wake_worker(autk_thread_pool_t *pool)
+{
+    uint32_t sleeper_count;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    sleeper_count = atomic_load_explicit(&pool->sleeper_count, memory_order_relaxed);
+
+    while (sleeper_count > 0) {
+        if (atomic_compare_exchange_weak_explicit(&pool->sleeper_count, &sleeper_count,
+                                                  sleeper_count - 1, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            autk_semaphore_release(&pool->wake_sem);
+            return;
+        }
+    }
+}
+
+static void
+wake_all_workers(autk_thread_pool_t *pool)
+{
+    uint32_t sleeper_count;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    sleeper_count = atomic_exchange_explicit(&pool->sleeper_count, 0, memory_order_relaxed);
+
+    while (sleeper_count--) {
+        autk_semaphore_release(&pool->wake_sem);
+    }
+}
+
+// Withdraws from `sleeper_count` without sleeping. If a submitter already claimed every sleeper,
+// one of the wakeups it posted is ours, and has to be consumed to keep the semaphore's count equal
+// to the number of claimed sleepers.
+static void
+cancel_park(autk_thread_pool_t *pool)
+{
+    uint32_t sleeper_count = atomic_load_explicit(&pool->sleeper_count, memory_order_relaxed);
+
+    while (sleeper_count > 0) {
+        if (atomic_compare_exchange_weak_explicit(&pool->sleeper_count, &sleeper_count,
+                                                  sleeper_count - 1, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    while (autk_semaphore_acquire(&pool->wake_sem) == AUTK_ERR_INTERRUPTED) {
+    }
+}
+
+// Blocks until there may be work to do. Returns false if the pool is stopping and every queue has
+// been drained.
+static bool
+park_worker(autk_thread_pool_t *pool)
+{
+    atomic_fetch_add_explicit(&pool->sleeper_count, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (has_queued_tasks(pool)) {
+        cancel_park(pool);
+        return true;
+    } else if (atomic_load_explicit(&pool->stopping, memory_order_relaxed)) {
+        cancel_park(pool);
+        return false;
+    }
+
+    while (autk_semaphore_acquire(&pool->wake_sem) == AUTK_ERR_INTERRUPTED) {
+    }
+    return true;
+}
+
+//==============================================================================
+//
+// Workers
+//
+//==============================================================================
+
+static uint32_t
+next_random(autk_thread_pool_worker_t *worker)
+{
+    uint32_t x = worker->rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->rng_state = x;
+    return x;
+}
+
+static autk_task_t *
+steal_task(autk_thread_pool_worker_t *worker)
+{
+    autk_thread_pool_t *pool = worker->pool;
+    void *item;
+
+    if (pool->worker_count < 2) {
+        return NULL;
+    }
+
+    // Start from a random victim so idle workers don't all pile onto the same one.
+    for (uint32_t i = 0; i < pool->worker_count * 2; i++) {
+        autk_thread_pool_worker_t *victim = &pool->workers[next_random(worker) % pool->worker_count];
+
+        if (victim != worker && autk_work_deque_steal(&victim->deque, &item) == AUTK_OK) {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+static autk_task_t *
+find_task(autk_thread_pool_worker_t *worker)
+{
+    autk_task_t *task = autk_work_deque_take(&worker->deque);
+
+    if (!task) {
+        task = pop_injected_task(worker->pool);
+    }
+    if (!task) {
+        task = steal_task(worker);
+    }
+
+    return task;
+}
+
+static void
+worker_main(void *opaque_worker)
+{
+    autk_thread_pool_worker_t *worker = opaque_worker;
+    autk_task_t *task;
+
+#ifdef AUTK_THREAD_LOCAL
+    current_worker = worker;
+#endif
+
+    for (;;) {
+        task = find_task(worker);
+        if (task) {
+            run_task(worker->pool, task);
+        } else if (!park_worker(worker->pool)) {
+            break;
+        }
+    }
+
+#ifdef AUTK_THREAD_LOCAL
+    current_worker = NULL;
+#endif
+}
+
+//==============================================================================
+//
+// Pool
+//
+//==============================================================================
+
+// Stops and joins the first `started_count` workers, then frees the pool.
+static void
+shutdown_pool(autk_thread_pool_t *pool, uint32_t started_count)
+{
+    atomic_store_explicit(&pool->stopping, true, memory_order_relaxed);
+    wake_all_workers(pool);
+
+    for (uint32_t i = 0; i < started_count; i++) {
+        autk_thread_join(&pool->workers[i].thread);
+    }
+
+    assert(!pool->inject_head);
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        autk_work_deque_fini(&pool->workers[i].deque);
+    }
+
+    autk_semaphore_fini(&pool->wake_sem);
+    autk_mutex_fini(&pool->inject_lock);
+    autk_instance_alloc(pool->instance, pool, pool->alloc_size, 0, AUTK_MEMORY_TAG_TASK);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_thread_pool_create(autk_instance_t *instance, uint32_t worker_count,
+                        autk_thread_pool_t **out_pool)
+{
+    autk_thread_pool_t *pool;
+    size_t alloc_size = autk_align_up(sizeof(autk_thread_pool_t));
+    size_t workers_offset;
+    autk_status_t status;
+    uint32_t i;
+
+    assert(instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC);
+    assert(worker_count > 0);
+
+    AUTK_TRY(autk_add_alloc_array_region(&alloc_size, worker_count,
+                                         sizeof(autk_thread_pool_worker_t), &workers_offset));
+
+    pool = autk_instance_alloc(instance, NULL, 0, alloc_size, AUTK_MEMORY_TAG_TASK);
+    if (!pool) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *pool = (autk_thread_pool_t){
+        .instance = instance,
+        .alloc_size = alloc_size,
+        .worker_count = worker_count,
+        .workers = (autk_thread_pool_worker_t *)((char *)pool + workers_offset),
+    };
+    atomic_init(&pool->inject_count, 0);
+    atomic_init(&pool->sleeper_count, 0);
+    atomic_init(&pool->stopping, false);
+
+    status = autk_mutex_init(&pool->inject_lock);
+    if (status != AUTK_OK) {
+        autk_instance_alloc(instance, pool, alloc_size, 0, AUTK_MEMORY_TAG_TASK);
+        return status;
+    }
+
+    status = autk_semaphore_init(&pool->wake_sem, 0);
+    if (status != AUTK_OK) {
+        autk_mutex_fini(&pool->inject_lock);
+        autk_instance_alloc(instance, pool, alloc_size, 0, AUTK_MEMORY_TAG_TASK);
+        return status;
+    }
+
+    // Every deque has to exist before any worker starts looking for something to steal.
+    for (i = 0; i < worker_count; i++) {
+        pool->workers[i] = (autk_thread_pool_worker_t){
+            .pool = pool,
+            .rng_state = 0x9E3779B9u * (i + 1),
+        };
+        status = autk_work_deque_init(&pool->workers[i].deque, instance);
+        if (status != AUTK_OK) {
+            pool->worker_count = i;
+            shutdown_pool(pool, 0);
+            return status;
+        }
+    }
+
+    for (i = 0; i < worker_count; i++) {
+        status = autk_thread_create(&pool->workers[i].thread, &worker_main, &pool->workers[i]);
+        if (status != AUTK_OK) {
+            shutdown_pool(pool, i);
+            return status;
+        }
+    }
+
+    *out_pool = pool;
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_thread_pool_destroy(autk_thread_pool_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    shutdown_pool(pool, pool->worker_count);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_thread_pool_submit(autk_thread_pool_t *pool, const autk_task_params_t *params)
+{
+    autk_task_t *task = autk_instance_alloc(pool->instance, NULL, 0, sizeof(autk_task_t),
+                                            AUTK_MEMORY_TAG_TASK);
+
+    if (!task) {
+        if (params->fini) {
+            params->fini(params->ctx);
+        }
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *task = (autk_task_t){
+        .ctx = params->ctx,
+        .exec = params->exec,
+        .client = params->client,
+        .complete = params->complete,
+        .fini = params->fini,
+    };
+
+#ifdef AUTK_THREAD_LOCAL
+    // Nested tasks stay on the submitting worker's deque, where they're likely to still be warm in
+    // its cache, unless another worker runs out of work and steals them.
+    if (current_worker && current_worker->pool == pool
+        && autk_work_deque_push(&current_worker->deque, task) == AUTK_OK) {
+        wake_worker(pool);
+        return AUTK_OK;
+    }
+#endif
+
+    inject_task(pool, task);
+    wake_worker(pool);
+    return AUTK_OK;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_THREAD_POOL_H_
+#define AUTK_UTILITY_THREAD_POOL_H_
+
+#include <stdatomic.h>
+
+#include <autk/types.h>
+#include <os/types.h>
+
+#include "work_deque.h"
+
+typedef struct autk_task autk_task_t;
+typedef struct autk_thread_pool autk_thread_pool_t;
+typedef struct autk_thread_pool_worker autk_thread_pool_worker_t;
+
+struct autk_task {
+    autk_task_t *next; // injection queue link
+    void *ctx;
+    void (*exec)(void *ctx);
+    autk_client_t *client;
+    void (*complete)(void *ctx, autk_client_t *client);
+    void (*fini)(void *ctx);
+};
+
+struct autk_thread_pool_worker {
+    autk_thread_pool_t *pool;
+    autk_work_deque_t deque; // tasks submitted by this worker's own tasks
+    autk_thread_t thread;
+    uint32_t rng_state; // for picking steal victims
+};
+
+// Fixed set of worker threads. Tasks submitted from a worker go onto its own deque, where idle
+// workers can steal them; tasks submitted from any other thread go through a shared injection
+// queue. Idle workers park on a semaphore, and submitters only touch it if someone is parked.
+struct autk_thread_pool {
+    autk_instance_t *instance;
+    size_t alloc_size;
+    uint32_t worker_count;
+    autk_thread_pool_worker_t *workers;
+
+    // Injection queue
+    autk_mutex_t inject_lock;
+    autk_task_t *inject_head;
+    autk_task_t *inject_tail;
+    _Atomic size_t inject_count;
+
+    // Parking
+    _Atomic uint32_t sleeper_count; // parked workers that nobody has posted a wakeup for yet
+    _Atomic bool stopping;
+    autk_semaphore_t wake_sem;
+};
+
+// Starts `worker_count` threads. The instance's allocator must be thread-safe.
+AUTK_HIDDEN autk_status_t
+autk_thread_pool_create(autk_instance_t *instance, uint32_t worker_count,
+                        autk_thread_pool_t **out_pool);
+
+// Waits for all queued tasks to finish, then joins the workers.
+AUTK_HIDDEN void
+autk_thread_pool_destroy(autk_thread_pool_t *pool);
+
+// May be called from any thread. Copies `params` into task storage allocated from the instance. If
+// the task can't be queued, its `fini` function is called before returning.
+AUTK_HIDDEN autk_status_t
+autk_thread_pool_submit(autk_thread_pool_t *pool, const autk_task_params_t *params);
+
+#endif // AUTK_UTILITY_THREAD_POOL_H_
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <inttypes.h>
+#include <limits.h>
+
+#include <autk/diagnostics.h>
+#include <autk/instance.h>
+
+#include "timer_heap.h"
+
+#define HEAP_ARITY 4
+#define MIN_HEAP_CAPACITY 8
+
+//==============================================================================
+//
+// Heap maintenance
+//
+//==============================================================================
+
+static inline void
+place(autk_timer_heap_t *heap, size_t index, autk_timer_t *timer)
+{
+    heap->timers[index] = timer;
+    timer->heap_index = index;
+}
+
+static void
+sift_up(autk_timer_heap_t *heap, size_t index)
+{
+    autk_timer_t *timer = heap->timers[index];
+    size_t parent;
+
+    while (index > 0) {
+        parent = (index - 1) / HEAP_ARITY;
+        if (heap->timers[parent]->fire_time <= timer->fire_time) {
+            break;
+        }
+        place(heap, index, heap->timers[parent]);
+        index = parent;
+    }
+    place(heap, index, timer);
+}
+
+static void
+sift_down(autk_timer_heap_t *heap, size_t index)
+{
+    autk_timer_t *timer = heap->timers[index];
+    size_t first_child, end, min_child;
+
+    while (1) {
+        first_child = index * HEAP_ARITY + 1;
+        if (first_child >= heap->count) {
+            break;
+        }
+
+        end = first_child + HEAP_ARITY < heap->count ? first_child + HEAP_ARITY : heap->count;
+        min_child = first_child;
+        for (size_t i = first_child + 1; i < end; i++) {
+            if (heap->timers[i]->fire_time < heap->timers[min_child]->fire_time) {
+                min_child = i;
+            }
+        }
+
+        if (timer->fire_time <= heap->timers[min_child]->fire_time) {
+            break;
+        }
+        place(heap, index, heap->timers[min_child]);
+        index = min_child;
+    }
+    place(heap, index, timer);
+}
+
+static autk_status_t
+reserve(autk_timer_heap_t *heap, size_t min_capacity)
+{
+    size_t capacity;
+    autk_timer_t **timers;
+
+    if (heap->capacity >= min_capacity) {
+        return AUTK_OK;
+    }
+
+    capacity = heap->capacity ? heap->capacity : MIN_HEAP_CAPACITY;
+    while (capacity < min_capacity) {
+        if (capacity > SIZE_MAX / sizeof(autk_timer_t *) / 2) {
+            return AUTK_ERR_ARITHMETIC_OVERFLOW;
+        }
+        capacity *= 2;
+    }
+
+    timers = autk_instance_alloc(heap->instance, heap->timers,
+                                 heap->capacity * sizeof(autk_timer_t *),
+                                 capacity * sizeof(autk_timer_t *), AUTK_MEMORY_TAG_LIST);
+    if (!timers) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    heap->timers = timers;
+    heap->capacity = capacity;
+    return AUTK_OK;
+}
+
+// Inserts a timer whose slot has already been reserved.
+static void
+push(autk_timer_heap_t *heap, autk_timer_t *timer)
+{
+    place(heap, heap->count++, timer);
+    sift_up(heap, timer->heap_index);
+}
+
+static void
+remove_at(autk_timer_heap_t *heap, size_t index)
+{
+    autk_timer_t *last = heap->timers[--heap->count];
+
+    heap->timers[index]->heap_index = SIZE_MAX;
+    if (index < heap->count) {
+        place(heap, index, last);
+        sift_down(heap, index);
+        sift_up(heap, last->heap_index);
+    }
+}
+
+//==============================================================================
+//
+// Timers
+//
+//==============================================================================
+
+// Rounds the deadline up to the timer's slack, so that timers with the same slack line up.
+static void
+schedule(autk_timer_t *timer, uint64_t deadline)
+{
+    timer->deadline = deadline;
+    timer->fire_time = deadline;
+    if (timer->slack > 1 && deadline <= UINT64_MAX - timer->slack) {
+        timer->fire_time = (deadline + timer->slack - 1) / timer->slack * timer->slack;
+    }
+}
+
+static uint64_t
+add_saturate(uint64_t a, uint64_t b)
+{
+    return a <= UINT64_MAX - b ? a + b : UINT64_MAX;
+}
+
+static void
+free_timer(autk_timer_heap_t *heap, autk_timer_t *timer)
+{
+    if (timer->fini) {
+        timer->fini(timer->ctx);
+    }
+    autk_instance_alloc(heap->instance, timer, sizeof(autk_timer_t), 0, AUTK_MEMORY_TAG_LIST);
+}
+
+AUTK_HIDDEN void
+autk_timer_heap_init(autk_instance_t *instance, autk_timer_heap_t *heap)
+{
+    *heap = (autk_timer_heap_t){.instance = instance};
+    autk_timer_table_init(instance, &heap->by_id);
+}
+
+AUTK_HIDDEN void
+autk_timer_heap_fini(autk_timer_heap_t *heap)
+{
+    for (size_t i = 0; i < heap->count; i++) {
+        free_timer(heap, heap->timers[i]);
+    }
+    if (heap->timers) {
+        autk_instance_alloc(heap->instance, heap->timers, heap->capacity * sizeof(autk_timer_t *),
+                            0, AUTK_MEMORY_TAG_LIST);
+    }
+    autk_timer_table_fini(&heap->by_id);
+    *heap = (autk_timer_heap_t){0};
+}
+
+AUTK_HIDDEN autk_status_t
+autk_timer_heap_add(autk_timer_heap_t *heap, const autk_timer_params_t *params, uint64_t now,
+                    autk_timer_id_t *out_id)
+{
+    autk_timer_t *timer;
+    autk_status_t status;
+
+    // Make room for the timer in both the heap and the table before committing to anything.
+    AUTK_TRY(reserve(heap, heap->count + 1));
+
+    timer = autk_instance_alloc(heap->instance, NULL, 0, sizeof(autk_timer_t), AUTK_MEMORY_TAG_LIST);
+    if (!timer) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    *timer = (autk_timer_t){
+        .id = ++heap->last_id,
+        .interval = params->interval_ns,
+        .slack = params->slack_ns,
+        .ctx = params->ctx,
+        .exec = params->exec,
+        .fini = params->fini,
+    };
+    schedule(timer, add_saturate(now, params->delay_ns));
+
+    status = autk_timer_table_insert(&heap->by_id, timer->id, timer, NULL, NULL);
+    if (status != AUTK_OK) {
+        autk_instance_alloc(heap->instance, timer, sizeof(autk_timer_t), 0, AUTK_MEMORY_TAG_LIST);
+        return status;
+    }
+    push(heap, timer);
+
+    if (out_id) {
+        *out_id = timer->id;
+    }
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_timer_heap_cancel(autk_timer_heap_t *heap, autk_timer_id_t id)
+{
+    autk_timer_t *timer;
+
+    if (!autk_timer_table_remove(&heap->by_id, id, &timer)) {
+        return AUTK_ERR_NOT_FOUND;
+    }
+
+    // A running timer isn't in the heap. It's freed once its callback returns.
+    if (timer->heap_index == SIZE_MAX) {
+        timer->canceled = true;
+        return AUTK_OK;
+    }
+
+    remove_at(heap, timer->heap_index);
+    free_timer(heap, timer);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN int
+autk_timer_heap_timeout_ms(const autk_timer_heap_t *heap, uint64_t now)
+{
+    uint64_t fire_time;
+    uint64_t timeout_ms;
+
+    if (heap->count == 0) {
+        return -1;
+    }
+
+    fire_time = heap->timers[0]->fire_time;
+    if (fire_time <= now) {
+        return 0;
+    }
+
+    timeout_ms = (fire_time - now + 999999) / 1000000;
+    return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+
+AUTK_HIDDEN void
+autk_timer_heap_run(autk_timer_heap_t *heap, autk_client_t *client, uint64_t now)
+{
+    autk_timer_id_t last_id = heap->last_id;
+    autk_timer_t *timer;
+    uint64_t missed;
+    autk_status_t status;
+
+    while (heap->count > 0 && heap->timers[0]->fire_time <= now) {
+        // Leave timers added by callbacks for the next pass, so that a callback that keeps adding
+        // zero-delay timers can't keep us here forever.
+        timer = heap->timers[0];
+        if (timer->id > last_id) {
+            break;
+        }
+        remove_at(heap, 0);
+
+        if (timer->exec) {
+            timer->exec(timer->ctx, client, timer->id);
+        }
+
+        if (timer->canceled) {
+            free_timer(heap, timer);
+            continue;
+        } else if (timer->interval == 0) {
+            autk_timer_table_remove(&heap->by_id, timer->id, NULL);
+            free_timer(heap, timer);
+            continue;
+        }
+
+        // Skip any intervals we've already missed instead of firing repeatedly to catch up.
+        missed = now >= timer->deadline ? (now - timer->deadline) / timer->interval : 0;
+        schedule(timer, add_saturate(timer->deadline, (missed + 1) * timer->interval));
+
+        // The callback may have used up this timer's slot in the heap.
+        status = reserve(heap, heap->count + 1);
+        if (status != AUTK_OK) {
+            AUTK_ERROR(heap->instance, "Failed to reschedule timer %" PRIu64 ": %s", timer->id,
+                       autk_status_to_string(status));
+            autk_timer_table_remove(&heap->by_id, timer->id, NULL);
+            free_timer(heap, timer);
+            continue;
+        }
+        push(heap, timer);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_TIMER_HEAP_H_
+#define AUTK_UTILITY_TIMER_HEAP_H_
+
+#include <utility/hash.h>
+
+typedef struct autk_timer autk_timer_t;
+typedef struct autk_timer_heap autk_timer_heap_t;
+
+struct autk_timer {
+    autk_timer_id_t id;
+    uint64_t deadline; // when the timer is due, before rounding for slack
+    uint64_t fire_time; // `deadline` rounded up to a multiple of the slack
+    uint64_t interval;
+    uint64_t slack;
+    void *ctx;
+    void (*exec)(void *ctx, autk_client_t *client, autk_timer_id_t id);
+    void (*fini)(void *ctx);
+    size_t heap_index; // `SIZE_MAX` while the timer is running
+    bool canceled; // set if the timer is canceled while running
+};
+
+AUTK_DEFINE_HASH_TABLE(autk_timer_table, autk_timer_id_t, autk_timer_t *, autk_hash_uint64,
+                       autk_hash_uint64_eq)
+
+// 4-ary min-heap of timers ordered by fire time, plus a table for finding timers by ID. A 4-ary heap
+// is shallower than a binary one and keeps each node's children in one cache line.
+struct autk_timer_heap {
+    autk_instance_t *instance; // for allocation
+    autk_timer_t **timers;
+    size_t count;
+    size_t capacity;
+    autk_timer_table_t by_id;
+    autk_timer_id_t last_id;
+};
+
+AUTK_HIDDEN void
+autk_timer_heap_init(autk_instance_t *instance, autk_timer_heap_t *heap);
+
+// Finalizes all remaining timers.
+AUTK_HIDDEN void
+autk_timer_heap_fini(autk_timer_heap_t *heap);
+
+// Does not finalize the timer on failure. The caller is responsible for that.
+AUTK_HIDDEN autk_status_t
+autk_timer_heap_add(autk_timer_heap_t *heap, const autk_timer_params_t *params, uint64_t now,
+                    autk_timer_id_t *out_id);
+
+AUTK_HIDDEN autk_status_t
+autk_timer_heap_cancel(autk_timer_heap_t *heap, autk_timer_id_t id);
+
+// Returns the number of milliseconds until the next timer fires, rounded up, for use as a `poll()`
+// timeout. Returns -1 if there are no timers.
+AUTK_HIDDEN int
+autk_timer_heap_timeout_ms(const autk_timer_heap_t *heap, uint64_t now);
+
+// Runs every timer whose fire time has passed, and reschedules the repeating ones.
+AUTK_HIDDEN void
+autk_timer_heap_run(autk_timer_heap_t *heap, autk_client_t *client, uint64_t now);
+
+#endif // AUTK_UTILITY_TIMER_HEAP_H_
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdatomic.h>
+
+#include <autk/instance.h>
+#include <core/types.h>
+
+#include "work_deque.h"
+
+static size_t
+array_size(int64_t capacity)
+{
+    return sizeof(autk_work_deque_array_t) + (size_t)capacity * sizeof(_Atomic(void *));
+}
+
+static autk_work_deque_array_t *
+alloc_array(autk_work_deque_t *deque, int64_t capacity)
+{
+    autk_work_deque_array_t *array;
+
+    if ((uint64_t)capacity > (SIZE_MAX - sizeof(autk_work_deque_array_t)) / sizeof(void *)) {
+        return NULL;
+    }
+
+    array = autk_instance_alloc(deque->instance, NULL, 0, array_size(capacity),
+                                AUTK_MEMORY_TAG_QUEUE);
+    if (!array) {
+        return NULL;
+    }
+
+    array->prev = NULL;
+    array->capacity = capacity;
+    return array;
+}
+
+// Moves the live range into an array twice the size. The old array stays readable, since a stealer
+// that loaded it before the swap may still be about to read its top slot.
+static autk_work_deque_array_t *
+grow(autk_work_deque_t *deque, autk_work_deque_array_t *array, int64_t top, int64_t bottom)
+{
+    autk_work_deque_array_t *new_array = alloc_array(deque, array->capacity * 2);
+
+    if (!new_array) {
+        return NULL;
+    }
+
+    new_array->prev = array;
+    for (int64_t i = top; i < bottom; i++) {
+        atomic_store_explicit(&new_array->slots[i & (new_array->capacity - 1)],
+                              atomic_load_explicit(&array->slots[i & (array->capacity - 1)],
+                                                   memory_order_relaxed),
+                              memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&deque->array, new_array, memory_order_release);
+    return new_array;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_work_deque_init(autk_work_deque_t *deque, autk_instance_t *instance)
+{
+    autk_work_deque_array_t *array;
+
+    *deque = (autk_work_deque_t){.instance = instance};
+
+    array = alloc_array(deque, AUTK_WORK_DEQUE_INITIAL_CAPACITY);
+    if (!array) {
+        return AUTK_ERR_OUT_OF_MEMORY;
+    }
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void
+autk_work_deque_fini(autk_work_deque_t *deque)
+{
+    autk_work_deque_array_t *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    while (array) {
+        autk_work_deque_array_t *prev = array->prev;
+
+        autk_instance_alloc(deque->instance, array, array_size(array->capacity), 0,
+                            AUTK_MEMORY_TAG_QUEUE);
+        array = prev;
+    }
+
+    atomic_store_explicit(&deque->array, NULL, memory_order_relaxed);
+}
+
+AUTK_HIDDEN autk_status_t
+autk_work_deque_push(autk_work_deque_t *deque, void *item)
+{
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    autk_work_deque_array_t *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    assert(item);
+
+    if (bottom - top > array->capacity - 1) {
+        if (!(deque->instance->flags & AUTK_INSTANCE_CREATE_FLAG_THREAD_SAFE_ALLOC)) {
+            return AUTK_ERR_QUEUE_FULL;
+        }
+        array = grow(deque, array, top, bottom);
+        if (!array) {
+            return AUTK_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    atomic_store_explicit(&array->slots[bottom & (array->capacity - 1)], item,
+                          memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN void *
+autk_work_deque_take(autk_work_deque_t *deque)
+{
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    autk_work_deque_array_t *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    int64_t top;
+    void *item;
+
+    // Reserve the bottom slot before looking at `top`, so a concurrent stealer either sees the
+    // reservation or we see its claim.
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty.
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    item = atomic_load_explicit(&array->slots[bottom & (array->capacity - 1)],
+                                memory_order_relaxed);
+    if (top == bottom) {
+        // Last item. Race any stealers for it.
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+
+    return item;
+}
+
+AUTK_HIDDEN autk_status_t
+autk_work_deque_steal(autk_work_deque_t *deque, void **out_item)
+{
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    int64_t bottom;
+    autk_work_deque_array_t *array;
+    void *item;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (top >= bottom) {
+        return AUTK_ERR_QUEUE_EMPTY;
+    }
+
+    array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    item = atomic_load_explicit(&array->slots[top & (array->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return AUTK_ERR_TRY_AGAIN;
+    }
+
+    *out_item = item;
+    return AUTK_OK;
+}
+
+AUTK_HIDDEN bool
+autk_work_deque_is_empty(autk_work_deque_t *deque)
+{
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    return top >= bottom;
+}
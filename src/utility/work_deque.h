@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Martin Mills
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef AUTK_UTILITY_WORK_DEQUE_H_
+#define AUTK_UTILITY_WORK_DEQUE_H_
+
+#include <stdatomic.h>
+
+#include <autk/types.h>
+
+#define AUTK_WORK_DEQUE_INITIAL_CAPACITY 64
+
+typedef struct autk_work_deque autk_work_deque_t;
+typedef struct autk_work_deque_array autk_work_deque_array_t;
+
+struct autk_work_deque_array {
+    autk_work_deque_array_t *prev; // array this one replaced, kept alive for stealers
+    int64_t capacity; // always a power of two
+    _Atomic(void *) slots[];
+};
+
+// Chase-Lev work-stealing deque, following the C11 formulation by Lê et al. The owning thread
+// pushes and takes at the bottom without contention; any other thread may steal from the top.
+// Arrays outgrown by the owner are only freed by `autk_work_deque_fini`, since a stealer may still
+// be reading from one.
+struct autk_work_deque {
+    _Atomic int64_t top;
+    _Atomic int64_t bottom;
+    _Atomic(autk_work_deque_array_t *) array;
+    autk_instance_t *instance; // for allocation
+};
+
+AUTK_HIDDEN autk_status_t
+autk_work_deque_init(autk_work_deque_t *deque, autk_instance_t *instance);
+
+// Must only be called once no thread can access the deque anymore.
+AUTK_HIDDEN void
+autk_work_deque_fini(autk_work_deque_t *deque);
+
+// Must only be called by the owning thread. `item` must not be `NULL`. Grows the deque if it's full,
+// which requires the instance's allocator to be thread-safe.
+AUTK_HIDDEN autk_status_t
+autk_work_deque_push(autk_work_deque_t *deque, void *item);
+
+// Must only be called by the owning thread. Returns the most recently pushed item, or `NULL` if the
+// deque is empty.
+AUTK_HIDDEN void *
+autk_work_deque_take(autk_work_deque_t *deque);
+
+// May be called from any thread. Returns `AUTK_ERR_QUEUE_EMPTY` if there is nothing to steal, or
+// `AUTK_ERR_TRY_AGAIN` if another thread claimed the oldest item first.
+AUTK_HIDDEN autk_status_t
+autk_work_deque_steal(autk_work_deque_t *deque, void **out_item);
+
+// May be called from any thread. The result is only a snapshot.
+AUTK_HIDDEN bool
+autk_work_deque_is_empty(autk_work_deque_t *deque);
+
+#endif // AUTK_UTILITY_WORK_DEQUE_H_